@@ -1,7 +1,25 @@
+#include "..\TerminalSynth\AudioBlock.h"
+#include "..\TerminalSynth\BiQuadFilter.h"
+#include "..\TerminalSynth\ButterworthFilter.h"
+#include "..\TerminalSynth\CombFilter.h"
+#include "..\TerminalSynth\Constant.h"
+#include "..\TerminalSynth\DenormalGuard.h"
+#include "..\TerminalSynth\FFTPlan.h"
 #include "..\TerminalSynth\Matrix.h"
+#include "..\TerminalSynth\PlaybackInfo.h"
+#include "..\TerminalSynth\PlaybackTime.h"
+#include "..\TerminalSynth\SignalBase.h"
+#include "..\TerminalSynth\SilenceDetector.h"
+#include "..\TerminalSynth\SoundSettings.h"
+#include "..\TerminalSynth\SynthVoiceBank.h"
+#include "..\TerminalSynth\SynthVoicePrimitive.h"
+#include <chrono>
+#include <cmath>
 #include <functional>
 #include <iostream>
+#include <numbers>
 #include <string>
+#include <vector>
 
 void Output(const char* message, bool endline)
 {
@@ -98,4 +116,395 @@ int main()
     });
 
     Output(matrix1);
-}
\ No newline at end of file
+
+    const int fftSize = 1024;
+
+    FFTPlan fftPlan(fftSize);
+
+    float fftInput[fftSize];
+    float fftOutput[fftSize];
+    float fftReal[(fftSize / 2) + 1];
+    float fftImaginary[(fftSize / 2) + 1];
+
+    Test("FFTPlan: Forward (cosine bin)", [&]() {
+
+        const int bin = 37;
+
+        for (int index = 0; index < fftSize; index++)
+            fftInput[index] = std::cos((2.0 * std::numbers::pi * bin * index) / fftSize);
+
+        fftPlan.Forward(fftInput, fftReal, fftImaginary);
+
+        // Peak of N / 2 at the bin; and (near) zero elsewhere
+        for (int index = 0; index < fftPlan.GetBinCount(); index++)
+        {
+            float magnitude = std::sqrt((fftReal[index] * fftReal[index]) + (fftImaginary[index] * fftImaginary[index]));
+            float expected = index == bin ? (fftSize / 2.0f) : 0.0f;
+
+            if (std::fabs(magnitude - expected) > 1e-2)
+                return false;
+        }
+
+        return true;
+    });
+
+    Test("FFTPlan: Inverse (round trip)", [&]() {
+
+        for (int index = 0; index < fftSize; index++)
+            fftInput[index] = std::sin(0.1 * index) + (0.5 * std::cos(0.37 * index));
+
+        fftPlan.Forward(fftInput, fftReal, fftImaginary);
+        fftPlan.Inverse(fftReal, fftImaginary, fftOutput);
+
+        for (int index = 0; index < fftSize; index++)
+        {
+            if (std::fabs(fftOutput[index] - fftInput[index]) > 1e-5)
+                return false;
+        }
+
+        return true;
+    });
+
+    // Silent tail:  A (two pole) resonator ringing out in the subnormal range. Returns the cost per sample (ns).
+    auto ringOut = [](float& state1, float& state2, float flushThreshold) {
+
+        const int sampleCount = 1000000;
+
+        volatile float sink = 0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (int index = 0; index < sampleCount; index++)
+        {
+            float output = (1.99998f * state1) - (0.99999f * state2);
+
+            if (std::fabs(output) < flushThreshold)
+                output = 0;
+
+            state2 = state1;
+            state1 = output;
+            sink = output;
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / sampleCount;
+    };
+
+    double unguardedCost = 0;
+    double guardedCost = 0;
+
+    Test("DenormalGuard: Silent tail (FTZ / DAZ)", [&]() {
+
+        float state1 = 1e-39f;
+        float state2 = 1e-39f;
+
+        unguardedCost = ringOut(state1, state2, 0);
+
+        bool subnormal = state1 != 0 && std::fabs(state1) < 1.17549435e-38f;
+
+        state1 = 1e-39f;
+        state2 = 1e-39f;
+
+        {
+            DenormalGuard guard;
+
+            guardedCost = ringOut(state1, state2, 0);
+        }
+
+        // (The tail stays subnormal without the guard; and is flushed, and cheaper, with it)
+        return subnormal && state1 == 0 && guardedCost < unguardedCost;
+    });
+
+    PlaybackInfo playbackInfo(false, false);
+    playbackInfo.SetForOutputDevice(AudioStreamFormat::Float32, 2, 48000, 0.01f);
+
+    const int ringFrameCount = 48000;
+
+    // Filter tail:  Rings the filter with an impulse (without a DenormalGuard), recording the (left) output. Returns false
+    //               if any output sample is subnormal.
+    auto ringFilter = [&](SignalBase* filter, std::vector<float>& output) {
+
+        AudioBlock block(AUDIO_BLOCK_SIZE, 48000.0f);
+        PlaybackTime playbackTime;
+        playbackTime.frameCursor = 0;
+
+        output.clear();
+
+        for (int blockOffset = 0; blockOffset < ringFrameCount; blockOffset += AUDIO_BLOCK_SIZE)
+        {
+            block.Clear(AUDIO_BLOCK_SIZE);
+
+            if (blockOffset == 0)
+                block.SetFrame(0, 1.0f, 1.0f);
+
+            filter->ProcessBlock(&block, &playbackTime, AUDIO_BLOCK_SIZE);
+
+            for (int index = 0; index < AUDIO_BLOCK_SIZE; index++)
+            {
+                if (std::fpclassify(block.GetLeft()[index]) == FP_SUBNORMAL ||
+                    std::fpclassify(block.GetRight()[index]) == FP_SUBNORMAL)
+                    return false;
+
+                output.push_back(block.GetLeft()[index]);
+            }
+
+            playbackTime.Advance(AUDIO_BLOCK_SIZE, 48000.0f);
+        }
+
+        return true;
+    };
+
+    // Filter tail:  The output must ring, and then reach exact zero (for longer than the filter's state). The state is
+    //               checked through the output:  A second impulse must ring exactly as the first (from a zero state).
+    auto settlesToZero = [&](SignalBase* filter, int stateFrameCount) {
+
+        std::vector<float> first;
+        std::vector<float> second;
+
+        if (!ringFilter(filter, first) || !ringFilter(filter, second))
+            return false;
+
+        if (first[0] == 0)
+            return false;
+
+        for (int index = ringFrameCount - stateFrameCount; index < ringFrameCount; index++)
+        {
+            if (first[index] != 0)
+                return false;
+        }
+
+        return first == second;
+    };
+
+    Test("DenormalGuard: Silent tail (BiQuad)", [&]() {
+
+        BiQuadFilter filter(BiQuadFilter::FilterType::LPF, 48000, 1000.0f, 0.9f);
+        filter.SignalParameterizedBase::Initialize(&playbackInfo);
+        filter.Initialize(&playbackInfo);
+
+        // Output history (2 frames)
+        return settlesToZero(&filter, 2);
+    });
+
+    Test("DenormalGuard: Silent tail (Butterworth)", [&]() {
+
+        ButterworthFilter filter(48000, 1.0f);
+        filter.SignalParameterizedBase::Initialize(&playbackInfo);
+        filter.Initialize(&playbackInfo);
+        filter.SetFilter(1000.0f, 0.9f);
+
+        // Stage histories (2 x 2 frames)
+        return settlesToZero(&filter, 4);
+    });
+
+    Test("DenormalGuard: Silent tail (Comb feedback)", [&]() {
+
+        CombFilter filter(0.01f, 0.5f, true);
+        filter.SignalParameterizedBase::Initialize(&playbackInfo);
+        filter.Initialize(&playbackInfo);
+
+        // Delay line (480 frames)
+        return settlesToZero(&filter, 480);
+    });
+
+    Test("DenormalGuard: Restores state", [&]() {
+
+        {
+            DenormalGuard guard;
+        }
+
+        volatile float smallest = 1.17549435e-38f;
+
+        return (smallest / 2.0f) != 0;
+    });
+
+    Test("SilenceDetector: Sleeps after hold", [&]() {
+
+        // -60dB threshold, 100 frames hold (at 1000Hz)
+        SilenceDetector detector;
+        detector.Configure(-60.0f, 0.1f, 1000.0f);
+
+        float left[50] = { 0 };
+        float right[50] = { 0 };
+
+        right[10] = 0.0009f;
+
+        // Below the threshold
+        if (!detector.IsSilent(SilenceDetector::GetPeak(left, right, 50)))
+            return false;
+
+        detector.Update(true, 50);
+
+        if (detector.IsAsleep())
+            return false;
+
+        detector.Update(true, 50);
+
+        return detector.IsAsleep();
+    });
+
+    Test("SilenceDetector: Wakes on input", [&]() {
+
+        SilenceDetector detector;
+        detector.Configure(-60.0f, 0.1f, 1000.0f);
+
+        float left[50] = { 0 };
+        float right[50] = { 0 };
+
+        detector.Update(true, 100);
+
+        if (!detector.IsAsleep())
+            return false;
+
+        left[49] = -0.0011f;
+
+        detector.Update(detector.IsSilent(SilenceDetector::GetPeak(left, right, 50)), 50);
+
+        return !detector.IsAsleep();
+    });
+
+    Test("AudioBlock: Mono mix, and widen", [&]() {
+
+        AudioBlock mono(4, 1000.0f);
+        AudioBlock stereo(4, 1000.0f);
+        AudioBlock output(4, 1000.0f);
+
+        mono.SetMono(true);
+
+        for (int index = 0; index < 4; index++)
+        {
+            mono.SetFrame(index, 0.25f * index, 99.0f);         // (Right channel is not kept)
+            stereo.SetFrame(index, 0.5f, -0.5f);
+        }
+
+        // Mono source -> Both channels
+        output.AddBlock(&mono, 4);
+
+        if (output.IsMono() || output.GetRight()[3] != 0.75f)
+            return false;
+
+        // Stereo source -> Widens the mono block
+        mono.AddBlock(&stereo, 4);
+
+        return !mono.IsMono() && mono.GetLeft()[2] == 1.0f && mono.GetRight()[2] == 0.0f;
+    });
+
+    Test("SynthVoiceBank: Lane matches the voice", [&]() {
+
+        PrimitiveSynthVoices waveforms[4] = 
+        { 
+            PrimitiveSynthVoices::Sine, 
+            PrimitiveSynthVoices::Square, 
+            PrimitiveSynthVoices::Triangle, 
+            PrimitiveSynthVoices::Sawtooth 
+        };
+
+        for (int index = 0; index < 4; index++)
+        {
+            // (Asymmetric signal range)
+            SoundSettings settings;
+            settings.GetOscillatorParameters()->SetSignalHigh(0.8f);
+            settings.GetOscillatorParameters()->SetSignalLow(-0.2f);
+
+            // (No insert effects; so there is no SoundRegistry*)
+            SynthVoicePrimitive voice(nullptr, &settings, &playbackInfo, waveforms[index]);
+            SynthVoicePrimitive laneVoice(nullptr, &settings, &playbackInfo, waveforms[index]);
+            SynthVoiceBank bank;
+
+            AudioBlock voiceBlock(AUDIO_BLOCK_SIZE, 48000.0f);
+            AudioBlock bankBlock(AUDIO_BLOCK_SIZE, 48000.0f);
+
+            PlaybackTime playbackTime;
+            playbackTime.frameCursor = 0;
+            playbackTime.streamTime = 0;
+
+            voice.NoteOn(69, &playbackTime);
+            laneVoice.NoteOn(69, &playbackTime);
+
+            // Attack, and decay (~0.4s)
+            for (int block = 0; block < 40; block++)
+            {
+                voiceBlock.Clear(AUDIO_BLOCK_SIZE);
+                bankBlock.Clear(AUDIO_BLOCK_SIZE);
+
+                voice.ProcessBlock(&voiceBlock, &playbackTime, AUDIO_BLOCK_SIZE);
+
+                bank.Clear();
+
+                if (!laneVoice.AddToBank(&bank, &playbackTime))
+                    return false;
+
+                bank.Render(&bankBlock, &playbackTime, AUDIO_BLOCK_SIZE);
+
+                for (int frame = 0; frame < AUDIO_BLOCK_SIZE; frame++)
+                {
+                    if (std::fabs(voiceBlock.GetLeft()[frame] - bankBlock.GetLeft()[frame]) > 1e-4)
+                        return false;
+                }
+
+                playbackTime.Advance(AUDIO_BLOCK_SIZE, 48000.0f);
+            }
+        }
+
+        return true;
+    });
+
+    Test("SynthVoiceBank: Released lane ends after the silent hold", [&]() {
+
+        // (-100dB signal; so the release is silent, and ends after the hold - not at the end of the envelope)
+        SoundSettings settings;
+        settings.GetOscillatorParameters()->SetSignalHigh(1e-5f);
+        settings.GetOscillatorParameters()->SetSignalLow(-1e-5f);
+        settings.GetOscillatorEnvelope()->SetRelease(2.0);
+
+        SynthVoicePrimitive voice(nullptr, &settings, &playbackInfo, PrimitiveSynthVoices::Sine);
+        SynthVoicePrimitive laneVoice(nullptr, &settings, &playbackInfo, PrimitiveSynthVoices::Sine);
+        SynthVoiceBank bank;
+
+        AudioBlock voiceBlock(AUDIO_BLOCK_SIZE, 48000.0f);
+        AudioBlock bankBlock(AUDIO_BLOCK_SIZE, 48000.0f);
+
+        PlaybackTime playbackTime;
+        playbackTime.frameCursor = 0;
+        playbackTime.streamTime = 0;
+
+        voice.NoteOn(69, &playbackTime);
+        laneVoice.NoteOn(69, &playbackTime);
+
+        int voiceEnd = -1;
+        int laneEnd = -1;
+
+        for (int block = 0; block < 100; block++)
+        {
+            if (block == 10)
+            {
+                voice.NoteOff(69, &playbackTime);
+                laneVoice.NoteOff(69, &playbackTime);
+            }
+
+            voiceBlock.Clear(AUDIO_BLOCK_SIZE);
+            bankBlock.Clear(AUDIO_BLOCK_SIZE);
+
+            voice.ProcessBlock(&voiceBlock, &playbackTime, AUDIO_BLOCK_SIZE);
+
+            bank.Clear();
+            laneVoice.AddToBank(&bank, &playbackTime);
+            bank.Render(&bankBlock, &playbackTime, AUDIO_BLOCK_SIZE);
+
+            playbackTime.Advance(AUDIO_BLOCK_SIZE, 48000.0f);
+
+            if (voiceEnd < 0 && !voice.HasOutput(&playbackTime))
+                voiceEnd = block;
+
+            if (laneEnd < 0 && !laneVoice.HasOutput(&playbackTime))
+                laneEnd = block;
+        }
+
+        // (The release lasts ~190 blocks)
+        return voiceEnd > 10 && voiceEnd < 20 && laneEnd == voiceEnd;
+    });
+
+    Output("Silent tail (ns / sample):  Unguarded " + std::to_string(unguardedCost) + 
+           ", FTZ / DAZ " + std::to_string(guardedCost), true);
+}
@@ -1,4 +1,7 @@
 #include "AirwindowsEffect.h"
+#include "AirwindowsSparePool.h"
+#include "AudioBlock.h"
+#include "Constant.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -7,35 +10,42 @@
 #include "SignalSettings.h"
 #include <airwin_consolidated_base.h>
 
-AirwindowsEffect::AirwindowsEffect(const SignalSettings& settings, AudioEffectX* plugin) : SignalParameterizedBase(settings)
-{
-	//_effect = new kCathedral(0);
-	_input = new float* [2];
-	_output = new float* [2];
-
-	// One sample per channel
-	_input[0] = new float[1];			// Left
-	_input[1] = new float[1];			// Right
-
-	_output[0] = new float[1];			// Left (output)
-	_output[1] = new float[1];			// Right (output)
+// Channel buffers (one block per channel):  The effects are processed one at a time on each render thread; so the
+// buffers are shared by every instance, instead of being held per effect (per voice).
+static thread_local float AirwindowsInputLeft[AUDIO_BLOCK_SIZE];
+static thread_local float AirwindowsInputRight[AUDIO_BLOCK_SIZE];
+static thread_local float AirwindowsOutputLeft[AUDIO_BLOCK_SIZE];
+static thread_local float AirwindowsOutputRight[AUDIO_BLOCK_SIZE];
 
+AirwindowsEffect::AirwindowsEffect(const SignalSettings& settings, AudioEffectX* plugin, AirwindowsSparePool* sparePool) : SignalParameterizedBase(settings)
+{
 	_effect = plugin;
+	_sparePool = sparePool;
 }
 
 AirwindowsEffect::~AirwindowsEffect()
 {
 	// MEMORY! (see SoundRegistry) (these effect instances are not managed by the registry)
 	delete _effect;
+}
+
+void AirwindowsEffect::Clear()
+{
+	int slot = 0;
+
+	AudioEffectX* spare = _sparePool->Take(slot);
+
+	if (spare == nullptr)
+		return;
 
-	delete[] _input[0];
-	delete[] _input[1];
-	delete[] _input;
+	// The fresh instance starts from the plugin defaults
+	for (int index = 0; index < GetParameterCount(); index++)
+		spare->setParameter(index, GetParameterValue(index));
 
-	delete[] _output[0];
-	delete[] _output[1];
-	delete[] _output;
+	_sparePool->Retire(slot, _effect);
+	_effect = spare;
 }
+
 void AirwindowsEffect::Initialize(const PlaybackInfo* parameters)
 {
 	SignalBase::Initialize(parameters);
@@ -57,19 +67,42 @@ void AirwindowsEffect::SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* pl
 	//					   he wanted.. But, I hope I've applied the effect properly!
 	// 
 	//					   Finally, the audio is non-interleved. So, you'll have to know to parse your signal 
-	//					   before calling his plugin. We're going to spool off samples one-by-one, with a pre-allocated
-	//					   single-sample buffer.
+	//					   before calling his plugin. This is the single sample (fallback) path, using the first frame
+	//					   of the shared block buffers. (see ProcessBlockImpl)
 	// 
 	//					   Let's see how it sounds!
 	//
 
-	_input[0][0] = frame->GetLeft();
-	_input[1][0] = frame->GetRight();
+	float* input[2] = { AirwindowsInputLeft, AirwindowsInputRight };
+	float* output[2] = { AirwindowsOutputLeft, AirwindowsOutputRight };
+
+	input[0][0] = frame->GetLeft();
+	input[1][0] = frame->GetRight();
 
-	_effect->processReplacing(_input, _output, 1);
+	_effect->processReplacing(input, output, 1);
 
 	// Need mixing parameter
-	frame->SetFrame(_output[0][0], _output[1][0]);
+	frame->SetFrame(output[0][0], output[1][0]);
+}
+
+void AirwindowsEffect::ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+{
+	// The plugin's per-call setup (scaling, gain curves, etc...) runs once per (sub) block. The block's own
+	// channel buffers are used as the dry input, since the plugin writes only to the output buffers.
+	//
+	float* input[2] = { block->GetLeft(), block->GetRight() };
+	float* output[2] = { AirwindowsOutputLeft, AirwindowsOutputRight };
+
+	_effect->processReplacing(input, output, frameCount);
+
+	float* left = block->GetLeft();
+	float* right = block->GetRight();
+
+	for (int index = 0; index < frameCount; index++)
+	{
+		left[index] = output[0][index];
+		right[index] = output[1][index];
+	}
 }
 
 bool AirwindowsEffect::HasOutput(const PlaybackTime* playbackTime) const
@@ -3,6 +3,8 @@
 #ifndef AIRWINDOWS_EFFECT_H
 #define AIRWINDOWS_EFFECT_H
 
+#include "AirwindowsSparePool.h"
+#include "AudioBlock.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -12,13 +14,22 @@
 
 /// <summary>
 /// Airwindows Effect Wrapper:  This will hold a plugin from the airwindows-plugins project. Each plugin will follow the
-/// FilterBase initialization path; and has already been properly loaded by the application.
+/// FilterBase initialization path; and has already been properly loaded by the application. The instance holds only
+/// the plugin (its own state); the channel buffers used to call the plugin are shared by every instance on the render
+/// thread (see AirwindowsEffect.cpp).
+/// 
+/// Mono blocks are widened before the effect (it is not IsMonoCapable):  The plugin interface processes both channels
+/// in every call, even for plugins that keep them independent (AirwinRegistryEntry::IsMono); so there is nothing to
+/// save by keeping the block mono.
 /// </summary>
 class AirwindowsEffect : public SignalParameterizedBase
 {
 public:
 
-	AirwindowsEffect(const SignalSettings& settings, AudioEffectX* plugin);
+	/// <summary>
+	/// Wraps the plugin. The spare pool (owned by the SoundRegistry*) is used to reset the plugin (see Clear).
+	/// </summary>
+	AirwindowsEffect(const SignalSettings& settings, AudioEffectX* plugin, AirwindowsSparePool* sparePool);
 	~AirwindowsEffect();
 
 	void Initialize(const PlaybackInfo* outputSettings) override;	
@@ -26,16 +37,24 @@ public:
 
 	void UpdateParameter(int index, float value) override;
 
+	/// <summary>
+	/// Resets the plugin state (its tail), by swapping in a spare instance (see AirwindowsSparePool) with the current
+	/// parameters. Nothing is allocated:  The replaced instance is deleted off the audio thread. If the pool has no
+	/// spare left (until it is refreshed), the plugin state is kept.
+	/// </summary>
+	void Clear() override;
+
 protected:
 
 	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) override;
+	void ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount) override;
 
 private:
 
 	AudioEffectX* _effect;
 
-	float** _input;
-	float** _output;
+	// Reset (see Clear) (DO NOT DELETE! Owned by the SoundRegistry*)
+	AirwindowsSparePool* _sparePool;
 };
 
 #endif
\ No newline at end of file
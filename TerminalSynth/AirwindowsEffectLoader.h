@@ -15,6 +15,16 @@ class AirwindowsEffectLoader
 public:
 
 	static void LoadSettings(AirwinRegistryEntry* registryEntry, AudioEffectX* plugin, SignalSettings& destination);
+
+	/// <summary>
+	/// Loads settings from the (cached) manifest settings, without creating the plugin
+	/// </summary>
+	static void LoadSettings(AirwinRegistryEntry* registryEntry, const SignalSettings* manifestSettings, SignalSettings& destination);
+
+	/// <summary>
+	/// Returns the number of parameters loaded for the registry entry
+	/// </summary>
+	static int GetParameterCount(AirwinRegistryEntry* registryEntry);
 };
 
 void AirwindowsEffectLoader::LoadSettings(AirwinRegistryEntry* registryEntry, AudioEffectX* plugin, SignalSettings& destination)
@@ -27,7 +37,7 @@ void AirwindowsEffectLoader::LoadSettings(AirwinRegistryEntry* registryEntry, Au
 
 	// Set Parameters
 	//
-	for (int index = 0; index < registryEntry->GetNumberOfParams() - 1; index++)
+	for (int index = 0; index < GetParameterCount(registryEntry); index++)
 	{
 		char paramName[100];
 		plugin->getParameterName(index, paramName);
@@ -47,4 +57,26 @@ void AirwindowsEffectLoader::LoadSettings(AirwinRegistryEntry* registryEntry, Au
 	}
 }
 
+void AirwindowsEffectLoader::LoadSettings(AirwinRegistryEntry* registryEntry, const SignalSettings* manifestSettings, SignalSettings& destination)
+{
+	// Initialize
+	destination.SetName(registryEntry->GetName());
+	destination.SetCategory(registryEntry->GetCategory());
+	destination.SetInfoText(registryEntry->GetWhatText());
+	destination.SetIsEnabled(true);
+
+	// Set Parameters
+	for (int index = 0; index < manifestSettings->GetParameterCount(); index++)
+	{
+		SignalParameter parameter(manifestSettings->GetParameterName(index), manifestSettings->GetParameterValue(index), 0.0f, 1.0f);
+		destination.AddParameter(parameter);
+	}
+}
+
+int AirwindowsEffectLoader::GetParameterCount(AirwinRegistryEntry* registryEntry)
+{
+	// (The last parameter is not loaded)
+	return registryEntry->GetNumberOfParams() > 0 ? registryEntry->GetNumberOfParams() - 1 : 0;
+}
+
 #endif
\ No newline at end of file
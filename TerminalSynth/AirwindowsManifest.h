@@ -0,0 +1,205 @@
+#pragma once
+
+#ifndef AIRWINDOWS_MANIFEST_H
+#define AIRWINDOWS_MANIFEST_H
+
+#include "SignalParameter.h"
+#include "SignalSettings.h"
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+
+/// <summary>
+/// On-disk cache of the Airwindows plugin metadata (name, category, parameter names, and default values). This
+/// allows the SoundRegistry* to create SignalSettings for each plugin without constructing the plugin itself.
+/// </summary>
+class AirwindowsManifest
+{
+public:
+
+	// Header (and version) of the manifest file. Changing the format requires a new version.
+	const char* MANIFEST_HEADER = "terminal-synth-airwin-manifest 1";
+
+public:
+
+	AirwindowsManifest();
+	~AirwindowsManifest();
+
+	/// <summary>
+	/// Loads the manifest from file. Returns false if the file was missing, or invalid - leaving the
+	/// manifest empty.
+	/// </summary>
+	bool Load(const std::string& fileName);
+
+	/// <summary>
+	/// Saves the manifest to file, overwriting the existing file.
+	/// </summary>
+	bool Save(const std::string& fileName) const;
+
+	/// <summary>
+	/// Returns true if the manifest has an entry for the plugin, with the expected number of parameters
+	/// </summary>
+	bool Contains(const std::string& name, int parameterCount) const;
+
+	/// <summary>
+	/// Gets the settings for the plugin (DO NOT DELETE!)
+	/// </summary>
+	const SignalSettings* Get(const std::string& name) const;
+
+	/// <summary>
+	/// Sets (or replaces) the entry for the plugin from the loaded settings
+	/// </summary>
+	void Set(const SignalSettings& settings);
+
+private:
+
+	void Clear();
+
+private:
+
+	std::map<std::string, SignalSettings*>* _entries;
+};
+
+AirwindowsManifest::AirwindowsManifest()
+{
+	_entries = new std::map<std::string, SignalSettings*>();
+}
+
+AirwindowsManifest::~AirwindowsManifest()
+{
+	Clear();
+
+	delete _entries;
+}
+
+void AirwindowsManifest::Clear()
+{
+	for (auto iter = _entries->begin(); iter != _entries->end(); ++iter)
+	{
+		// MEMORY! ~SignalSettings
+		delete iter->second;
+	}
+
+	_entries->clear();
+}
+
+bool AirwindowsManifest::Load(const std::string& fileName)
+{
+	Clear();
+
+	if (!std::filesystem::exists(fileName))
+		return false;
+
+	std::ifstream stream(fileName);
+	std::string line;
+
+	// Header
+	if (!std::getline(stream, line) || line != MANIFEST_HEADER)
+		return false;
+
+	try
+	{
+		// Entry:  name, category, parameter count, (parameter name, default value) x parameter count
+		//
+		std::string name;
+
+		while (std::getline(stream, name))
+		{
+			std::string category;
+			std::string parameterCount;
+
+			if (!std::getline(stream, category) || !std::getline(stream, parameterCount))
+				throw new std::exception("Manifest entry is incomplete:  AirwindowsManifest.h");
+
+			// MEMORY! ~AirwindowsManifest
+			SignalSettings* settings = new SignalSettings();
+
+			settings->SetName(name);
+			settings->SetCategory(category);
+
+			_entries->insert(std::make_pair(name, settings));
+
+			int count = std::stoi(parameterCount);
+
+			for (int index = 0; index < count; index++)
+			{
+				std::string parameterName;
+				std::string parameterValue;
+
+				if (!std::getline(stream, parameterName) || !std::getline(stream, parameterValue))
+					throw new std::exception("Manifest parameter is incomplete:  AirwindowsManifest.h");
+
+				settings->AddParameter(SignalParameter(parameterName, std::stof(parameterValue), 0.0f, 1.0f));
+			}
+		}
+	}
+	catch (...)
+	{
+		// Invalid manifest:  The registry will rebuild it from the plugins
+		Clear();
+
+		return false;
+	}
+
+	return true;
+}
+
+bool AirwindowsManifest::Save(const std::string& fileName) const
+{
+	std::ofstream stream(fileName, std::ios::trunc);
+
+	if (!stream.is_open())
+		return false;
+
+	stream << MANIFEST_HEADER << '\n';
+
+	for (auto iter = _entries->begin(); iter != _entries->end(); ++iter)
+	{
+		stream << iter->second->GetName() << '\n';
+		stream << iter->second->GetCategory() << '\n';
+		stream << iter->second->GetParameterCount() << '\n';
+
+		for (int index = 0; index < iter->second->GetParameterCount(); index++)
+		{
+			stream << iter->second->GetParameterName(index) << '\n';
+			stream << iter->second->GetParameterValue(index) << '\n';
+		}
+	}
+
+	stream.flush();
+	stream.close();
+
+	return true;
+}
+
+bool AirwindowsManifest::Contains(const std::string& name, int parameterCount) const
+{
+	return _entries->contains(name) && _entries->at(name)->GetParameterCount() == parameterCount;
+}
+
+const SignalSettings* AirwindowsManifest::Get(const std::string& name) const
+{
+	if (!_entries->contains(name))
+		throw new std::exception("Plugin not found in manifest:  AirwindowsManifest.h");
+
+	return _entries->at(name);
+}
+
+void AirwindowsManifest::Set(const SignalSettings& settings)
+{
+	if (_entries->contains(settings.GetName()))
+	{
+		// MEMORY! ~SignalSettings
+		delete _entries->at(settings.GetName());
+
+		_entries->erase(settings.GetName());
+	}
+
+	// MEMORY! ~AirwindowsManifest
+	_entries->insert(std::make_pair(settings.GetName(), new SignalSettings(settings)));
+}
+
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#ifndef AIRWINDOWS_SPARE_POOL_H
+#define AIRWINDOWS_SPARE_POOL_H
+
+#include "Constant.h"
+#include <AirwinRegistryEntry.h>
+#include <airwin_consolidated_base.h>
+#include <atomic>
+
+/// <summary>
+/// Fresh (unused) instances of one Airwindows plugin, which are handed out to reset an effect (the plugin API has no
+/// reset; see AirwindowsEffect::Clear). The pool is owned by the SoundRegistry*, and is filled when the plugin is first
+/// checked out. Each slot holds either a spare, or the instance that it replaced; so the pool never holds more than
+/// AIRWINDOWS_SPARE_COUNT instances. The replaced instances are deleted, and the slots re-filled, off the audio thread
+/// (see Refresh).
+/// </summary>
+class AirwindowsSparePool
+{
+public:
+
+	AirwindowsSparePool(const AirwinRegistryEntry* entry, float samplingRate)
+	{
+		_entry = entry;
+		_samplingRate = samplingRate;
+		_isActive = false;
+		_used.store(false);
+
+		for (int index = 0; index < AIRWINDOWS_SPARE_COUNT; index++)
+		{
+			_spares[index].store(nullptr);
+			_retired[index].store(nullptr);
+		}
+	}
+	~AirwindowsSparePool()
+	{
+		for (int index = 0; index < AIRWINDOWS_SPARE_COUNT; index++)
+		{
+			if (_spares[index].load() != nullptr)
+				delete _spares[index].load();
+
+			if (_retired[index].load() != nullptr)
+				delete _retired[index].load();
+		}
+	}
+
+	AirwindowsSparePool(const AirwindowsSparePool& copy) = delete;
+	AirwindowsSparePool& operator=(const AirwindowsSparePool& copy) = delete;
+
+	bool IsActive() const { return _isActive; }
+
+	/// <summary>
+	/// (Off the audio thread) Creates the spare instances (see SoundRegistry::Checkout)
+	/// </summary>
+	void Activate()
+	{
+		if (_isActive)
+			return;
+
+		for (int index = 0; index < AIRWINDOWS_SPARE_COUNT; index++)
+		{
+			// MEMORY! ~AirwindowsSparePool (or handed to an effect; see Take)
+			_spares[index].store(_entry->CreateEffect(_samplingRate), std::memory_order_release);
+		}
+
+		_isActive = true;
+	}
+
+	/// <summary>
+	/// Takes a spare instance; or returns nullptr if they are all in use. The slot must be given back the replaced
+	/// instance (see Retire). This does not allocate.
+	/// </summary>
+	AudioEffectX* Take(int& slot)
+	{
+		for (int index = 0; index < AIRWINDOWS_SPARE_COUNT; index++)
+		{
+			AudioEffectX* spare = _spares[index].exchange(nullptr, std::memory_order_acq_rel);
+
+			if (spare != nullptr)
+			{
+				slot = index;
+				return spare;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/// <summary>
+	/// Gives the slot the instance that its spare replaced (to be deleted; see Refresh). This does not allocate.
+	/// </summary>
+	void Retire(int slot, AudioEffectX* effect)
+	{
+		_retired[slot].store(effect, std::memory_order_release);
+		_used.store(true, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// (Off the audio thread) Deletes the retired instances, and re-fills their slots. Nothing is done unless a spare
+	/// was taken since the last refresh.
+	/// </summary>
+	void Refresh()
+	{
+		if (!_used.exchange(false, std::memory_order_acq_rel))
+			return;
+
+		for (int index = 0; index < AIRWINDOWS_SPARE_COUNT; index++)
+		{
+			AudioEffectX* retired = _retired[index].exchange(nullptr, std::memory_order_acq_rel);
+
+			if (retired == nullptr)
+				continue;
+
+			delete retired;
+
+			// MEMORY! ~AirwindowsSparePool (or handed to an effect; see Take)
+			_spares[index].store(_entry->CreateEffect(_samplingRate), std::memory_order_release);
+		}
+	}
+
+private:
+
+	const AirwinRegistryEntry* _entry;
+	float _samplingRate;
+	bool _isActive;
+
+	// Slots:  A spare is taken, and then replaced with the retired instance (the slot is re-filled by Refresh)
+	std::atomic<AudioEffectX*> _spares[AIRWINDOWS_SPARE_COUNT];
+	std::atomic<AudioEffectX*> _retired[AIRWINDOWS_SPARE_COUNT];
+
+	// A spare was taken since the last refresh
+	std::atomic<bool> _used;
+};
+
+#endif
@@ -0,0 +1,217 @@
+#pragma once
+
+#ifndef AUDIO_BLOCK_H
+#define AUDIO_BLOCK_H
+
+#include "PlaybackFrame.h"
+#include <exception>
+
+/// <summary>
+/// Planar (L/R) buffer of frames used for block processing. The block either owns its buffers, or
+/// it is a view into a parent block's buffers - which is used to process sub-blocks without any
+/// allocation on the audio thread.
+///
+/// Mono:  The block carries the channel count of its connection. A mono block holds its signal in the left
+/// channel only (the right channel is not kept); and it is widened to stereo by the first node that needs
+/// both channels (see Widen, and SignalChain::ProcessBlock).
+/// </summary>
+class AudioBlock
+{
+public:
+
+	/// <summary>
+	/// Creates a block, which owns its channel buffers, with the provided frame capacity
+	/// </summary>
+	AudioBlock(int capacity, float samplingRate)
+	{
+		// MEMORY! ~AudioBlock
+		_left = new float[capacity];
+		_right = new float[capacity];
+		_capacity = capacity;
+		_samplingRate = samplingRate;
+		_isView = false;
+		_isMono = false;
+
+		this->Clear(capacity);
+	}
+
+	/// <summary>
+	/// Creates a view into the parent block's buffers, starting at the frame offset. The view does not
+	/// own the buffers; and it must not outlive the parent block.
+	/// </summary>
+	AudioBlock(const AudioBlock* parent, int frameOffset, int frameCount)
+	{
+		if (frameOffset < 0 || frameOffset + frameCount > parent->GetCapacity())
+			throw new std::exception("Audio block view is outside of the parent block:  AudioBlock.h");
+
+		_left = parent->GetLeft() + frameOffset;
+		_right = parent->GetRight() + frameOffset;
+		_capacity = frameCount;
+		_samplingRate = parent->GetSamplingRate();
+		_isView = true;
+		_isMono = parent->IsMono();
+	}
+	~AudioBlock()
+	{
+		if (!_isView)
+		{
+			delete[] _left;
+			delete[] _right;
+		}
+	}
+
+	AudioBlock(const AudioBlock& copy) = delete;
+	AudioBlock& operator=(const AudioBlock& copy) = delete;
+
+	float* GetLeft() const { return _left; }
+	float* GetRight() const { return _right; }
+	int GetCapacity() const { return _capacity; }
+	float GetSamplingRate() const { return _samplingRate; }
+
+	/// <summary>
+	/// Returns true if the block is mono (the signal is in the left channel only)
+	/// </summary>
+	bool IsMono() const { return _isMono; }
+
+	/// <summary>
+	/// Sets the channel count of the block. This does not copy any samples (see Widen)
+	/// </summary>
+	void SetMono(bool value) { _isMono = value; }
+
+	/// <summary>
+	/// Copies the (mono) left channel to the right channel, for the first frameCount frames, and sets the
+	/// block to stereo
+	/// </summary>
+	void Widen(int frameCount)
+	{
+		if (!_isMono)
+			return;
+
+		for (int index = 0; index < frameCount; index++)
+			_right[index] = _left[index];
+
+		_isMono = false;
+	}
+
+	/// <summary>
+	/// Returns the channel that holds the right signal (the left channel for a mono block)
+	/// </summary>
+	const float* GetRightSignal() const { return _isMono ? _left : _right; }
+
+	void GetFrame(int index, PlaybackFrame* frame) const
+	{
+		frame->SetFrame(_left[index], _isMono ? _left[index] : _right[index]);
+	}
+	void SetFrame(int index, const PlaybackFrame* frame)
+	{
+		_left[index] = frame->GetLeft();
+		_right[index] = frame->GetRight();
+	}
+	void SetFrame(int index, float left, float right)
+	{
+		_left[index] = left;
+		_right[index] = right;
+	}
+	void AddFrame(int index, float left, float right)
+	{
+		_left[index] += left;
+		_right[index] += right;
+	}
+	void MultFrame(int index, float constantLeft, float constantRight)
+	{
+		_left[index] *= constantLeft;
+		_right[index] *= constantRight;
+	}
+
+	/// <summary>
+	/// Clears the first frameCount frames of the block
+	/// </summary>
+	void Clear(int frameCount)
+	{
+		for (int index = 0; index < frameCount; index++)
+		{
+			_left[index] = 0;
+			_right[index] = 0;
+		}
+	}
+
+	/// <summary>
+	/// Copies the first frameCount frames of the source block into this block
+	/// </summary>
+	void CopyBlock(const AudioBlock* source, int frameCount)
+	{
+		const float* sourceLeft = source->GetLeft();
+		const float* sourceRight = source->GetRightSignal();
+
+		// Mono:  The right channel is not kept
+		if (_isMono && source->IsMono())
+		{
+			for (int index = 0; index < frameCount; index++)
+				_left[index] = sourceLeft[index];
+
+			return;
+		}
+
+		_isMono = false;
+
+		for (int index = 0; index < frameCount; index++)
+		{
+			_left[index] = sourceLeft[index];
+			_right[index] = sourceRight[index];
+		}
+	}
+
+	/// <summary>
+	/// Adds (mixes) the first frameCount frames of the source block into this block. A mono source is added
+	/// to both channels; and a stereo source widens a mono block.
+	/// </summary>
+	void AddBlock(const AudioBlock* source, int frameCount)
+	{
+		const float* sourceLeft = source->GetLeft();
+		const float* sourceRight = source->GetRightSignal();
+
+		// Mono:  The right channel is not kept
+		if (_isMono && source->IsMono())
+		{
+			for (int index = 0; index < frameCount; index++)
+				_left[index] += sourceLeft[index];
+
+			return;
+		}
+
+		Widen(frameCount);
+
+		for (int index = 0; index < frameCount; index++)
+		{
+			_left[index] += sourceLeft[index];
+			_right[index] += sourceRight[index];
+		}
+	}
+
+	/// <summary>
+	/// Multiplies the first frameCount frames by the (constant) gain
+	/// </summary>
+	void MultBlock(float gainLeft, float gainRight, int frameCount)
+	{
+		for (int index = 0; index < frameCount; index++)
+		{
+			_left[index] *= gainLeft;
+			_right[index] *= gainRight;
+		}
+	}
+
+private:
+
+	float* _left;
+	float* _right;
+	int _capacity;
+	float _samplingRate;
+
+	// Views do not own the channel buffers
+	bool _isView;
+
+	// Channel count of the connection (see Widen)
+	bool _isMono;
+};
+
+#endif
@@ -25,7 +25,7 @@ public:
 public:
 
 	AudioController(AtomicLock* playbackLock) : BaseController(playbackLock) {};
-	~AudioController() {};
+	virtual ~AudioController() {};
 
 	bool Initialize(PlaybackUserData* playbackData) override
 	{
@@ -39,8 +39,8 @@ public:
 protected:
 
 	/// <summary>
-	/// Lock required for the playback thread since we do not have dispatch control over
-	/// it, we have to force synchronization to wait on the SynthSettings* shared pointer.
+	/// Lock shared between the controllers. This must NOT be taken on the playback thread! The
+	/// SynthSettings* are handed to playback as snapshots (see PlaybackUserData::PublishSynthSettings)
 	/// </summary>
 	AtomicLock* PlaybackLock;
 };
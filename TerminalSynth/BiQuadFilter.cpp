@@ -1,8 +1,11 @@
+#include "AudioBlock.h"
 #include "BiQuadFilter.h"
+#include "DenormalGuard.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "SignalParameterizedBase.h"
+#include <algorithm>
 #include <cmath>
 #include <exception>
 #include <numbers>
@@ -32,6 +35,21 @@ BiQuadFilter::BiQuadFilter(FilterType filterType, unsigned int samplingRate, flo
 	_b1 = 0;
 	_b2 = 0;
 
+	for (int index = 0; index < 5; index++)
+	{
+		_coefficients[index] = 0;
+		_coefficientSteps[index] = 0;
+		_rampEndCoefficients[index] = 0;
+	}
+
+	_rampStartValues[0] = _rampEndValues[0] = dbGain;
+	_rampStartValues[1] = _rampEndValues[1] = corner;
+	_rampStartValues[2] = _rampEndValues[2] = resonance;
+	_rampLength = 0;
+	_rampPending = false;
+	_rampFrames = 0;
+	_streamSamplingRate = 0;
+
 	_input1 = new PlaybackFrame();
 	_input2 = new PlaybackFrame();
 	_output1 = new PlaybackFrame();
@@ -54,38 +72,95 @@ void BiQuadFilter::Initialize(const PlaybackInfo* parameters)
 	this->AddParameter("Corner", 0.0f, _samplingRate / 4.0f, _corner);	// Set based on the sampling rate [0, F_s / 4]
 	this->AddParameter("Q", 0.01f, 1.0f, _resonance);					// (see Bi-Quad equation sheet)
 
+	_streamSamplingRate = parameters->GetStreamInfo()->streamSampleRate;
+
+	SetCoefficients();
+}
+
+void BiQuadFilter::SetCoefficients()
+{
 	switch (_type)
 	{
-	case BiQuadFilter::FilterType::LPF:			Set_LPF(parameters->GetStreamInfo()->streamSampleRate); break;
-	case BiQuadFilter::FilterType::HPF:			Set_HPF(parameters->GetStreamInfo()->streamSampleRate); break;
-	case BiQuadFilter::FilterType::BPF_Gain:	Set_BPF_Gain(parameters->GetStreamInfo()->streamSampleRate); break;
-	case BiQuadFilter::FilterType::BPF_Flat:	Set_BPF_Flat(parameters->GetStreamInfo()->streamSampleRate); break;
-	case BiQuadFilter::FilterType::Notch:		Set_Notch(parameters->GetStreamInfo()->streamSampleRate); break;
-	case BiQuadFilter::FilterType::APF:			Set_APF(parameters->GetStreamInfo()->streamSampleRate); break;
-	case BiQuadFilter::FilterType::PeakingEQ:	Set_PeakingEQ(parameters->GetStreamInfo()->streamSampleRate); break;
-	case BiQuadFilter::FilterType::LowShelf:	Set_LowShelf(parameters->GetStreamInfo()->streamSampleRate); break;
-	case BiQuadFilter::FilterType::HighShelf:	Set_HighShelf(parameters->GetStreamInfo()->streamSampleRate); break;
+	case BiQuadFilter::FilterType::LPF:			Set_LPF(_streamSamplingRate); break;
+	case BiQuadFilter::FilterType::HPF:			Set_HPF(_streamSamplingRate); break;
+	case BiQuadFilter::FilterType::BPF_Gain:	Set_BPF_Gain(_streamSamplingRate); break;
+	case BiQuadFilter::FilterType::BPF_Flat:	Set_BPF_Flat(_streamSamplingRate); break;
+	case BiQuadFilter::FilterType::Notch:		Set_Notch(_streamSamplingRate); break;
+	case BiQuadFilter::FilterType::APF:			Set_APF(_streamSamplingRate); break;
+	case BiQuadFilter::FilterType::PeakingEQ:	Set_PeakingEQ(_streamSamplingRate); break;
+	case BiQuadFilter::FilterType::LowShelf:	Set_LowShelf(_streamSamplingRate); break;
+	case BiQuadFilter::FilterType::HighShelf:	Set_HighShelf(_streamSamplingRate); break;
 	default:
-		throw new std::exception("Unhandled BiQuad Filter type:  BiQuadFilter::Initialize");
+		throw new std::exception("Unhandled BiQuad Filter type:  BiQuadFilter::SetCoefficients");
+	}
+
+	_coefficients[0] = _b0 / _a0;
+	_coefficients[1] = _b1 / _a0;
+	_coefficients[2] = _b2 / _a0;
+	_coefficients[3] = _a1 / _a0;
+	_coefficients[4] = _a2 / _a0;
+
+	_rampFrames = 0;
+}
+
+void BiQuadFilter::BeginRamp()
+{
+	float startCoefficients[5];
+
+	_dbGain = _rampStartValues[0];
+	_corner = _rampStartValues[1];
+	_resonance = _rampStartValues[2];
+
+	SetCoefficients();
+
+	for (int index = 0; index < 5; index++)
+		startCoefficients[index] = _coefficients[index];
+
+	// (The parameters are left at the end of the ramp)
+	_dbGain = _rampEndValues[0];
+	_corner = _rampEndValues[1];
+	_resonance = _rampEndValues[2];
+
+	SetCoefficients();
+
+	for (int index = 0; index < 5; index++)
+	{
+		_rampEndCoefficients[index] = _coefficients[index];
+		_coefficientSteps[index] = (_rampEndCoefficients[index] - startCoefficients[index]) / _rampLength;
+		_coefficients[index] = startCoefficients[index];
+
+		// (Parameters that are not automated hold their value)
+		if (index < 3)
+			_rampStartValues[index] = _rampEndValues[index];
 	}
+
+	_rampFrames = _rampLength;
+	_rampPending = false;
 }
 
 void BiQuadFilter::SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime)
 {
+	if (_rampPending)
+		BeginRamp();
+
 	float inputLeft = frame->GetLeft();
 	float inputRight = frame->GetRight();
 
-	float outputLeft = ((_b0 / _a0) * inputLeft) +
-					   ((_b1 / _a0) * _input1->GetLeft()) +
-					   ((_b2 / _a0) * _input2->GetLeft()) -
-					   ((_a1 / _a0) * _output1->GetLeft()) -
-					   ((_a2 / _a0) * _output2->GetLeft());
+	float outputLeft = (_coefficients[0] * inputLeft) +
+					   (_coefficients[1] * _input1->GetLeft()) +
+					   (_coefficients[2] * _input2->GetLeft()) -
+					   (_coefficients[3] * _output1->GetLeft()) -
+					   (_coefficients[4] * _output2->GetLeft());
+
+	float outputRight = (_coefficients[0] * inputRight) +
+						(_coefficients[1] * _input1->GetRight()) +
+						(_coefficients[2] * _input2->GetRight()) -
+						(_coefficients[3] * _output1->GetRight()) -
+						(_coefficients[4] * _output2->GetRight());
 
-	float outputRight = ((_b0 / _a0) * inputRight) +
-						((_b1 / _a0) * _input1->GetRight()) +
-						((_b2 / _a0) * _input2->GetRight()) -
-						((_a1 / _a0) * _output1->GetRight()) -
-						((_a2 / _a0) * _output2->GetRight());
+	// Denormal Guard:  The output is fed back (the release tail decays toward zero)
+	outputLeft = DenormalGuard::Flush(outputLeft);
+	outputRight = DenormalGuard::Flush(outputRight);
 
 	// Track Input
 	_input2->SetFrame(_input1);
@@ -96,6 +171,86 @@ void BiQuadFilter::SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playba
 	// Track Output
 	_output2->SetFrame(_output1);
 	_output1->SetFrame(frame);
+
+	// Automation Ramp (see UpdateParameterRamp)
+	if (_rampFrames > 0)
+	{
+		_rampFrames--;
+
+		for (int index = 0; index < 5; index++)
+			_coefficients[index] = _rampFrames > 0 ? _coefficients[index] + _coefficientSteps[index] : _rampEndCoefficients[index];
+	}
+}
+
+void BiQuadFilter::ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+{
+	if (!block->IsMono())
+	{
+		SignalParameterizedBase::ProcessBlockImpl(block, playbackTime, frameCount);
+		return;
+	}
+
+	// Mono:  Left channel only (see IsMonoCapable)
+	float* left = block->GetLeft();
+
+	if (_rampPending)
+		BeginRamp();
+
+	float b0 = _coefficients[0];
+	float b1 = _coefficients[1];
+	float b2 = _coefficients[2];
+	float a1 = _coefficients[3];
+	float a2 = _coefficients[4];
+
+	// Automation Ramp (see UpdateParameterRamp)
+	int rampFrames = std::min(_rampFrames, frameCount);
+
+	float input1 = _input1->GetLeft();
+	float input2 = _input2->GetLeft();
+	float output1 = _output1->GetLeft();
+	float output2 = _output2->GetLeft();
+
+	for (int index = 0; index < frameCount; index++)
+	{
+		float input = left[index];
+		float output = DenormalGuard::Flush((b0 * input) + (b1 * input1) + (b2 * input2) - (a1 * output1) - (a2 * output2));
+
+		input2 = input1;
+		input1 = input;
+		output2 = output1;
+		output1 = output;
+
+		left[index] = output;
+
+		if (index < rampFrames)
+		{
+			b0 += _coefficientSteps[0];
+			b1 += _coefficientSteps[1];
+			b2 += _coefficientSteps[2];
+			a1 += _coefficientSteps[3];
+			a2 += _coefficientSteps[4];
+		}
+	}
+
+	_coefficients[0] = b0;
+	_coefficients[1] = b1;
+	_coefficients[2] = b2;
+	_coefficients[3] = a1;
+	_coefficients[4] = a2;
+
+	_rampFrames -= rampFrames;
+
+	if (rampFrames > 0 && _rampFrames == 0)
+	{
+		for (int index = 0; index < 5; index++)
+			_coefficients[index] = _rampEndCoefficients[index];
+	}
+
+	// The right channel's history follows the left (the block may be widened later in the chain)
+	_input1->SetFrame(input1, input1);
+	_input2->SetFrame(input2, input2);
+	_output1->SetFrame(output1, output1);
+	_output2->SetFrame(output2, output2);
 }
 
 bool BiQuadFilter::HasOutput(const PlaybackTime* playbackTime) const
@@ -103,9 +258,40 @@ bool BiQuadFilter::HasOutput(const PlaybackTime* playbackTime) const
 	return true;
 }
 
+bool BiQuadFilter::IsMonoCapable() const
+{
+	return true;
+}
+
 void BiQuadFilter::UpdateParameter(int index, float value)
 {
-	// Doesn't support parameter automation (right now)
+	switch (index)
+	{
+	case 0: _dbGain = value; break;
+	case 1: _corner = value; break;
+	case 2: _resonance = value; break;
+	default:
+		return;
+	}
+
+	_rampStartValues[index] = value;
+	_rampEndValues[index] = value;
+
+	// (Not yet initialized)
+	if (_streamSamplingRate > 0)
+		SetCoefficients();
+}
+
+void BiQuadFilter::UpdateParameterRamp(int index, float startValue, float endValue, int frameCount)
+{
+	if (index < 0 || index > 2 || frameCount <= 0)
+		return;
+
+	// (The ramp begins with the next frame, once each automated parameter is set; see BeginRamp)
+	_rampStartValues[index] = startValue;
+	_rampEndValues[index] = endValue;
+	_rampLength = frameCount;
+	_rampPending = true;
 }
 
 void BiQuadFilter::Set_LPF(unsigned int samplingRate)
@@ -3,6 +3,7 @@
 #ifndef BIQUAD_FILTER_H
 #define BIQUAD_FILTER_H
 
+#include "AudioBlock.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -14,6 +15,8 @@
 /// Parameter 0:  GainDb (db) (Peaking / Shelving EQ Filters Only)
 /// Parameter 1:  Corner Frequency (All Filter Types)
 /// Parameter 2:  Q (Resonance, Bandwidth, or Shelf Slope depending on filter type)
+/// 
+/// Automation:  The coefficients are interpolated per frame, along each automation ramp (see UpdateParameterRamp)
 /// </summary>
 class BiQuadFilter : public SignalParameterizedBase
 {
@@ -76,15 +79,29 @@ public:
 
 	void Initialize(const PlaybackInfo* parameters) override;
 	bool HasOutput(const PlaybackTime* playbackTime) const override;
+	bool IsMonoCapable() const override;
 
 	void UpdateParameter(int index, float value) override;
 
 protected:
 
+	void UpdateParameterRamp(int index, float startValue, float endValue, int frameCount) override;
+
 	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) override;
+	void ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount) override;
 
 private:
 
+	/// <summary>
+	/// Sets the coefficients from the current parameters (see Set_..); and ends the ramp
+	/// </summary>
+	void SetCoefficients();
+
+	/// <summary>
+	/// Sets the start coefficients, and the per frame steps, for the ramps of the parameters (see UpdateParameterRamp)
+	/// </summary>
+	void BeginRamp();
+
 	void Set_LPF(unsigned int samplingRate);
 	void Set_HPF(unsigned int samplingRate);
 	void Set_BPF_Gain(unsigned int samplingRate);
@@ -95,9 +112,9 @@ private:
 	void Set_LowShelf(unsigned int samplingRate);
 	void Set_HighShelf(unsigned int samplingRate);
 
-	float GetGainDb() const { return this->GetParameterValue(0); }
-	float GetCorner() const { return this->GetParameterValue(1); }
-	float GetQ() const { return this->GetParameterValue(2); }
+	float GetGainDb() const { return _dbGain; }
+	float GetCorner() const { return _corner; }
+	float GetQ() const { return _resonance; }
 
 private:
 
@@ -116,8 +133,22 @@ private:
 	float _b1;
 	float _b2;
 
+	// Normalized coefficients (b0, b1, b2, a1, a2) used by the filter
+	float _coefficients[5];
+
+	// Automation Ramp:  The parameters at each end of the ramp (pending until the next frame); and the per frame
+	// coefficient steps, for the frames that are left
+	float _rampStartValues[3];
+	float _rampEndValues[3];
+	int _rampLength;
+	bool _rampPending;
+	float _coefficientSteps[5];
+	float _rampEndCoefficients[5];
+	int _rampFrames;
+
 	// Needed pre-initialization
 	unsigned int _samplingRate;
+	unsigned int _streamSamplingRate;
 	float _corner;
 	float _resonance;
 	float _dbGain;
@@ -0,0 +1,136 @@
+#pragma once
+
+#ifndef BLOCK_EVENT_SCHEDULE_H
+#define BLOCK_EVENT_SCHEDULE_H
+
+#include "PlaybackTime.h"
+
+enum class BlockEventType : int
+{
+	NoteOn = 0,
+	NoteOff = 1
+};
+
+/// <summary>
+/// Event that is applied at an exact frame of the stream (see PlaybackTime::frameCursor)
+/// </summary>
+struct BlockEvent
+{
+	BlockEventType type;
+	int midiNumber;
+	float velocity;
+	size_t frameCursor;
+};
+
+/// <summary>
+/// Fixed capacity, time-sorted list of BlockEvent's for the renderer. The renderer splits each block at the
+/// event frames (see Synth::ProcessBlock); so that events land on the exact sample, regardless of the buffer
+/// size. Nothing is allocated after construction.
+/// </summary>
+class BlockEventSchedule
+{
+public:
+
+	BlockEventSchedule(int capacity)
+	{
+		// MEMORY! ~BlockEventSchedule
+		_events = new BlockEvent[capacity];
+		_capacity = capacity;
+		_count = 0;
+		_cursor = 0;
+	}
+	~BlockEventSchedule()
+	{
+		delete[] _events;
+	}
+
+	BlockEventSchedule(const BlockEventSchedule& copy) = delete;
+	BlockEventSchedule& operator=(const BlockEventSchedule& copy) = delete;
+
+	/// <summary>
+	/// Adds the event in time order (after any events at the same frame). Returns false if the schedule is full.
+	/// </summary>
+	bool Add(const BlockEvent& blockEvent)
+	{
+		// Fully applied:  Start over at the front of the buffer
+		if (_cursor >= _count)
+		{
+			_count = 0;
+			_cursor = 0;
+		}
+
+		if (_count >= _capacity)
+			return false;
+
+		int index = _count;
+
+		// Insertion (events usually arrive in order; so this rarely moves anything)
+		while (index > _cursor && _events[index - 1].frameCursor > blockEvent.frameCursor)
+		{
+			_events[index] = _events[index - 1];
+			index--;
+		}
+
+		_events[index] = blockEvent;
+		_count++;
+
+		return true;
+	}
+
+	/// <summary>
+	/// Returns true if the next event is due at, or before, the frame cursor
+	/// </summary>
+	bool IsDue(size_t frameCursor) const
+	{
+		return _cursor < _count && _events[_cursor].frameCursor <= frameCursor;
+	}
+
+	/// <summary>
+	/// Removes (and returns) the next event. Check IsDue first.
+	/// </summary>
+	const BlockEvent& Next()
+	{
+		return _events[_cursor++];
+	}
+
+	/// <summary>
+	/// Returns the frame offset (from the start of the block) of the next event; or the frame count, if there
+	/// are no more events inside of the block.
+	/// </summary>
+	int GetNextOffset(const PlaybackTime* blockTime, int frameCount) const
+	{
+		if (_cursor >= _count || _events[_cursor].frameCursor >= blockTime->frameCursor + frameCount)
+			return frameCount;
+
+		if (_events[_cursor].frameCursor <= blockTime->frameCursor)
+			return 0;
+
+		return (int)(_events[_cursor].frameCursor - blockTime->frameCursor);
+	}
+
+	/// <summary>
+	/// Returns true if every event has been applied
+	/// </summary>
+	bool IsEmpty() const
+	{
+		return _cursor >= _count;
+	}
+
+	/// <summary>
+	/// Removes all events
+	/// </summary>
+	void Clear()
+	{
+		_count = 0;
+		_cursor = 0;
+	}
+
+private:
+
+	BlockEvent* _events;
+	int _capacity;
+	int _count;
+	int _cursor;
+};
+
+#endif
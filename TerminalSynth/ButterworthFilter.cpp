@@ -1,4 +1,6 @@
+#include "AudioBlock.h"
 #include "ButterworthFilter.h"
+#include "DenormalGuard.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -23,9 +25,6 @@ ButterworthFilter::ButterworthFilter(int samplingRate, float gain) : SignalParam
 
 	this->min_cutoff = samplingRate * 0.01f;
 	this->max_cutoff = samplingRate * 0.45f;
-
-	this->AddParameter("Cutoff", this->min_cutoff, this->max_cutoff, 5000);		// Index 0
-	this->AddParameter("Resonance", 0, 1, 0.5f);								// Index 1
 }
 
 ButterworthFilter::~ButterworthFilter()
@@ -36,6 +35,9 @@ ButterworthFilter::~ButterworthFilter()
 void ButterworthFilter::Initialize(const PlaybackInfo* parameters)
 {
 	//SignalParameterizedBase::Initialize(parameters);
+
+	this->AddParameter("Cutoff", this->min_cutoff, this->max_cutoff, 5000);		// Index 0
+	this->AddParameter("Resonance", 0, 1, 0.5f);								// Index 1
 }
 
 void ButterworthFilter::SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime)
@@ -46,11 +48,31 @@ void ButterworthFilter::SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* p
 	frame->SetFrame(outputLeft, outputRight);
 }
 
+void ButterworthFilter::ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+{
+	if (!block->IsMono())
+	{
+		SignalParameterizedBase::ProcessBlockImpl(block, playbackTime, frameCount);
+		return;
+	}
+
+	// Mono:  Left channel only (see IsMonoCapable)
+	float* left = block->GetLeft();
+
+	for (int index = 0; index < frameCount; index++)
+		left[index] = this->Apply(left[index]);
+}
+
 bool ButterworthFilter::HasOutput(const PlaybackTime* playbackTime) const
 {
 	return true;
 }
 
+bool ButterworthFilter::IsMonoCapable() const
+{
+	return true;
+}
+
 void ButterworthFilter::SetFilter(float cutoff, float resonance)
 {
 	if (cutoff < this->min_cutoff)
@@ -99,7 +121,7 @@ float ButterworthFilter::Apply(float sample)
 	float new_hist;
 
 	output -= this->history1 * this->coef0;
-	new_hist = output - this->history2 * this->coef1;
+	new_hist = DenormalGuard::Flush(output - this->history2 * this->coef1);
 
 	output = new_hist + this->history1 * 2.f;
 	output += this->history2;
@@ -108,7 +130,7 @@ float ButterworthFilter::Apply(float sample)
 	this->history1 = new_hist;
 
 	output -= this->history3 * this->coef2;
-	new_hist = output - this->history4 * this->coef3;
+	new_hist = DenormalGuard::Flush(output - this->history4 * this->coef3);
 
 	output = new_hist + this->history3 * 2.f;
 	output += this->history4;
@@ -4,6 +4,7 @@
 #define BUTTERWORTH_FILTER_H
 #define BUDDA_Q_SCALE 6.f
 
+#include "AudioBlock.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -18,6 +19,7 @@ public:
 
 	void Initialize(const PlaybackInfo* parameters) override;
 	bool HasOutput(const PlaybackTime* playbackTime) const override;
+	bool IsMonoCapable() const override;
 
 	void SetFilter(float cutoff, float resonance);
 
@@ -26,6 +28,7 @@ public:
 protected:
 
 	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) override;
+	void ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount) override;
 
 private:
 
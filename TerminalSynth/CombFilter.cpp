@@ -1,4 +1,6 @@
+#include "AudioBlock.h"
 #include "CombFilter.h"
+#include "DenormalGuard.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -53,6 +55,7 @@ void CombFilter::SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playback
 
 	// Remove used sample
 	_bufferL->pop();
+	_bufferR->pop();
 
 	// Feed-forward -> store input sample
 	if (!feedback)
@@ -61,16 +64,49 @@ void CombFilter::SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playback
 		_bufferR->push(frame->GetRight());
 	}
 
-	// Feed-back -> store result
+	// Feed-back -> store result (Denormal Guard:  The result decays toward zero)
 	else
 	{
-		_bufferL->push(outputL);
-		_bufferR->push(outputR);
+		_bufferL->push(DenormalGuard::Flush(outputL));
+		_bufferR->push(DenormalGuard::Flush(outputR));
 	}
 
 	frame->SetFrame(outputL, outputR);
 }
 
+void CombFilter::ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+{
+	if (!block->IsMono())
+	{
+		SignalParameterizedBase::ProcessBlockImpl(block, playbackTime, frameCount);
+		return;
+	}
+
+	// Mono:  Left channel only (see IsMonoCapable). The right delay line is kept in step with the left; so the
+	//		  block may be widened later in the chain.
+	float* left = block->GetLeft();
+	float gain = this->GetParameterValue(1);
+	bool feedback = this->GetParameterValue(2) > 0.5f;
+
+	for (int index = 0; index < frameCount; index++)
+	{
+		float output = left[index] + (gain * _bufferL->front());
+		float stored = feedback ? DenormalGuard::Flush(output) : left[index];
+
+		_bufferL->pop();
+		_bufferR->pop();
+		_bufferL->push(stored);
+		_bufferR->push(stored);
+
+		left[index] = output;
+	}
+}
+
+bool CombFilter::IsMonoCapable() const
+{
+	return true;
+}
+
 bool CombFilter::HasOutput(const PlaybackTime* playbackTime) const
 {
 	return this->GetParameterValue(1) > 0.0f;
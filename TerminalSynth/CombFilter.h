@@ -3,6 +3,7 @@
 #ifndef COMBFILTER_H
 #define COMBFILTER_H
 
+#include "AudioBlock.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -24,12 +25,14 @@ public:
 
 	void Initialize(const PlaybackInfo* parameters) override;
 	bool HasOutput(const PlaybackTime* playbackTime) const override;
+	bool IsMonoCapable() const override;
 
 	void UpdateParameter(int index, float parameterValue) override {};		// Doesn't support parameter automation
 
 protected:
 
 	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) override;
+	void ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount) override;
 
 private:
 
@@ -19,7 +19,7 @@ enum class SynthVoiceType : int
 	TerminalSynth,
 	Stk,
 	SoundBank,
-	HarmonicShaper	// TBD
+	HarmonicShaper
 };
 enum class EnvelopeShape : int 
 {
@@ -32,7 +32,12 @@ enum class PrimitiveSynthVoices : int
 	Sine = 0,
 	Square = 1,
 	Triangle = 2,
-	Sawtooth = 3
+	Sawtooth = 3,
+
+	// Band-limited (PolyBLEP / PolyBLAMP) versions of the discontinuous waveforms
+	SquareBandLimited = 4,
+	TriangleBandLimited = 5,
+	SawtoothBandLimited = 6
 };
 enum class TerminalSynthVoices : int {
 	SynthesizedStringPluck = 0,
@@ -75,6 +80,12 @@ enum class ArpeggiatorChord : int {
 	TetradMinor7b5,
 	TetradDiminished7
 };
+
+enum class VoiceStealMode : int {
+	Oldest = 0,
+	Quietest,
+	SameNote
+};
 enum class ParameterAutomationType : int {
 	EnvelopeSweep = 0,
 	Oscillator
@@ -89,7 +100,7 @@ enum class ParameterAutomationOscillator : int {
 
 namespace TerminalSynth
 {
-	float GetMidiFrequency(int midiNumber)
+	inline float GetMidiFrequency(int midiNumber)
 	{
 		return 440.0f * powf(2, ((midiNumber - 69.0f) / 12.0f));
 	}
@@ -97,7 +108,7 @@ namespace TerminalSynth
 	/// <summary>
 	/// Converts hertz to cents (centered at the center frequency). 100 cents is a half-tone.
 	/// </summary>
-	float HertzToCents(float centerFrequency, float frequency)
+	inline float HertzToCents(float centerFrequency, float frequency)
 	{
 		return 1200.0f * log2f(frequency / centerFrequency);
 	}
@@ -105,7 +116,7 @@ namespace TerminalSynth
 	/// <summary>
 	/// Converts cents to hertz with reference to the center frequency
 	/// </summary>
-	float CentsToHertz(float cents, float centerFrequency)
+	inline float CentsToHertz(float cents, float centerFrequency)
 	{
 		return centerFrequency * powf(2.0f, cents / 1200.0f);
 	}
@@ -116,9 +127,51 @@ const int REVERB_ALLPASS_SIZE = 4;
 const int MIDI_PIANO_LOW_NUMBER = 21;
 const int MIDI_PIANO_HIGH_NUMBER = 108;
 const int MIDI_PIANO_SIZE = MIDI_PIANO_HIGH_NUMBER - MIDI_PIANO_LOW_NUMBER + 1;
+const int MIDI_NOTE_COUNT = 128;
 const float SIGNAL_LOW = -1;
 const float SIGNAL_HIGH = 1;
 const float ENVELOPE_LOW = 0;
 const float ENVELOPE_HIGH = 1;
 
-#endif
\ No newline at end of file
+// Maximum number of frames rendered per block. Larger backend buffers are rendered in chunks of this size.
+const int AUDIO_BLOCK_SIZE = 512;
+
+// Number of frames between parameter automation updates (default; see SignalParameterizedBase::SetAutomationInterval)
+const int PARAMETER_AUTOMATION_INTERVAL = 32;
+
+// Offline rendering (see OfflineRenderController):  Output sampling rate, and the time rendered after the last note
+const unsigned int OFFLINE_RENDER_SAMPLING_RATE = 44100;
+const float OFFLINE_RENDER_TAIL_SECONDS = 2.0f;
+
+// Null audio backend (see NullAudioController):  Simulated device clock, and the maximum wake-up delay (jittered pacing)
+const unsigned int NULL_AUDIO_SAMPLING_RATE = 44100;
+const unsigned int NULL_AUDIO_BUFFER_SIZE = 512;
+const float NULL_AUDIO_JITTER_MILLI = 4.0f;
+
+// Polyphony (voices per synth). A stolen voice is faded out (on one of the reserve voices) instead of being cut.
+const int SYNTH_POLYPHONY_DEFAULT = 10;
+const int SYNTH_POLYPHONY_MAX = 32;
+const int SYNTH_STEAL_RESERVE = 4;
+const float SYNTH_STEAL_FADE_SECONDS = 0.005f;
+
+// Synth swap (see Synth::Adopt):  The voices of the previous synth are crossfaded into the voices that continue their notes
+const float SYNTH_SWAP_CROSSFADE_SECONDS = 0.02f;
+
+// Per-voice insert effects (see SynthVoiceBase). Each voice (including the reserve) holds its own instances; so the
+// effect memory is at most (SYNTH_POLYPHONY_MAX + SYNTH_STEAL_RESERVE) * SYNTH_VOICE_EFFECT_MAX plugin instances; plus
+// AIRWINDOWS_SPARE_COUNT instances for each plugin in use, which are used to reset the effects (see AirwindowsSparePool).
+const int SYNTH_VOICE_EFFECT_MAX = 4;
+const int AIRWINDOWS_SPARE_COUNT = 2;
+
+// Silence detection (see SilenceDetector):  Peak threshold, and the time a node must be silent before it sleeps (effects
+// hold longer, so that delay lines, and reverb tails, are not cut).
+const float SILENCE_THRESHOLD_DB = -90.0f;
+const float SILENCE_HOLD_SECONDS = 1.0f;
+const float SYNTH_VOICE_SILENCE_HOLD_SECONDS = 0.05f;
+
+// Signal chain edits (see SignalChain::Adopt):  Maximum number of effects in a chain (including the effects that are
+// fading out); and the time of the crossfade for inserted, and removed, effects.
+const int SIGNAL_CHAIN_CAPACITY = 16;
+const float SIGNAL_CHAIN_CROSSFADE_SECONDS = 0.02f;
+
+#endif
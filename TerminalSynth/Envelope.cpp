@@ -1,9 +1,18 @@
-#include "Algorithm.h"
 #include "Constant.h"
 #include "Envelope.h"
+#include "EnvelopeCurve.h"
 #include "PlaybackTime.h"
 #include <algorithm>
+#include <cmath>
 #include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Curve Store:  Holds a reference to each curve; so the audio thread never drops the last one (see Update). The curves
+//				 that only the store holds are deleted when the next curve is built (off of the audio thread).
+static std::mutex EnvelopeCurveStoreMutex;
+static std::vector<std::shared_ptr<const EnvelopeCurve>> EnvelopeCurveStore;
 
 Envelope::Envelope() : Envelope(EnvelopeShape::Linear, 0.1, 0.15, 0.35, 0.85, 0.65)
 {}
@@ -24,6 +33,8 @@ Envelope::Envelope(EnvelopeShape shape, double attack, double decay, double rele
 	_disEngagedLevel = 0;
 	_engagedTime = 0;
 	_disEngagedTime = 0;
+
+	CreateCurve();
 }
 
 Envelope::Envelope(const Envelope& copy)
@@ -42,16 +53,20 @@ Envelope::Envelope(const Envelope& copy)
 	_disEngagedLevel = 0;
 	_engagedTime = 0;
 	_disEngagedTime = 0;
+
+	// (Shared)
+	_curve = copy._curve;
 }
 Envelope::~Envelope()
-{}
+{
+}
 
 /// <summary>
 /// Returns true if there were changes to the envelope
 /// </summary>
 bool Envelope::Update(const Envelope* envelope)
 {
-	bool isDirty = IsEqual(envelope);
+	bool isDirty = !IsEqual(envelope);
 
 	_attack = envelope->GetAttack();
 	_decay = envelope->GetDecay();
@@ -60,6 +75,11 @@ bool Envelope::Update(const Envelope* envelope)
 	_sustainPeak = envelope->GetSustainPeak();
 	_shape = envelope->GetShape();
 
+	// (The source's curve was built with its parameters. The previous curve is still held by the store; so it is not
+	//  deleted here - see CreateCurve)
+	if (_curve != envelope->_curve)
+		_curve = envelope->_curve;
+
 	return isDirty;
 }
 
@@ -90,26 +110,32 @@ double Envelope::GetSustainPeak() const
 void Envelope::SetAttack(double value)
 {
 	_attack = value;
+	CreateCurve();
 }
 void Envelope::SetAttackPeak(double value)
 {
 	_attackPeak = value;
+	CreateCurve();
 }
 void Envelope::SetDecay(double value)
 {
 	_decay = value;
+	CreateCurve();
 }
 void Envelope::SetRelease(double value)
 {
 	_release = value;
+	CreateCurve();
 }
 void Envelope::SetShape(EnvelopeShape value)
 {
 	_shape = value;
+	CreateCurve();
 }
 void Envelope::SetSustainPeak(double value)
 {
 	_sustainPeak = value;
+	CreateCurve();
 }
 void Envelope::Engage(const PlaybackTime* playbackTime)
 {
@@ -121,6 +147,15 @@ void Envelope::Engage(const PlaybackTime* playbackTime)
 	_engagedTime = playbackTime->streamTime;
 }
 
+void Envelope::Adopt(const Envelope* previous)
+{
+	_engaged = previous->_engaged;
+	_hasEngaged = previous->_hasEngaged;
+	_engagedTime = previous->_engagedTime;
+	_disEngagedTime = previous->_disEngagedTime;
+	_disEngagedLevel = previous->_disEngagedLevel;
+}
+
 void Envelope::DisEngage(const PlaybackTime* playbackTime)
 {
 	if (!_engaged)
@@ -248,28 +283,11 @@ double Envelope::GetEnvelopeLevelImpl(const PlaybackTime* playbackTime)
 	}
 	break;
 	case EnvelopeShape::Gamma:
+	case EnvelopeShape::Gaussian:
 	{
+		// Attack / Decay / Sustain (see EnvelopeCurve)
 		if (_engaged)
-		{
-			// Gamma Distributrion PDF
-			// 
-			// Peak "Mode" = (alpha - 1) * theta
-			// 
-			// For spread, try [alpha * theta = attack + decay + release] and [(alpha - 1) * theta = attack]
-			//
-			double gammaValue = Algorithm::GammaDistribution(envelopeTime, (_attack / (_release + _decay)) + 1, _release + _decay);
-
-			// Attack
-			if (envelopeTime < _attack)
-				result = gammaValue;
-
-			// Decay
-			else if (envelopeTime < _attack + _decay)
-				result = gammaValue;
-
-			else
-				result = std::max(gammaValue, _sustainPeak);
-		}
+			result = _curve->GetLevel(envelopeTime);
 
 		// Release (Linear)
 		else
@@ -278,39 +296,140 @@ double Envelope::GetEnvelopeLevelImpl(const PlaybackTime* playbackTime)
 		}
 	}
 	break;
-	case EnvelopeShape::Gaussian:
+	default:
+		throw new std::exception("Unhandled envelope shape:  Envelope.cpp");
+	}
+
+	return std::min<double>(std::max<double>(result, 0), 1);
+}
+void Envelope::CreateCurve()
+{
+	if (_shape == EnvelopeShape::Linear)
 	{
-		if (_engaged)
+		_curve.reset();
+		return;
+	}
+
+	// MEMORY! (Shared by the envelopes that are updated from this one; and by the store, which deletes it)
+	_curve = std::make_shared<const EnvelopeCurve>(_shape, _attack, _decay, _release, _attackPeak, _sustainPeak);
+
+	std::lock_guard<std::mutex> lock(EnvelopeCurveStoreMutex);
+
+	// Delete the curves that no envelope holds
+	std::erase_if(EnvelopeCurveStore, [](const std::shared_ptr<const EnvelopeCurve>& curve) {
+		return curve.use_count() == 1;
+	});
+
+	EnvelopeCurveStore.push_back(_curve);
+}
+
+void Envelope::GenerateBlock(float* destination, const PlaybackTime* playbackTime, int frameCount, float samplingRate)
+{
+	double frameTime = 1.0 / samplingRate;
+	int frame = 0;
+
+	// Segments:  The level is evaluated at the start of each segment; and advanced per frame
+	while (frame < frameCount)
+	{
+		double streamTime = playbackTime->streamTime + (frame * frameTime);
+		double segmentEnd = 0;
+		double level = 0;
+		double step = 0;
+		const float* curveTable = nullptr;
+
+		// Inactive / Released
+		if (!_hasEngaged ||
+			(!_engaged && streamTime - _disEngagedTime >= _release))
+		{
+			for (; frame < frameCount; frame++)
+				destination[frame] = 0;
+
+			return;
+		}
+
+		// Release (Linear)
+		else if (!_engaged)
+		{
+			double releaseTime = streamTime - _disEngagedTime;
+
+			segmentEnd = _release - releaseTime;
+			level = _disEngagedLevel - ((_sustainPeak / _release) * releaseTime);
+			step = -(_sustainPeak / _release) * frameTime;
+		}
+
+		// Attack / Decay / Sustain
+		else
 		{
-			// Gaussian Distributrion PDF
-			// 
-			// Mean:  Attack
-			// Sigma: Attack + Decay + Release
-			// 
-			double gaussianValue = Algorithm::Gaussian(envelopeTime, _attack, _attack + _decay + _release);
+			double envelopeTime = streamTime - _engagedTime;
+
+			if (_shape != EnvelopeShape::Linear)
+			{
+				int segment = _curve->GetSegment(std::max(envelopeTime, 0.0));
+
+				// Curve table (of the segment)
+				if (segment >= 0)
+				{
+					double segmentStart = _curve->GetSegmentStart(segment);
+					double segmentScale = EnvelopeCurve::SEGMENT_TABLE_SIZE / _curve->GetSegmentLength(segment);
+
+					segmentEnd = (segmentStart + _curve->GetSegmentLength(segment)) - envelopeTime;
+					level = (std::max(envelopeTime, 0.0) - segmentStart) * segmentScale;
+					step = frameTime * segmentScale;
+					curveTable = _curve->GetTable(segment);
+				}
+				else
+				{
+					segmentEnd = frameCount * frameTime;
+					level = _curve->GetEndLevel();
+				}
+			}
 
 			// Attack
-			if (envelopeTime < _attack)
-				result = gaussianValue;
+			else if (envelopeTime < _attack)
+			{
+				segmentEnd = _attack - envelopeTime;
+				level = (_attackPeak / _attack) * envelopeTime;
+				step = (_attackPeak / _attack) * frameTime;
+			}
 
 			// Decay
 			else if (envelopeTime < _attack + _decay)
-				result = gaussianValue;
+			{
+				double slope = (_sustainPeak - _attackPeak) / _decay;
+
+				segmentEnd = (_attack + _decay) - envelopeTime;
+				level = (slope * (envelopeTime - _attack)) + _attackPeak;
+				step = slope * frameTime;
+			}
 
+			// Sustain
 			else
-				result = std::max(gaussianValue, _sustainPeak);
+			{
+				segmentEnd = frameCount * frameTime;
+				level = _sustainPeak;
+			}
 		}
 
-		// Release (Linear)
+		// Frames inside of the segment
+		int segmentCount = std::min(frameCount - frame, std::max(1, (int)std::ceil(segmentEnd * samplingRate)));
+
+		if (curveTable != nullptr)
+		{
+			for (int index = 0; index < segmentCount; index++)
+			{
+				double position = level + (index * step);
+				int tableIndex = std::min((int)position, EnvelopeCurve::SEGMENT_TABLE_SIZE);
+				float fraction = (float)(position - tableIndex);
+
+				destination[frame + index] = curveTable[tableIndex] + (fraction * (curveTable[tableIndex + 1] - curveTable[tableIndex]));
+			}
+		}
 		else
 		{
-			result = ((-1 * (_sustainPeak / _release)) * envelopeTime) + (_sustainPeak * (envelopeTimeDisEngage / _release)) + _disEngagedLevel;
+			for (int index = 0; index < segmentCount; index++)
+				destination[frame + index] = (float)std::min<double>(std::max<double>(level + (index * step), 0), 1);
 		}
-	}
-	break;
-	default:
-		throw new std::exception("Unhandled envelope shape:  Envelope.cpp");
-	}
 
-	return std::min<double>(std::max<double>(result, 0), 1);
-}
\ No newline at end of file
+		frame += segmentCount;
+	}
+}
@@ -4,10 +4,19 @@
 #define ENVELOPE_H
 
 #include "Constant.h"
+#include "EnvelopeCurve.h"
 #include "PlaybackTime.h"
 #include <istream>
+#include <memory>
 #include <ostream>
 
+/// <summary>
+/// Attack, decay, sustain, release envelope. The level is a function of the stream time; and the curved shapes
+/// (Gamma, Gaussian) are read from per-segment tables (see EnvelopeCurve). The tables are built when the parameters
+/// are set (the settings copies, off of the audio thread); and shared by the envelopes that are updated from them
+/// (see Update). Blocks are generated as a segment state machine (see GenerateBlock), which costs a couple of
+/// operations per frame.
+/// </summary>
 class Envelope
 {
 public:
@@ -16,13 +25,30 @@ public:
 	Envelope(const Envelope& copy);
 	~Envelope();
 
+	/// <summary>
+	/// Copies the parameters; and shares the source's curve tables (nothing is built, or deleted, so this may be
+	/// called from the audio thread). Returns true if there were changes to the envelope.
+	/// </summary>
 	bool Update(const Envelope* envelope);
 
 	void Engage(const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// Takes over the note state (engaged / released times) of the previous voice's envelope; so the level
+	/// continues from where it was, instead of starting over at the attack (see SynthVoicePool::AdoptNotes)
+	/// </summary>
+	void Adopt(const Envelope* previous);
 	void DisEngage(const PlaybackTime* playbackTime);
 	bool HasOutput(const PlaybackTime* playbackTime);
 	bool IsEngaged();
 	double GetEnvelopeLevel(const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// Writes the envelope level for each frame of the block, starting at the playback time. The level is
+	/// evaluated once per segment; and advanced incrementally inside of the segment (a linear add, or a step
+	/// through the curve table).
+	/// </summary>
+	void GenerateBlock(float* destination, const PlaybackTime* playbackTime, int frameCount, float samplingRate);
 	double GetEngageTime();
 	double GetDisEngageTime();
 
@@ -52,6 +78,8 @@ public:
 		stream >> _sustainPeak;
 
 		_shape = (EnvelopeShape)envelopeShape;
+
+		CreateCurve();
 	}
 
 	bool IsEqual(const Envelope* other)
@@ -88,6 +116,12 @@ private:
 
 	double GetEnvelopeLevelImpl(const PlaybackTime* playbackTime);
 
+	/// <summary>
+	/// Builds the curve tables for the curved shapes (see EnvelopeCurve); and deletes the curves that are no longer
+	/// held by any envelope. (Not for the audio thread)
+	/// </summary>
+	void CreateCurve();
+
 private:
 
 	EnvelopeShape _shape;
@@ -99,6 +133,9 @@ private:
 	double _attackPeak;
 	double _sustainPeak;
 
+	// Shared, read-only curve tables (null for the linear shape)
+	std::shared_ptr<const EnvelopeCurve> _curve;
+
 	// Values stored when SynthNote is pressed / released
 	//
 
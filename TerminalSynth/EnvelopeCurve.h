@@ -0,0 +1,168 @@
+#pragma once
+
+#ifndef ENVELOPE_CURVE_H
+#define ENVELOPE_CURVE_H
+
+#include "Algorithm.h"
+#include "Constant.h"
+#include <algorithm>
+#include <exception>
+
+/// <summary>
+/// Level tables for the curved envelope shapes (Gamma, Gaussian). There is one table per segment (attack, decay,
+/// and the tail of the distribution above the sustain level); so a short attack has the same resolution as a long
+/// release. The tables are built when the envelope parameters change (off of the audio thread), and are read-only
+/// after that; so one curve is shared by the envelopes of every voice (see Envelope::Update).
+/// </summary>
+class EnvelopeCurve
+{
+public:
+
+	// Attack, decay, and the tail (the spread of the distributions past the decay)
+	static const int SEGMENT_COUNT = 3;
+
+	// Samples per segment (with one guard sample after, for the interpolation)
+	static const int SEGMENT_TABLE_SIZE = 256;
+
+public:
+
+	EnvelopeCurve(EnvelopeShape shape, double attack, double decay, double release, double attackPeak, double sustainPeak)
+	{
+		_shape = shape;
+		_attack = attack;
+		_decay = decay;
+		_release = release;
+		_sustainPeak = sustainPeak;
+
+		_segmentStart[0] = 0;
+		_segmentLength[0] = attack;
+		_segmentStart[1] = attack;
+		_segmentLength[1] = decay;
+		_segmentStart[2] = attack + decay;
+		_segmentLength[2] = release;
+
+		for (int segment = 0; segment < SEGMENT_COUNT; segment++)
+		{
+			for (int index = 0; index <= SEGMENT_TABLE_SIZE; index++)
+			{
+				double envelopeTime = _segmentStart[segment] + ((_segmentLength[segment] * index) / SEGMENT_TABLE_SIZE);
+
+				_tables[segment][index] = Evaluate(envelopeTime);
+			}
+
+			// Guard (interpolation at the end of the table)
+			_tables[segment][SEGMENT_TABLE_SIZE + 1] = _tables[segment][SEGMENT_TABLE_SIZE];
+		}
+
+		_length = attack + decay + release;
+		_endLevel = Evaluate(_length);
+	}
+	~EnvelopeCurve() {};
+
+	EnvelopeCurve(const EnvelopeCurve& copy) = delete;
+	EnvelopeCurve& operator=(const EnvelopeCurve& copy) = delete;
+
+	/// <summary>
+	/// Returns the segment for the (engaged) envelope time; or -1 if it is past the end of the curve
+	/// </summary>
+	int GetSegment(double envelopeTime) const
+	{
+		for (int segment = 0; segment < SEGMENT_COUNT; segment++)
+		{
+			if (envelopeTime < _segmentStart[segment] + _segmentLength[segment])
+				return segment;
+		}
+
+		return -1;
+	}
+
+	const float* GetTable(int segment) const { return _tables[segment]; }
+	double GetSegmentStart(int segment) const { return _segmentStart[segment]; }
+	double GetSegmentLength(int segment) const { return _segmentLength[segment]; }
+
+	/// <summary>
+	/// Level after the end of the curve (the sustain)
+	/// </summary>
+	float GetEndLevel() const { return _endLevel; }
+
+	/// <summary>
+	/// Returns the (engaged) level, interpolated from the segment table
+	/// </summary>
+	double GetLevel(double envelopeTime) const
+	{
+		int segment = GetSegment(std::max(envelopeTime, 0.0));
+
+		if (segment < 0)
+			return _endLevel;
+
+		const float* table = _tables[segment];
+
+		double position = (std::max(envelopeTime, 0.0) - _segmentStart[segment]) * (SEGMENT_TABLE_SIZE / _segmentLength[segment]);
+
+		int index = std::min((int)position, SEGMENT_TABLE_SIZE);
+		double fraction = position - index;
+
+		return table[index] + (fraction * (table[index + 1] - table[index]));
+	}
+
+private:
+
+	/// <summary>
+	/// Evaluates the distribution at the envelope time; with the sustain level after the decay
+	/// </summary>
+	float Evaluate(double envelopeTime) const
+	{
+		double result = 0;
+
+		switch (_shape)
+		{
+		case EnvelopeShape::Gamma:
+
+			// Gamma Distributrion PDF
+			//
+			// Peak "Mode" = (alpha - 1) * theta
+			//
+			// For spread, try [alpha * theta = attack + decay + release] and [(alpha - 1) * theta = attack]
+			//
+			result = Algorithm::GammaDistribution(envelopeTime, (_attack / (_release + _decay)) + 1, _release + _decay);
+			break;
+
+		case EnvelopeShape::Gaussian:
+
+			// Gaussian Distributrion PDF
+			//
+			// Mean:  Attack
+			// Sigma: Attack + Decay + Release
+			//
+			result = Algorithm::Gaussian(envelopeTime, _attack, _attack + _decay + _release);
+			break;
+
+		default:
+			throw new std::exception("Unhandled envelope shape:  EnvelopeCurve.h");
+		}
+
+		// Sustain
+		if (envelopeTime >= _attack + _decay)
+			result = std::max(result, _sustainPeak);
+
+		return (float)std::min<double>(std::max<double>(result, 0), 1);
+	}
+
+private:
+
+	EnvelopeShape _shape;
+
+	double _attack;
+	double _decay;
+	double _release;
+	double _sustainPeak;
+
+	float _tables[SEGMENT_COUNT][SEGMENT_TABLE_SIZE + 2];
+	double _segmentStart[SEGMENT_COUNT];
+	double _segmentLength[SEGMENT_COUNT];
+
+	double _length;
+	float _endLevel;
+};
+
+#endif
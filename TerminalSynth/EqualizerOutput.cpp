@@ -0,0 +1,195 @@
+#include "Algorithm.h"
+#include "Constant.h"
+#include "EqualizerOutput.h"
+#include "FFTPlan.h"
+#include "PlaybackFrame.h"
+#include "SeqLock.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <thread>
+#include <vector>
+
+EqualizerOutput::EqualizerOutput(unsigned int inputSizePowOf2, unsigned int outputSize)
+{
+	if ((inputSizePowOf2 / 2) < outputSize)
+		throw new std::exception("Must have at least one frequency bin per output band:  EqualizerOutput.cpp");
+
+	_outputSize = outputSize;
+
+	// MEMORY! ~EqualizerOutput
+	_tap = new SpscQueue<float>(TAP_BLOCK_CAPACITY * 2 * AUDIO_BLOCK_SIZE);
+	_tapBlock = new float[2 * AUDIO_BLOCK_SIZE];
+
+	_fftPlan = new FFTPlan(inputSizePowOf2);
+	_window = new float[inputSizePowOf2];
+	_leftInput = new float[inputSizePowOf2];
+	_rightInput = new float[inputSizePowOf2];
+	_binReal = new float[_fftPlan->GetBinCount()];
+	_binImaginary = new float[_fftPlan->GetBinCount()];
+	_tapRead = new float[2 * AUDIO_BLOCK_SIZE];
+	_bandEdges = new int[outputSize + 1];
+	_bands = new float[2 * outputSize];
+	_output = new SeqLock<float>(2 * outputSize);
+
+	_cursor = 0;
+	_thread = nullptr;
+	_stopping.store(false);
+
+	// Input (The window is computed once)
+	for (int index = 0; index < inputSizePowOf2; index++)
+	{
+		_window[index] = (float)Algorithm::GaussianWindow(0.4, index, inputSizePowOf2);
+		_leftInput[index] = 0;
+		_rightInput[index] = 0;
+	}
+
+	// Band Edges:  Geometric from bin 1 (DC is skipped) through Nyquist; with at least one bin per band
+	int lastBin = _fftPlan->GetBinCount() - 1;
+
+	_bandEdges[0] = 1;
+	_bandEdges[outputSize] = lastBin + 1;
+
+	for (int index = 1; index < outputSize; index++)
+	{
+		int edge = (int)std::round(std::pow((double)lastBin, index / (double)outputSize));
+
+		_bandEdges[index] = std::clamp(edge, _bandEdges[index - 1] + 1, lastBin + 1 - (int)(outputSize - index));
+	}
+
+	for (int index = 0; index < 2 * outputSize; index++)
+		_bands[index] = 0;
+}
+
+EqualizerOutput::~EqualizerOutput()
+{
+	if (_thread != nullptr)
+		this->Stop();
+
+	delete _tap;
+	delete[] _tapBlock;
+	delete _fftPlan;
+	delete[] _window;
+	delete[] _leftInput;
+	delete[] _rightInput;
+	delete[] _binReal;
+	delete[] _binImaginary;
+	delete[] _tapRead;
+	delete[] _bandEdges;
+	delete[] _bands;
+	delete _output;
+}
+
+void EqualizerOutput::Start()
+{
+	if (_thread != nullptr)
+		throw new std::exception("Equalizer analyzer already started:  EqualizerOutput.cpp");
+
+	_stopping.store(false);
+
+	// MEMORY! ~EqualizerOutput -> Stop
+	_thread = new std::thread(&EqualizerOutput::Loop, this);
+}
+
+void EqualizerOutput::Stop()
+{
+	if (_thread == nullptr)
+		return;
+
+	_stopping.store(true);
+	_thread->join();
+
+	delete _thread;
+	_thread = nullptr;
+}
+
+void EqualizerOutput::AddBlock(const float* left, const float* right, int frameCount)
+{
+	frameCount = std::min(frameCount, AUDIO_BLOCK_SIZE);
+
+	for (int index = 0; index < frameCount; index++)
+	{
+		_tapBlock[2 * index] = left[index];
+		_tapBlock[(2 * index) + 1] = right[index];
+	}
+
+	// (Whole frames, or nothing; so the channels stay interleaved)
+	_tap->PushRange(_tapBlock, 2 * frameCount);
+}
+
+void EqualizerOutput::GetEQ(std::vector<PlaybackFrame>* destination) const
+{
+	if (destination->size() != _outputSize)
+		throw new std::exception("Destination vector for equalizer samples is not the size of the output");
+
+	std::vector<float> bands(2 * _outputSize);
+
+	_output->Read(bands.data());
+
+	for (int index = 0; index < _outputSize; index++)
+	{
+		destination->at(index).SetFrame(bands[index], bands[_outputSize + index]);
+	}
+}
+
+std::vector<PlaybackFrame>* EqualizerOutput::GetEQCopy() const
+{
+	std::vector<PlaybackFrame>* result = new std::vector<PlaybackFrame>(_outputSize);
+
+	this->GetEQ(result);
+
+	return result;
+}
+
+void EqualizerOutput::Loop()
+{
+	while (!_stopping.load())
+	{
+		// (The tap only holds whole frames; so an even number of samples is read)
+		size_t count = _tap->PopRange(_tapRead, 2 * AUDIO_BLOCK_SIZE);
+
+		if (count == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MILLI));
+			continue;
+		}
+
+		for (size_t index = 0; index < count; index += 2)
+		{
+			_leftInput[_cursor] = _window[_cursor] * _tapRead[index];
+			_rightInput[_cursor] = _window[_cursor] * _tapRead[index + 1];
+
+			_cursor++;
+
+			// Ready to perform FFT
+			if (_cursor == _fftPlan->GetSize())
+			{
+				_cursor = 0;
+
+				AddSpectrum(_leftInput, _bands);
+				AddSpectrum(_rightInput, _bands + _outputSize);
+
+				_output->Write(_bands);
+			}
+		}
+	}
+}
+
+void EqualizerOutput::AddSpectrum(const float* input, float* destination)
+{
+	_fftPlan->Forward(input, _binReal, _binImaginary);
+
+	for (int outputIndex = 0; outputIndex < _outputSize; outputIndex++)
+	{
+		float sum = 0;
+
+		for (int binIndex = _bandEdges[outputIndex]; binIndex < _bandEdges[outputIndex + 1]; binIndex++)
+			sum += std::sqrt((_binReal[binIndex] * _binReal[binIndex]) + (_binImaginary[binIndex] * _binImaginary[binIndex]));
+
+		float magnitude = sum / (_bandEdges[outputIndex + 1] - _bandEdges[outputIndex]);
+
+		destination[outputIndex] = std::max(magnitude, RELEASE_COEFFICIENT * destination[outputIndex]);
+	}
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#ifndef FFT_PLAN_H
+#define FFT_PLAN_H
+
+#include <cmath>
+#include <exception>
+#include <numbers>
+
+/// <summary>
+/// Real-input FFT of a fixed (power of 2) size. The twiddle factors, and bit-reversal table, are computed when
+/// the plan is created; and nothing is allocated after that, so the transforms are safe for the audio thread.
+/// The real transform is computed as a complex transform of half the size (even / odd samples packed into the
+/// real / imaginary parts), using an iterative radix-2 transform on split (real / imaginary) arrays; with the
+/// twiddles stored contiguously for each stage, so that the butterfly loops can be vectorized.
+/// </summary>
+class FFTPlan
+{
+public:
+
+	/// <summary>
+	/// Creates the plan for the transform size (power of 2, at least 4)
+	/// </summary>
+	FFTPlan(int size);
+	~FFTPlan();
+
+	FFTPlan(const FFTPlan& copy) = delete;
+	FFTPlan& operator=(const FFTPlan& copy) = delete;
+
+	/// <summary>
+	/// Transform size (real samples)
+	/// </summary>
+	int GetSize() const { return _size; }
+
+	/// <summary>
+	/// Number of frequency bins [0, size / 2] (DC through Nyquist)
+	/// </summary>
+	int GetBinCount() const { return (_size / 2) + 1; }
+
+	/// <summary>
+	/// Forward transform of size real samples into GetBinCount() complex bins (un-scaled)
+	/// </summary>
+	void Forward(const float* input, float* real, float* imaginary);
+
+	/// <summary>
+	/// Inverse transform of GetBinCount() complex bins into size real samples (scaled by 1 / size; so that
+	/// Inverse(Forward(x)) = x)
+	/// </summary>
+	void Inverse(const float* real, const float* imaginary, float* output);
+
+private:
+
+	/// <summary>
+	/// In-place complex transform (half size) of the work buffers
+	/// </summary>
+	void Transform(bool inverse);
+
+private:
+
+	int _size;
+	int _halfSize;
+
+	// Bit-reversed index (half size)
+	int* _bitReverse;
+
+	// Complex transform twiddles:  exp(-2 pi i k / (2 * half)); for each stage (half = 1, 2, 4, ...) stored at
+	//								[half - 1, (2 * half) - 2]
+	float* _twiddleReal;
+	float* _twiddleImaginary;
+
+	// Real transform twiddles:  exp(-2 pi i k / size), k = [0, size / 2]
+	float* _splitReal;
+	float* _splitImaginary;
+
+	// Work buffers (half size)
+	float* _workReal;
+	float* _workImaginary;
+};
+
+FFTPlan::FFTPlan(int size)
+{
+	if (size < 4 || (size & (size - 1)) != 0)
+		throw new std::exception("FFT size must be a power of 2 (at least 4):  FFTPlan.h");
+
+	_size = size;
+	_halfSize = size / 2;
+
+	// MEMORY! ~FFTPlan
+	_bitReverse = new int[_halfSize];
+	_twiddleReal = new float[_halfSize];
+	_twiddleImaginary = new float[_halfSize];
+	_splitReal = new float[_halfSize + 1];
+	_splitImaginary = new float[_halfSize + 1];
+	_workReal = new float[_halfSize];
+	_workImaginary = new float[_halfSize];
+
+	// Bit Reversal
+	int bits = 0;
+
+	while ((1 << bits) < _halfSize)
+		bits++;
+
+	for (int index = 0; index < _halfSize; index++)
+	{
+		int reversed = 0;
+
+		for (int bit = 0; bit < bits; bit++)
+		{
+			if (index & (1 << bit))
+				reversed |= 1 << (bits - 1 - bit);
+		}
+
+		_bitReverse[index] = reversed;
+	}
+
+	// Stage Twiddles
+	for (int half = 1; half < _halfSize; half *= 2)
+	{
+		for (int index = 0; index < half; index++)
+		{
+			double angle = (-std::numbers::pi * index) / half;
+
+			_twiddleReal[half - 1 + index] = (float)std::cos(angle);
+			_twiddleImaginary[half - 1 + index] = (float)std::sin(angle);
+		}
+	}
+
+	// Real Split Twiddles
+	for (int index = 0; index <= _halfSize; index++)
+	{
+		double angle = (-2.0 * std::numbers::pi * index) / _size;
+
+		_splitReal[index] = (float)std::cos(angle);
+		_splitImaginary[index] = (float)std::sin(angle);
+	}
+}
+
+FFTPlan::~FFTPlan()
+{
+	delete[] _bitReverse;
+	delete[] _twiddleReal;
+	delete[] _twiddleImaginary;
+	delete[] _splitReal;
+	delete[] _splitImaginary;
+	delete[] _workReal;
+	delete[] _workImaginary;
+}
+
+void FFTPlan::Forward(const float* input, float* real, float* imaginary)
+{
+	// Pack:  z[n] = x[2n] + i x[2n + 1] (bit-reversed for the transform)
+	for (int index = 0; index < _halfSize; index++)
+	{
+		_workReal[_bitReverse[index]] = input[2 * index];
+		_workImaginary[_bitReverse[index]] = input[(2 * index) + 1];
+	}
+
+	Transform(false);
+
+	// Split:  X[k] = Ze[k] + W^k Zo[k]; where Ze = (Z[k] + Z*[M - k]) / 2, and Zo = (Z[k] - Z*[M - k]) / 2i
+	for (int index = 0; index <= _halfSize; index++)
+	{
+		int forward = index % _halfSize;
+		int backward = (_halfSize - index) % _halfSize;
+
+		float evenReal = 0.5f * (_workReal[forward] + _workReal[backward]);
+		float evenImaginary = 0.5f * (_workImaginary[forward] - _workImaginary[backward]);
+		float oddReal = 0.5f * (_workImaginary[forward] + _workImaginary[backward]);
+		float oddImaginary = -0.5f * (_workReal[forward] - _workReal[backward]);
+
+		real[index] = evenReal + (_splitReal[index] * oddReal) - (_splitImaginary[index] * oddImaginary);
+		imaginary[index] = evenImaginary + (_splitReal[index] * oddImaginary) + (_splitImaginary[index] * oddReal);
+	}
+}
+
+void FFTPlan::Inverse(const float* real, const float* imaginary, float* output)
+{
+	// Un-split:  Ze = (X[k] + X*[M - k]) / 2, Zo = W^-k (X[k] - X*[M - k]) / 2, and Z[k] = Ze + i Zo
+	for (int index = 0; index < _halfSize; index++)
+	{
+		int backward = _halfSize - index;
+
+		float evenReal = 0.5f * (real[index] + real[backward]);
+		float evenImaginary = 0.5f * (imaginary[index] - imaginary[backward]);
+		float differenceReal = 0.5f * (real[index] - real[backward]);
+		float differenceImaginary = 0.5f * (imaginary[index] + imaginary[backward]);
+
+		// (Conjugate twiddle)
+		float oddReal = (differenceReal * _splitReal[index]) + (differenceImaginary * _splitImaginary[index]);
+		float oddImaginary = (differenceImaginary * _splitReal[index]) - (differenceReal * _splitImaginary[index]);
+
+		_workReal[_bitReverse[index]] = evenReal - oddImaginary;
+		_workImaginary[_bitReverse[index]] = evenImaginary + oddReal;
+	}
+
+	Transform(true);
+
+	// Unpack (and scale)
+	float scale = 1.0f / _halfSize;
+
+	for (int index = 0; index < _halfSize; index++)
+	{
+		output[2 * index] = _workReal[index] * scale;
+		output[(2 * index) + 1] = _workImaginary[index] * scale;
+	}
+}
+
+void FFTPlan::Transform(bool inverse)
+{
+	float direction = inverse ? -1.0f : 1.0f;
+
+	// Iterative (decimation in time):  The input is already in bit-reversed order
+	for (int half = 1; half < _halfSize; half *= 2)
+	{
+		const float* twiddleReal = _twiddleReal + half - 1;
+		const float* twiddleImaginary = _twiddleImaginary + half - 1;
+
+		for (int start = 0; start < _halfSize; start += 2 * half)
+		{
+			float* evenReal = _workReal + start;
+			float* evenImaginary = _workImaginary + start;
+			float* oddReal = _workReal + start + half;
+			float* oddImaginary = _workImaginary + start + half;
+
+			// Butterflies
+			for (int index = 0; index < half; index++)
+			{
+				float wReal = twiddleReal[index];
+				float wImaginary = direction * twiddleImaginary[index];
+
+				float tReal = (wReal * oddReal[index]) - (wImaginary * oddImaginary[index]);
+				float tImaginary = (wReal * oddImaginary[index]) + (wImaginary * oddReal[index]);
+
+				oddReal[index] = evenReal[index] - tReal;
+				oddImaginary[index] = evenImaginary[index] - tImaginary;
+				evenReal[index] += tReal;
+				evenImaginary[index] += tImaginary;
+			}
+		}
+	}
+}
+
+#endif
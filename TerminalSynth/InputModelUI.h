@@ -89,6 +89,8 @@ void InputModelUI::From(OscillatorParameters* parameters, Envelope* envelope, Sy
 	noteParameters->chord = _synthNoteParameters->chord;
 	noteParameters->mode = _synthNoteParameters->mode;
 	noteParameters->portamentoSeconds = _synthNoteParameters->portamentoSeconds;
+	noteParameters->polyphony = _synthNoteParameters->polyphony;
+	noteParameters->stealMode = _synthNoteParameters->stealMode;
 }
 void InputModelUI::To(const OscillatorParameters* parameters, const Envelope* envelope, const SynthNoteParameters* noteParameters)
 {
@@ -0,0 +1,122 @@
+#include "KeyboardInput.h"
+#include "NoteEvent.h"
+#include "SpscQueue.h"
+#include "SynthSettings.h"
+#include "WindowsKeyCodes.h"
+#include <Windows.h>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+KeyboardInput::KeyboardInput()
+{
+	// MEMORY! ~KeyboardInput
+	_events = new SpscQueue<NoteEvent>(EVENT_CAPACITY);
+	_keyMap = new std::map<int, int>();
+	_thread = nullptr;
+	_stopping.store(false);
+
+	for (int index = 0; index < KEY_CODE_COUNT; index++)
+		_heldNotes[index] = -1;
+}
+
+KeyboardInput::~KeyboardInput()
+{
+	if (_thread != nullptr)
+		this->Stop();
+
+	delete _events;
+	delete _keyMap;
+}
+
+void KeyboardInput::Start(const SynthSettings* configuration)
+{
+	if (_thread != nullptr)
+		throw new std::exception("Keyboard input already started:  KeyboardInput.cpp");
+
+	this->UpdateKeyMap(configuration);
+
+	_stopping.store(false);
+
+	// MEMORY! ~KeyboardInput -> Stop
+	_thread = new std::thread(&KeyboardInput::Loop, this);
+}
+
+void KeyboardInput::Stop()
+{
+	if (_thread == nullptr)
+		return;
+
+	_stopping.store(true);
+	_thread->join();
+
+	delete _thread;
+	_thread = nullptr;
+}
+
+void KeyboardInput::UpdateKeyMap(const SynthSettings* configuration)
+{
+	std::lock_guard<std::mutex> lock(_keyMapMutex);
+
+	_keyMap->clear();
+
+	for (int keyCode = (int)WindowsKeyCodes::NUMBER_0; keyCode <= (int)WindowsKeyCodes::PERIOD; keyCode++)
+	{
+		// Check that enum is defined
+		if (keyCode < 0x30 ||
+			keyCode == 0x40 ||
+			(keyCode > 0x5A && keyCode < 0x80) ||
+			(keyCode > 0x80 && keyCode < 0xBB) ||
+			(keyCode > 0xBF && keyCode < 0xDB) ||
+			(keyCode > 0xDE))
+			continue;
+
+		// Check Configuration
+		if (!configuration->HasMidiNote((WindowsKeyCodes)keyCode))
+			continue;
+
+		_keyMap->insert(std::make_pair(keyCode, configuration->GetMidiNote((WindowsKeyCodes)keyCode)));
+	}
+}
+
+void KeyboardInput::Loop()
+{
+	while (!_stopping.load())
+	{
+		{
+			std::lock_guard<std::mutex> lock(_keyMapMutex);
+
+			for (int keyCode = 0; keyCode < KEY_CODE_COUNT; keyCode++)
+			{
+				int heldNote = _heldNotes[keyCode];
+				int midiNumber = _keyMap->contains(keyCode) ? _keyMap->at(keyCode) : -1;
+
+				// Pressed (only mapped keys)
+				bool isPressed = midiNumber >= 0 && (GetAsyncKeyState(keyCode) & 0x8000);
+				double timestamp = NoteEvent::Clock();
+
+				// Released (or re-mapped):  The held state is only changed once the event is queued; so a full
+				//							 queue is retried on the next poll.
+				if (heldNote >= 0 && (!isPressed || heldNote != midiNumber))
+				{
+					if (!_events->Push(NoteEvent{ .midiNumber = heldNote, .velocity = 0.0f, .noteOn = false, .timestamp = timestamp }))
+						continue;
+
+					_heldNotes[keyCode] = -1;
+				}
+
+				// Pressed
+				if (isPressed && _heldNotes[keyCode] < 0)
+				{
+					if (_events->Push(NoteEvent{ .midiNumber = midiNumber, .velocity = 1.0f, .noteOn = true, .timestamp = timestamp }))
+						_heldNotes[keyCode] = midiNumber;
+				}
+			}
+		}
+
+		std::this_thread::sleep_for(std::chrono::microseconds(POLL_INTERVAL_MICRO));
+	}
+}
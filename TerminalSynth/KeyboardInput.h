@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef KEYBOARD_INPUT_H
+#define KEYBOARD_INPUT_H
+
+#include "NoteEvent.h"
+#include "SpscQueue.h"
+#include "SynthSettings.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+/// <summary>
+/// Polls the computer keyboard on its own thread; and pushes timestamped NoteEvent's into a wait-free queue for
+/// the audio thread. This keeps the key scan off of the audio thread; and lets the audio thread place each note
+/// at a frame offset, instead of at the start of the next buffer.
+/// </summary>
+class KeyboardInput
+{
+public:
+
+	KeyboardInput();
+	~KeyboardInput();
+
+	/// <summary>
+	/// Starts the input thread with the key map from the settings
+	/// </summary>
+	void Start(const SynthSettings* configuration);
+
+	/// <summary>
+	/// Stops the input thread
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// (UI Thread) Copies the key map from the settings. Held keys are released if their note has changed.
+	/// </summary>
+	void UpdateKeyMap(const SynthSettings* configuration);
+
+	/// <summary>
+	/// (Audio Thread) Queue of note events (the audio thread is the only consumer)
+	/// </summary>
+	SpscQueue<NoteEvent>* GetEvents() const { return _events; }
+
+private:
+
+	void Loop();
+
+private:
+
+	static const int EVENT_CAPACITY = 256;
+	static const int KEY_CODE_COUNT = 256;
+	static const int POLL_INTERVAL_MICRO = 500;
+
+	SpscQueue<NoteEvent>* _events;
+
+	// Key Code -> Midi Number (protected by the key map mutex)
+	std::map<int, int>* _keyMap;
+	std::mutex _keyMapMutex;
+
+	// Input Thread:  Midi number of each held key (or -1)
+	int _heldNotes[KEY_CODE_COUNT];
+
+	std::thread* _thread;
+	std::atomic<bool> _stopping;
+};
+
+#endif
@@ -100,8 +100,12 @@ void MainController::Start()
 
 bool MainController::Dispose()
 {
+	// Audio Thread:  The stream must be stopped (and closed) before the playback controller's threads, and devices,
+	//				  are disposed. (The callback would still be using them)
+	bool success = _audioController->Dispose();
+
 	// Stops UI thread
-	return _playbackController->Dispose() && _audioController->Dispose();
+	return _playbackController->Dispose() && success;
 }
 
 void MainController::Loop()
@@ -143,8 +147,8 @@ void MainController::Loop()
 		//				the audio thread. So, updating won't be very costly, or disruptive to
 		//				playback. 
 		// 
-		//				The shared pointer PlaybackUserData* may be synchronized through the 
-		//				AtomicLock* (see below, and on AudioController* playback)
+		//				The SynthSettings* are handed to the audio thread as immutable snapshots
+		//				(see PlaybackUserData::PublishSynthSettings), so playback never waits on the UI.
 		// 
 		//				The settings have been copied off to the UI portion and can be used
 		//				outside of the lock. The settings are propagated using the UIBase* 
@@ -155,7 +159,7 @@ void MainController::Loop()
 		// 1) Allow one of our UIBase::Tick cycles to process
 		// 2) Check for servicing of UI components
 		// 3) After service flags have cleared, use UpdateComponent to prepare UI for rendering (and data collection)
-		// 4) (CRITICAL SECTION) Process data collection entering the critical section (FromUI)
+		// 4) Process data collection (FromUI); and publish a settings snapshot for playback
 		// 5) Allow one cycle of the FTXUI loop to tick (after our preparation)
 		// 6) Sleep the UI thread to comprise approx 10ms - 15ms (using a interval timer if necessary)
 		//
@@ -185,28 +189,24 @@ void MainController::Loop()
 
 		if (uiDirty)
 		{
-			// ~ CRITICAL SECTION ~ (Playback must synchronize here!)
-			_uiLockAcquireTimer->Reset();
-			this->PlaybackLock->AcquireLock();
-			_uiLockAcquireTimer->Mark();
-
 			_uiDataFetchTimer->Reset();
 
-			// UI -> Model -> Configuration
+			// UI -> Model -> Configuration (The SynthSettings* is owned by the UI thread)
 			_mainUI->FromUI(_mainModelUI);
 			_mainModelUI->FromUI(_userData->GetSynthSettings());	
 
 			_uiDataFetchTimer->Mark();
 
-			// -> Forward dirty status to AudioController
-			_userData->GetSynthSettings()->SetDirty();
+			// -> Publish a snapshot for the audio thread (no lock is shared with playback)
+			_uiLockAcquireTimer->Reset();
+			_userData->PublishSynthSettings();
+			_uiLockAcquireTimer->Mark();
 
-			this->PlaybackLock->Release();
+			// -> Voice / effect chain changes are built off the audio thread
+			_playbackController->RequestSynthBuild(_userData->GetSynthSettings());
 
-			// ~ END ~
-			//
-			// Dirty status has been forwarded to the SynthSettings* (see IsDirty)
-			//
+			// -> Key map for the keyboard input thread
+			_playbackController->UpdateKeyMap(_userData->GetSynthSettings());
 		}
 
 		// DEVICE CHANGE! (PlaybackInfo* was set for a new device)
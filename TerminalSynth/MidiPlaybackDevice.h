@@ -3,6 +3,8 @@
 #ifndef MIDI_PLAYBACK_DEVICE_H
 #define MIDI_PLAYBACK_DEVICE_H
 
+#include "AudioBlock.h"
+#include "BlockEventSchedule.h"
 #include "MidiEvent.h"
 #include "MidiEventList.h"
 #include "MidiFile.h"
@@ -11,10 +13,17 @@
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "SoundRegistry.h"
+#include "SpscQueue.h"
 #include "Synth.h"
+#include "SynthChainEdit.h"
 #include "SynthSettings.h"
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <exception>
 #include <string>
+#include <vector>
 
 class MidiPlaybackDevice : public PlaybackDevice
 {
@@ -25,68 +34,109 @@ public:
 
 	bool Initialize(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters) override;
 	bool Update(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters) override;
+	Synth* SwapSynth(Synth* synth, const PlaybackTime& playbackTime, const SynthSettings* configuration) override;
+	Synth* TakeFadedSynth() override;
+	bool AdoptChains(SynthChainEdit* chainEdit, const PlaybackTime& playbackTime) override;
 	bool SetForFrame(const PlaybackTime& playbackTime, const SynthSettings* configuration) override;
 	bool WriteSample(PlaybackFrame& playbackFrame, const PlaybackTime& playbackTime, float gain, float leftRightBalance) override;
+	bool WriteBlock(AudioBlock* block, const PlaybackTime& playbackTime, int frameCount, float gain, float leftRightBalance) override;
 
 	/// <summary>
-	/// Loads midi file and creates playback configuration
+	/// (UI Thread) Loads midi file; and compiles it into a single (time-sorted) event timeline. The timeline is handed
+	/// to the audio thread; and playback starts on the next block (see SetForFrame).
 	/// </summary>
 	bool Load(const std::string& fileName);
 
 	/// <summary>
-	/// Returns average output for specified channel from the last frame buffer write
+	/// (UI Thread) Compiles the (loaded, or generated) midi file into the event timeline; and hands it to the audio
+	/// thread. Playback starts on the next block. Returns false if the audio thread has not taken the previous loads.
+	/// </summary>
+	bool Load(smf::MidiFile& midiFile);
+
+	/// <summary>
+	/// Returns average output (absolute level) for specified channel (0 = left, 1 = right) from the last block write
 	/// </summary>
 	float GetOutput(int channelIndex) const;
 
 private:
 
 	/// <summary>
-	/// Callback function to aid in repetative midi iteration. The current time is the stream time + any
-	/// other midi-related time precalculated for the midi event. 
+	/// Compact (8 byte) note event, stamped with the frame (from the start of the song). The frame is computed
+	/// from the tempo map when the file is loaded.
 	/// </summary>
-	using MidiSynthEventCallback = std::function<void(double currentTime, const smf::MidiEvent& midiEvent)>;
+	struct MidiTimelineEvent
+	{
+		uint32_t frame;
+		uint8_t midiNumber;
+		uint8_t velocity;
+		uint8_t channel;
+		bool noteOn;
+	};
 
 	/// <summary>
-	/// Sets synth for midi playback for the given frame
+	/// Moves the timeline events, up to (not including) the end frame cursor, into the block schedule
 	/// </summary>
-	/// <param name="currentStreamTime">Current stream time for the current frame</param>
-	/// <param name="currentFrameIndex">Current frame index for writing the buffer</param>
-	/// <param name="configuration">Synth configuration for playback</param>
-	void SetMidiSynth(double currentStreamTime, int currentFrameIndex, const SynthSettings* configuration);
+	void ScheduleEvents(size_t endFrameCursor);
 
 	/// <summary>
-	/// Iterator for midi event stream
+	/// (Audio Thread) Swaps in the latest loaded timeline (if any); and releases the notes held by the previous song.
+	/// The previous timeline is handed back to be deleted off the audio thread (see DeleteRetired).
 	/// </summary>
-	/// <param name="currentStreamTime">Current stream time for the current frame</param>
-	/// <param name="currentFrameIndex">Current frame index for writing the buffer</param>
-	/// <param name="callback">Midi event callback that will contain the midi event for the specified time</param>
-	void IterateMidiStream(double currentStreamTime, int currentFrameIndex, MidiSynthEventCallback callback);
+	void AdoptTimeline(const PlaybackTime& playbackTime);
+
+	/// <summary>
+	/// (UI Thread) Deletes the timelines that the audio thread has finished with
+	/// </summary>
+	void DeleteRetired();
 
 private:
 
-	smf::MidiFile* _midiFile;
-	double _midiSecondsPerTick;					// This is in terms of MIDI ticks (using smf to calculate these during load)
-	double _streamStartTime;
+	static const int SCHEDULE_CAPACITY = 1024;
+	static const int TIMELINE_QUEUE_CAPACITY = 4;
+
+	// Compiled on Load (all tracks); and swapped in by the audio thread
+	std::vector<MidiTimelineEvent>* _timeline;
+
+	// Timeline hand-off:  Loaded timelines (UI -> audio thread); and replaced timelines (audio -> UI thread)
+	SpscQueue<std::vector<MidiTimelineEvent>*>* _pendingTimelines;
+	SpscQueue<std::vector<MidiTimelineEvent>*>* _retiredTimelines;
+
+	// Next timeline event; and the stream frame that the song started on
+	size_t _timelineCursor;
+	size_t _songStartCursor;
+	bool _songStarted;
+
+	// Events for the current block (pre-allocated)
+	BlockEventSchedule* _events;
 
 	Synth* _synth;
-	PlaybackFrame* _frame;
 	unsigned int _numberOfChannels;
 	unsigned int _samplingRate;
 
 	bool _isLoaded;
 	bool _lastOutput;
+
+	// Average (absolute) level of each channel for the last block (see GetOutput)
+	std::atomic<float> _output[2];
 	bool _initialized;
 };
 
 MidiPlaybackDevice::MidiPlaybackDevice()
 {
-	_midiFile = nullptr;
-	_midiSecondsPerTick = 0;
-	_streamStartTime = 0;
-	_lastOutput = false;	
+	_timeline = new std::vector<MidiTimelineEvent>();
+
+	// MEMORY! ~MidiPlaybackDevice
+	_pendingTimelines = new SpscQueue<std::vector<MidiTimelineEvent>*>(TIMELINE_QUEUE_CAPACITY);
+	_retiredTimelines = new SpscQueue<std::vector<MidiTimelineEvent>*>(TIMELINE_QUEUE_CAPACITY);
+	_timelineCursor = 0;
+	_songStartCursor = 0;
+	_songStarted = false;
+	_events = new BlockEventSchedule(SCHEDULE_CAPACITY);
+	_lastOutput = false;
+	_output[0].store(0);
+	_output[1].store(0);	
 	_numberOfChannels = 0;
 	_samplingRate = 0;
-	_frame = nullptr;
 	_synth = nullptr;
 	_isLoaded = false;
 	_initialized = false;
@@ -94,8 +144,19 @@ MidiPlaybackDevice::MidiPlaybackDevice()
 
 MidiPlaybackDevice::~MidiPlaybackDevice()
 {
+	std::vector<MidiTimelineEvent>* timeline = nullptr;
+
+	// (The audio stream is stopped) Loaded timelines that were never played
+	while (_pendingTimelines->Pop(timeline))
+		delete timeline;
+
+	DeleteRetired();
+
 	delete _synth;
-	delete _frame;
+	delete _timeline;
+	delete _events;
+	delete _pendingTimelines;
+	delete _retiredTimelines;
 }
 
 bool MidiPlaybackDevice::Initialize(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters)
@@ -104,7 +165,6 @@ bool MidiPlaybackDevice::Initialize(SoundRegistry* effectRegistry, const SynthSe
 	_samplingRate = parameters->GetStreamInfo()->streamSampleRate;
 
 	_synth = new Synth(configuration, _numberOfChannels, _samplingRate);
-	_frame = new PlaybackFrame();
 
 	_synth->Initialize(effectRegistry, configuration, parameters);
 
@@ -120,141 +180,232 @@ bool MidiPlaybackDevice::Update(SoundRegistry* effectRegistry, const SynthSettin
 	return true;
 }
 
+Synth* MidiPlaybackDevice::SwapSynth(Synth* synth, const PlaybackTime& playbackTime, const SynthSettings* configuration)
+{
+	Synth* previous = _synth;
+
+	_synth = synth;
+
+	// Sounding notes are continued by the new synth; and the previous one is crossfaded out (see Synth::Adopt)
+	if (previous == nullptr)
+		return nullptr;
+
+	return _synth->Adopt(previous, &playbackTime);
+}
+
+Synth* MidiPlaybackDevice::TakeFadedSynth()
+{
+	return _synth->TakeFadedSynth();
+}
+
+bool MidiPlaybackDevice::AdoptChains(SynthChainEdit* chainEdit, const PlaybackTime& playbackTime)
+{
+	return _synth->AdoptChains(chainEdit, &playbackTime);
+}
+
 bool MidiPlaybackDevice::SetForFrame(const PlaybackTime& playbackTime, const SynthSettings* configuration)
 {
-	bool newPlayback = false;
+	// New Song:  (see Load)
+	AdoptTimeline(playbackTime);
+
+	if (!_isLoaded)
+		return false;
+
+	// Song starts on the first block after loading
+	if (!_songStarted)
+	{
+		_songStartCursor = playbackTime.frameCursor;
+		_songStarted = true;
+	}
+
+	return _timelineCursor < _timeline->size();
+}
+
+void MidiPlaybackDevice::AdoptTimeline(const PlaybackTime& playbackTime)
+{
+	std::vector<MidiTimelineEvent>* latest = nullptr;
+	std::vector<MidiTimelineEvent>* timeline = nullptr;
 
-	//for (int currentFrameIndex = 0; currentFrameIndex < numberOfFrames; currentFrameIndex++)
-	//{
-	//	// Current Stream Time
-	//	double currentStreamTime = streamTime + (currentFrameIndex / (double)_samplingRate);
+	while (_pendingTimelines->Pop(timeline))
+	{
+		// Superseded loads go straight back (the retired queue has room for every pending timeline)
+		if (latest != nullptr)
+			_retiredTimelines->Push(latest);
 
-	//	this->IterateMidiStream(currentStreamTime, currentFrameIndex, [&newPlayback](double currentTime, const smf::MidiEvent& midiEvent) {
+		latest = timeline;
+	}
 
-	//		// Note On
-	//		if (midiEvent.isNoteOn())
-	//		{
-	//			newPlayback = true;
-	//			return;
-	//		}
-	//	});
-	//}
+	if (latest == nullptr)
+		return;
 
-	return newPlayback;
+	// The retired queue is drained on each load; so this only fails if the previous timeline was never taken back
+	if (!_retiredTimelines->Push(_timeline))
+	{
+		_pendingTimelines->Push(latest);
+		return;
+	}
+
+	// Note offs for the previous song (its remaining events are dropped)
+	_synth->ReleaseNotes(&playbackTime);
+
+	_timeline = latest;
+	_timelineCursor = 0;
+	_songStarted = false;
+	_events->Clear();
+	_isLoaded = true;
 }
 
-void MidiPlaybackDevice::SetMidiSynth(double currentStreamTime, int currentFrameIndex, const SynthSettings* configuration)
+void MidiPlaybackDevice::ScheduleEvents(size_t endFrameCursor)
 {
-	Synth* synth = _synth;
+	// Timeline Cursor:  Only the events inside of the block are visited; so the cost per block does not
+	//					 depend on the length of the song, or the number of tracks.
+	//
+	while (_timelineCursor < _timeline->size())
+	{
+		const MidiTimelineEvent& timelineEvent = _timeline->at(_timelineCursor);
 
-	this->IterateMidiStream(currentStreamTime, currentFrameIndex, [&synth, &configuration](double currentTime, const smf::MidiEvent& midiEvent) {
+		size_t frameCursor = _songStartCursor + timelineEvent.frame;
 
-		// Note On
-		if (midiEvent.isNoteOn())
-		{
-			//synth->SetNote(midiEvent.getKeyNumber(), true, currentTime);
-		}
+		if (frameCursor >= endFrameCursor)
+			break;
 
-		// Note Off
-		else if (midiEvent.isNoteOff())
-		{
-			//synth->SetNote(midiEvent.getKeyNumber(), false, currentTime);
-		}
-	});
+		BlockEvent blockEvent{
+			.type = timelineEvent.noteOn ? BlockEventType::NoteOn : BlockEventType::NoteOff,
+			.midiNumber = timelineEvent.midiNumber,
+			.velocity = timelineEvent.velocity / 127.0f,
+			.frameCursor = frameCursor
+		};
+
+		// (Schedule is full:  The rest are applied next block)
+		if (!_events->Add(blockEvent))
+			break;
+
+		_timelineCursor++;
+	}
 }
 
 bool MidiPlaybackDevice::WriteSample(PlaybackFrame& playbackFrame, const PlaybackTime& playbackTime, float gain, float leftRightBalance)
 {
 	if (!_initialized)
-		return -1;
+		return false;
 
-	// Procedure
-	//
-	// 0) Update synth configuration
-	// 1) Calculate the next batch of midi events; and which frames match the 
-	//	  current frame index.
-	// 2) Align the midi / stream times
-	// 
-	// Produce the playback buffer from the synth in a loop over the stream's 
-	// frame index, looking for MIDI events that are in the file.
-	//
+	if (!_isLoaded || !_songStarted)
+		return _synth->GetSample(&playbackFrame, &playbackTime, gain, leftRightBalance);
+
+	// Single frame block
+	ScheduleEvents(playbackTime.frameCursor + 1);
 
-	//char* outputBuffer = (char*)playbackBuffer;
+	while (_events->IsDue(playbackTime.frameCursor))
+	{
+		const BlockEvent& blockEvent = _events->Next();
+
+		_synth->SetNote(blockEvent.midiNumber, blockEvent.type == BlockEventType::NoteOn, &playbackTime);
+	}
 
-	//// Calculate frame data (BUFFER SIZE = NUMBER OF CHANNELS x NUMBER OF FRAMES)
-	//for (unsigned int frameIndex = 0; frameIndex < numberOfFrames; frameIndex++)
-	//{
-	//	double absoluteTime = streamTime + (frameIndex / (double)_samplingRate);
+	return _synth->GetSample(&playbackFrame, &playbackTime, gain, leftRightBalance);
+}
 
-	//	// Set Synth Midi Events
-	//	//this->SetMidiSynth(absoluteTime, frameIndex, configuration);
+bool MidiPlaybackDevice::WriteBlock(AudioBlock* block, const PlaybackTime& playbackTime, int frameCount, float gain, float leftRightBalance)
+{
+	if (!_initialized)
+		return false;
+
+	if (_isLoaded && _songStarted)
+		ScheduleEvents(playbackTime.frameCursor + frameCount);
+
+	// Events are applied on their exact frame (see Synth::ProcessBlock)
+	_lastOutput = _synth->ProcessBlock(block, &playbackTime, frameCount, gain, leftRightBalance, _events);
+
+	// Output Level
+	const float* left = block->GetLeft();
+	const float* right = block->GetRightSignal();
+	float sumLeft = 0;
+	float sumRight = 0;
+
+	for (int index = 0; index < frameCount; index++)
+	{
+		sumLeft += std::fabs(left[index]);
+		sumRight += std::fabs(right[index]);
+	}
 
-	//	// Clear Frame
-	//	_frame->ClearSample();
+	_output[0].store(frameCount > 0 ? sumLeft / frameCount : 0);
+	_output[1].store(frameCount > 0 ? sumRight / frameCount : 0);
 
-	//	// Get Samples for N channels
-	//	_lastOutput = _synth->GetSample(_frame, gain, leftRightBalance);
+	return _lastOutput;
+}
 
-	//	// Equalizer Output
-	//	equalizerOutput->AddSample(_frame->GetLeft(), _frame->GetRight());
+bool MidiPlaybackDevice::Load(const std::string& fileName)
+{
+	smf::MidiFile midiFile(fileName);
 
-	//	// Interleved frames
-	//	// 
-	//	// Set output sample
-	//	outputBuffer[(2 * frameIndex)] = _frame->GetLeft();
-	//	outputBuffer[(2 * frameIndex) + 1] = _frame->GetRight();
-	//}
+	if (!midiFile.status())
+		return false;
 
-	return 0;
+	return this->Load(midiFile);
 }
-void MidiPlaybackDevice::IterateMidiStream(double currentStreamTime, int currentFrameIndex, MidiSynthEventCallback callback)
+
+bool MidiPlaybackDevice::Load(smf::MidiFile& midiFile)
 {
-	// This will calculate the delta-time involved with the previous frame call
-	double lastStreamTime = currentFrameIndex == 0 ? currentStreamTime : (currentStreamTime + ((currentFrameIndex - 1) / (double)_samplingRate));
+	DeleteRetired();
 
-	int startTick = lastStreamTime / _midiSecondsPerTick;
-	int endTick = currentStreamTime / _midiSecondsPerTick;
+	// Tempo Map:  Calculates MidiEvent::seconds for every event (ticks are left absolute)
+	midiFile.doTimeAnalysis();
 
-	for (int tick = startTick; tick <= endTick; tick++)
-	{
-		// Current time in terms of the playback stream
-		float currentTime = currentStreamTime + (_midiSecondsPerTick * (tick - startTick));
+	// MEMORY! ~MidiPlaybackDevice -> AdoptTimeline -> DeleteRetired
+	std::vector<MidiTimelineEvent>* timeline = new std::vector<MidiTimelineEvent>();
 
-		for (int trackIndex = 0; trackIndex < _midiFile->getTrackCount(); trackIndex++)
+	for (int trackIndex = 0; trackIndex < midiFile.getTrackCount(); trackIndex++)
+	{
+		for (int eventIndex = 0; eventIndex < midiFile[trackIndex].size(); eventIndex++)
 		{
-			if (tick >= _midiFile[trackIndex].size())
-				continue;
+			const smf::MidiEvent& midiEvent = midiFile[trackIndex][eventIndex];
 
-			smf::MidiEventList midiEvents = _midiFile[trackIndex][tick];
+			if (!midiEvent.isNoteOn() && !midiEvent.isNoteOff())
+				continue;
 
-			for (int midiEventIndex = 0; midiEventIndex < midiEvents.size(); midiEventIndex++)
-			{
-				// Callback:  Current Stream Time, Midi Event
-				callback(currentTime, midiEvents[midiEventIndex]);
-			}
+			timeline->push_back(MidiTimelineEvent{
+				.frame = (uint32_t)(midiEvent.seconds * _samplingRate + 0.5),
+				.midiNumber = (uint8_t)midiEvent.getKeyNumber(),
+				.velocity = (uint8_t)midiEvent.getVelocity(),
+				.channel = (uint8_t)midiEvent.getChannel(),
+				.noteOn = midiEvent.isNoteOn()
+			});
 		}
 	}
-}
 
-bool MidiPlaybackDevice::Load(const std::string& fileName)
-{
-	_midiFile = new smf::MidiFile(fileName);
+	// Merge the tracks (note off's first, for repeated notes on the same frame)
+	std::stable_sort(timeline->begin(), timeline->end(), [](const MidiTimelineEvent& event1, const MidiTimelineEvent& event2) {
 
-	// Set "absolute ticks mode"
-	_midiFile->absoluteTicks();
+		if (event1.frame != event2.frame)
+			return event1.frame < event2.frame;
 
-	// Finally, try merging tracks to create a single-track song
-	// midiFile.joinTracks();
+		return !event1.noteOn && event2.noteOn;
+	});
 
-	_midiSecondsPerTick = _midiFile->getFileDurationInSeconds() / _midiFile->getFileDurationInTicks();
-	_isLoaded = true;
+	// Audio Thread:  The timeline is swapped in on the next block (see AdoptTimeline)
+	if (!_pendingTimelines->Push(timeline))
+	{
+		delete timeline;
+		return false;
+	}
 
-	return _isLoaded;
+	return true;
+}
+
+void MidiPlaybackDevice::DeleteRetired()
+{
+	std::vector<MidiTimelineEvent>* timeline = nullptr;
+
+	while (_retiredTimelines->Pop(timeline))
+		delete timeline;
 }
 
 float MidiPlaybackDevice::GetOutput(int channelIndex) const
 {
-	return 0;
+	if (channelIndex < 0 || channelIndex > 1)
+		throw new std::exception("Invalid channel index:  MidiPlaybackDevice.h");
+
+	return _output[channelIndex].load();
 }
 
 #endif
\ No newline at end of file
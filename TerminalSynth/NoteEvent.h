@@ -0,0 +1,32 @@
+#pragma once
+
+#ifndef NOTE_EVENT_H
+#define NOTE_EVENT_H
+
+#include <chrono>
+
+/// <summary>
+/// Note on / off event, timestamped by the input thread. The audio thread converts the timestamp to a frame
+/// offset inside of the output buffer.
+/// </summary>
+struct NoteEvent
+{
+	int midiNumber;
+	float velocity;
+	bool noteOn;
+
+	/// <summary>
+	/// Time of the event (in seconds) on the NoteEvent::Clock()
+	/// </summary>
+	double timestamp;
+
+	/// <summary>
+	/// Shared (monotonic) clock for the input thread, and the audio thread
+	/// </summary>
+	static double Clock()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+};
+
+#endif
@@ -0,0 +1,241 @@
+#include "AtomicLock.h"
+#include "AudioController.h"
+#include "Constant.h"
+#include "NullAudioController.h"
+#include "PlaybackUserData.h"
+#include "SoundFileWriter.h"
+#include <chrono>
+#include <exception>
+#include <random>
+#include <string>
+#include <thread>
+
+NullAudioController::NullAudioController(AtomicLock* playbackLock,
+										 unsigned int samplingRate,
+										 unsigned int bufferFrameSize,
+										 NullAudioPacing pacing,
+										 float jitterMilli,
+										 const std::string& outputFileName) : AudioController(playbackLock)
+{
+	_audioCallback = nullptr;
+	_userData = nullptr;
+	_writer = nullptr;
+	_outputFileName = new std::string(outputFileName);
+	_outputBuffer = new float[2 * bufferFrameSize];
+	_thread = nullptr;
+	_running.store(false);
+	_samplingRate = samplingRate;
+	_bufferFrameSize = bufferFrameSize;
+	_pacing = pacing;
+	_jitterMilli = jitterMilli;
+	_callbackCount.store(0);
+	_deadlineMisses.store(0);
+	_maxCallbackMilli.store(0);
+	_streamOpen = false;
+	_initialized = false;
+}
+
+NullAudioController::~NullAudioController()
+{
+	if (_initialized)
+		this->Dispose();
+
+	delete _outputFileName;
+	delete[] _outputBuffer;
+}
+
+bool NullAudioController::Initialize(PlaybackUserData* playbackData, const AudioCallbackDelegate& audioCallback)
+{
+	if (_initialized)
+		throw new std::exception("Null Audio Controller already initialzed! Must call Dispose() before re-initializing the backend");
+
+	_audioCallback = new AudioCallbackDelegate(audioCallback);
+
+	// Host API
+	playbackData->GetPlaybackInfo()->SetForHostApi("Null Audio");
+
+	// Virtual Output Device
+	playbackData->GetDeviceRegister()->AddDevice(0, "Float 32 bit", std::string(DEVICE_NAME) + "\n", DEVICE_NAME, AudioStreamFormat::Float32, _samplingRate, 2, _bufferFrameSize, _bufferFrameSize / (float)_samplingRate, true);
+
+	_initialized = true;
+
+	return _initialized;
+}
+
+void NullAudioController::Start()
+{
+	// Nothing to do (see StartStream)
+}
+
+bool NullAudioController::Dispose()
+{
+	if (!_initialized)
+		throw new std::exception("Null Audio Controller not initialzed! Must call Initialize() before disposing the stream");
+
+	if (this->IsStreamRunning())
+		this->StopStream();
+
+	if (this->IsStreamOpen())
+		this->CloseStream();
+
+	delete _audioCallback;
+
+	_audioCallback = nullptr;
+	_initialized = false;
+
+	return true;
+}
+
+bool NullAudioController::OpenStream(PlaybackUserData* userData)
+{
+	if (!_initialized)
+		throw new std::exception("Null Audio Controller not initialzed! Must call Initialize() before opening the stream");
+
+	_userData = userData;
+
+	userData->UpdateDevice(DEVICE_NAME, _samplingRate, _bufferFrameSize, true);
+
+	userData->GetPlaybackInfo()->GetStreamInfo()->streamActualLatency = _bufferFrameSize / (float)_samplingRate;
+	userData->GetPlaybackInfo()->GetStreamInfo()->streamSampleRate = _samplingRate;
+
+	// Output File (otherwise, the output is discarded)
+	if (!_outputFileName->empty())
+	{
+		// MEMORY! ~NullAudioController -> CloseStream
+		_writer = new SoundFileWriter(*_outputFileName, _samplingRate);
+
+		if (!_writer->Open())
+		{
+			delete _writer;
+			_writer = nullptr;
+
+			return false;
+		}
+	}
+
+	_streamOpen = true;
+
+	return true;
+}
+
+bool NullAudioController::CloseStream()
+{
+	if (!this->IsStreamOpen())
+		throw new std::exception("Null Audio Controller stream not open! Must call OpenStream() to open the stream");
+
+	if (_writer != nullptr)
+	{
+		_writer->Close();
+
+		delete _writer;
+		_writer = nullptr;
+	}
+
+	_streamOpen = false;
+
+	return true;
+}
+
+bool NullAudioController::StartStream()
+{
+	if (this->IsStreamRunning())
+		throw new std::exception("Null Audio Controller stream already running!");
+
+	if (!this->IsStreamOpen())
+		throw new std::exception("Null Audio Controller stream not open! Must call OpenStream() to open the stream");
+
+	_callbackCount.store(0);
+	_deadlineMisses.store(0);
+	_maxCallbackMilli.store(0);
+	_running.store(true);
+
+	// MEMORY! ~NullAudioController -> StopStream
+	_thread = new std::thread(&NullAudioController::Loop, this);
+
+	return true;
+}
+
+bool NullAudioController::StopStream()
+{
+	if (!this->IsStreamRunning())
+		throw new std::exception("Null Audio Controller stream already stopped!");
+
+	_running.store(false);
+	_thread->join();
+
+	delete _thread;
+	_thread = nullptr;
+
+	return true;
+}
+
+bool NullAudioController::IsStreamOpen()
+{
+	return _streamOpen;
+}
+
+bool NullAudioController::IsStreamRunning()
+{
+	return _thread != nullptr;
+}
+
+void NullAudioController::Loop()
+{
+	using clock = std::chrono::steady_clock;
+
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<double> jitter(0, _jitterMilli);
+
+	auto bufferDuration = std::chrono::duration<double>(_bufferFrameSize / (double)_samplingRate);
+	auto streamStart = clock::now();
+
+	long long frameCursor = 0;
+	long long bufferIndex = 0;
+
+	while (_running.load())
+	{
+		// Device Clock:  Buffer N is requested at (N x buffer duration); and must be finished one buffer later
+		auto requestTime = streamStart + std::chrono::duration_cast<clock::duration>(bufferDuration * bufferIndex);
+		auto deadline = requestTime + std::chrono::duration_cast<clock::duration>(bufferDuration);
+
+		switch (_pacing)
+		{
+		case NullAudioPacing::RealTime:
+			std::this_thread::sleep_until(requestTime);
+			break;
+		case NullAudioPacing::Jittered:
+			std::this_thread::sleep_until(requestTime + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::milli>(jitter(generator))));
+			break;
+		case NullAudioPacing::AsFastAsPossible:
+			break;
+		default:
+			throw new std::exception("Unhandled null audio pacing:  NullAudioController.cpp");
+		}
+
+		auto callbackStart = clock::now();
+
+		(*_audioCallback)(_outputBuffer, AudioStreamFormat::Float32, _bufferFrameSize, frameCursor / (double)_samplingRate, 0, _userData);
+
+		auto callbackEnd = clock::now();
+
+		if (_writer != nullptr)
+			_writer->Write(_outputBuffer, _bufferFrameSize);
+
+		// Metrics:  (As fast as possible) The deadline is the buffer duration from the start of the callback
+		double callbackMilli = std::chrono::duration<double, std::milli>(callbackEnd - callbackStart).count();
+
+		if (_pacing == NullAudioPacing::AsFastAsPossible)
+			deadline = callbackStart + std::chrono::duration_cast<clock::duration>(bufferDuration);
+
+		if (callbackEnd > deadline)
+			_deadlineMisses++;
+
+		if (callbackMilli > _maxCallbackMilli.load())
+			_maxCallbackMilli.store(callbackMilli);
+
+		_callbackCount++;
+
+		frameCursor += _bufferFrameSize;
+		bufferIndex++;
+	}
+}
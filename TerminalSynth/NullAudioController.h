@@ -0,0 +1,120 @@
+#pragma once
+
+#ifndef NULL_AUDIO_CONTROLLER_H
+#define NULL_AUDIO_CONTROLLER_H
+
+#include "AtomicLock.h"
+#include "AudioController.h"
+#include "Constant.h"
+#include "PlaybackUserData.h"
+#include "SoundFileWriter.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+/// <summary>
+/// Pacing of the NullAudioController* callback thread
+/// </summary>
+enum class NullAudioPacing : int
+{
+	/// <summary>
+	/// Sleeps until each buffer's deadline (simulates a device clock)
+	/// </summary>
+	RealTime = 0,
+
+	/// <summary>
+	/// Calls back as fast as possible (throughput testing)
+	/// </summary>
+	AsFastAsPossible = 1,
+
+	/// <summary>
+	/// Real time, with a random wake-up delay (simulates host scheduling noise)
+	/// </summary>
+	Jittered = 2
+};
+
+/// <summary>
+/// Audio backend without a device:  The audio callback is called from this controller's own thread, with a
+/// simulated device clock. The output is written to file (.wav, or .flac), or discarded. Deadline misses are
+/// counted for load testing.
+/// </summary>
+class NullAudioController : public AudioController
+{
+public:
+
+	// Name of the (virtual) output device in the PlaybackDeviceRegister*
+	const char* DEVICE_NAME = "Null Audio Device";
+
+public:
+
+	/// <summary>
+	/// Creates the controller. An empty output file name discards the output.
+	/// </summary>
+	NullAudioController(AtomicLock* playbackLock,
+						unsigned int samplingRate,
+						unsigned int bufferFrameSize,
+						NullAudioPacing pacing,
+						float jitterMilli,
+						const std::string& outputFileName);
+	~NullAudioController();
+
+	bool Initialize(PlaybackUserData* playbackData, const AudioCallbackDelegate& audioCallback) override;
+	void Start() override;
+	bool Dispose() override;
+
+	bool OpenStream(PlaybackUserData* userData) override;
+	bool CloseStream() override;
+
+	bool StartStream() override;
+	bool StopStream() override;
+
+	bool IsStreamOpen() override;
+	bool IsStreamRunning() override;
+
+	/// <summary>
+	/// Returns the number of callbacks since the stream was started
+	/// </summary>
+	long long GetCallbackCount() const { return _callbackCount.load(); }
+
+	/// <summary>
+	/// Returns the number of callbacks that finished after their buffer's deadline
+	/// </summary>
+	long long GetDeadlineMisses() const { return _deadlineMisses.load(); }
+
+	/// <summary>
+	/// Returns the longest callback (in milli-seconds) since the stream was started
+	/// </summary>
+	double GetMaxCallbackMilli() const { return _maxCallbackMilli.load(); }
+
+private:
+
+	void Loop();
+
+private:
+
+	AudioCallbackDelegate* _audioCallback;
+	PlaybackUserData* _userData;
+	SoundFileWriter* _writer;
+	std::string* _outputFileName;
+
+	// Interleaved (L/R) output buffer (Float32)
+	float* _outputBuffer;
+
+	std::thread* _thread;
+	std::atomic<bool> _running;
+
+	unsigned int _samplingRate;
+	unsigned int _bufferFrameSize;
+	NullAudioPacing _pacing;
+	float _jitterMilli;
+
+	// Metrics
+	std::atomic<long long> _callbackCount;
+	std::atomic<long long> _deadlineMisses;
+	std::atomic<double> _maxCallbackMilli;
+
+	bool _streamOpen;
+	bool _initialized;
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "AtomicLock.h"
+#include "BaseController.h"
+#include "Constant.h"
+#include "MidiFile.h"
+#include "OfflineRenderController.h"
+#include "PlaybackController.h"
+#include "PlaybackUserData.h"
+#include "SoundFileWriter.h"
+#include "StopWatch.h"
+#include <Stk.h>
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+OfflineRenderController::OfflineRenderController(AtomicLock* playbackLock, unsigned int samplingRate, unsigned int bufferFrameSize) : BaseController(playbackLock)
+{
+	_playbackController = new PlaybackController(playbackLock);
+	_userData = nullptr;
+	_samplingRate = samplingRate;
+	_bufferFrameSize = bufferFrameSize;
+	_outputBuffer = new float[2 * bufferFrameSize];
+	_renderedSeconds = 0;
+	_realTimeFactor = 0;
+	_initialized = false;
+}
+
+OfflineRenderController::~OfflineRenderController()
+{
+	if (_initialized)
+		this->Dispose();
+
+	delete _playbackController;
+	delete[] _outputBuffer;
+}
+
+bool OfflineRenderController::Initialize(PlaybackUserData* playbackData)
+{
+	if (_initialized)
+		throw new std::exception("Offline Render Controller already initialized!");
+
+	_userData = playbackData;
+
+	// Virtual Output Device:  The stream format is always Float32 (written to file by libsndfile)
+	playbackData->GetDeviceRegister()->AddDevice(0, "Float32", "", DEVICE_NAME, AudioStreamFormat::Float32, _samplingRate, 2, _bufferFrameSize, 0, true);
+	playbackData->UpdateDevice(DEVICE_NAME, _samplingRate, _bufferFrameSize, true);
+
+	// STK (global sampling rate)
+	if (playbackData->GetSynthSettings()->GetStkEnabled())
+		stk::Stk::setSampleRate(_samplingRate);
+
+	// -> Effect Registry, Airwindows Plugins:  Require sampling rate!
+	bool success = playbackData->Initialize();
+
+	// (The PlaybackController* threads are not started:  There is no keyboard input, and no settings changes)
+	success &= _playbackController->Initialize(playbackData);
+
+	_initialized = success;
+
+	return success;
+}
+
+void OfflineRenderController::Start()
+{
+	// Nothing to do (see Render)
+}
+
+bool OfflineRenderController::Dispose()
+{
+	if (!_initialized)
+		throw new std::exception("Offline Render Controller not yet initialized!");
+
+	_initialized = false;
+
+	return _playbackController->Dispose();
+}
+
+bool OfflineRenderController::Render(const std::string& inputFile, const std::string& outputFile, float tailSeconds)
+{
+	if (!_initialized)
+		throw new std::exception("Offline Render Controller not yet initialized!");
+
+	smf::MidiFile midiFile;
+
+	if (inputFile.ends_with(".mid") || inputFile.ends_with(".midi"))
+	{
+		if (!midiFile.read(inputFile))
+			return false;
+	}
+	else if (!LoadNoteScript(inputFile, midiFile))
+		return false;
+
+	// Tempo Map (for the duration)
+	midiFile.doTimeAnalysis();
+
+	double durationSeconds = midiFile.getFileDurationInSeconds() + tailSeconds;
+	long long totalFrames = (long long)(durationSeconds * _samplingRate);
+
+	SoundFileWriter writer(outputFile, _samplingRate);
+
+	if (!writer.Open())
+		return false;
+
+	_playbackController->SetMidiMode(midiFile);
+
+	StopWatch stopWatch;
+	stopWatch.mark();
+
+	long long frameCursor = 0;
+	bool success = true;
+
+	// Render Loop:  Same callback as the audio backend; but, nothing waits on a device
+	while (frameCursor < totalFrames && success)
+	{
+		unsigned int numberOfFrames = (unsigned int)std::min<long long>(_bufferFrameSize, totalFrames - frameCursor);
+
+		success &= _playbackController->ProcessAudioCallback(_outputBuffer, AudioStreamFormat::Float32, numberOfFrames, frameCursor / (double)_samplingRate, 0, _userData) == 0;
+		success &= writer.Write(_outputBuffer, numberOfFrames);
+
+		frameCursor += numberOfFrames;
+	}
+
+	double elapsedSeconds = stopWatch.peek();
+
+	success &= writer.Close();
+
+	_playbackController->SetSynthMode();
+
+	_renderedSeconds = frameCursor / (double)_samplingRate;
+	_realTimeFactor = elapsedSeconds > 0 ? _renderedSeconds / elapsedSeconds : 0;
+
+	return success;
+}
+
+bool OfflineRenderController::LoadNoteScript(const std::string& fileName, smf::MidiFile& midiFile)
+{
+	std::ifstream stream(fileName);
+
+	if (!stream.is_open())
+		return false;
+
+	// Default tempo (120 BPM):  Ticks per second = 2 x ticks per quarter note
+	const int ticksPerQuarterNote = 480;
+	const double ticksPerSecond = 2.0 * ticksPerQuarterNote;
+
+	midiFile.setTicksPerQuarterNote(ticksPerQuarterNote);
+
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream lineStream(line);
+
+		double startSeconds = 0;
+		double durationSeconds = 0;
+		int midiNumber = 0;
+		int velocity = 100;
+
+		if (!(lineStream >> startSeconds >> durationSeconds >> midiNumber))
+			return false;
+
+		lineStream >> velocity;
+
+		midiFile.addNoteOn(0, (int)(startSeconds * ticksPerSecond), 0, midiNumber, velocity);
+		midiFile.addNoteOff(0, (int)((startSeconds + durationSeconds) * ticksPerSecond), 0, midiNumber);
+	}
+
+	midiFile.sortTracks();
+
+	return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef OFFLINE_RENDER_CONTROLLER_H
+#define OFFLINE_RENDER_CONTROLLER_H
+
+#include "AtomicLock.h"
+#include "BaseController.h"
+#include "MidiFile.h"
+#include "PlaybackController.h"
+#include "PlaybackUserData.h"
+#include <string>
+
+/// <summary>
+/// Headless controller that renders a midi file (or note script) to a sound file, as fast as possible. The
+/// PlaybackController* is driven directly, in a loop, in place of the audio backend; so no audio device is
+/// required. The real-time factor (seconds rendered / seconds elapsed) is reported after each render.
+/// </summary>
+class OfflineRenderController : public BaseController
+{
+public:
+
+	// Name of the (virtual) output device in the PlaybackDeviceRegister*
+	const char* DEVICE_NAME = "Offline Render";
+
+public:
+
+	OfflineRenderController(AtomicLock* playbackLock, unsigned int samplingRate, unsigned int bufferFrameSize);
+	~OfflineRenderController();
+
+	bool Initialize(PlaybackUserData* playbackData) override;
+	bool Dispose() override;
+	void Start() override;
+
+	/// <summary>
+	/// Renders the input (.mid, or a note script) to the output file (.wav, or .flac); and continues for
+	/// the tail (seconds) to let the notes release. Returns false if either file could not be opened.
+	/// </summary>
+	bool Render(const std::string& inputFile, const std::string& outputFile, float tailSeconds);
+
+	/// <summary>
+	/// Returns the seconds of audio rendered by the last call to Render
+	/// </summary>
+	double GetRenderedSeconds() const { return _renderedSeconds; }
+
+	/// <summary>
+	/// Returns the real-time factor of the last call to Render (seconds rendered / seconds elapsed)
+	/// </summary>
+	double GetRealTimeFactor() const { return _realTimeFactor; }
+
+private:
+
+	/// <summary>
+	/// Loads a note script into the midi file. Each line is:  start (seconds) duration (seconds) midi note
+	/// [velocity]. Lines starting with # are ignored.
+	/// </summary>
+	bool LoadNoteScript(const std::string& fileName, smf::MidiFile& midiFile);
+
+private:
+
+	PlaybackController* _playbackController;
+	PlaybackUserData* _userData;
+
+	unsigned int _samplingRate;
+	unsigned int _bufferFrameSize;
+
+	// Interleaved (L/R) output buffer (Float32)
+	float* _outputBuffer;
+
+	double _renderedSeconds;
+	double _realTimeFactor;
+
+	bool _initialized;
+};
+
+#endif
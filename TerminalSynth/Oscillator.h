@@ -0,0 +1,168 @@
+#pragma once
+
+#ifndef OSCILLATOR_H
+#define OSCILLATOR_H
+
+#include "Constant.h"
+#include "SignalFactoryCore.h"
+#include <cmath>
+#include <exception>
+
+/// <summary>
+/// Phase-accumulator oscillator:  The phase (in cycles [0, 1)) is kept in double precision, and advanced by
+/// frequency / sampling rate each frame. The cost per sample is constant; and the accuracy does not depend on
+/// how long the stream has been running (see SignalFactoryCore for the waveforms).
+/// </summary>
+class Oscillator
+{
+public:
+
+	Oscillator()
+	{
+		_phase = 0;
+		_lastFrameCursor = 0;
+		_synced = false;
+	}
+	~Oscillator() {}
+
+	/// <summary>
+	/// Resets the phase (in cycles [0, 1))
+	/// </summary>
+	void Reset(double phase = 0)
+	{
+		_phase = phase - std::floor(phase);
+		_synced = false;
+	}
+
+	double GetPhase() const { return _phase; }
+
+	/// <summary>
+	/// Sets the phase (in cycles [0, 1)) without re-syncing the oscillator (see SynthVoiceBank)
+	/// </summary>
+	void SetPhase(double phase)
+	{
+		_phase = phase - std::floor(phase);
+	}
+
+	/// <summary>
+	/// Returns the sample at the current phase; and advances the phase by one frame
+	/// </summary>
+	float Next(PrimitiveSynthVoices waveform, float frequency, float samplingRate, float signalHigh, float signalLow)
+	{
+		double increment = frequency / (double)samplingRate;
+
+		float sample = GetSample(waveform, _phase, increment, signalHigh, signalLow);
+
+		Advance(increment);
+
+		return sample;
+	}
+
+	/// <summary>
+	/// Generates a block of samples (at a constant frequency) into the destination
+	/// </summary>
+	void GenerateBlock(PrimitiveSynthVoices waveform, float* destination, int frameCount, float frequency, float samplingRate, float signalHigh, float signalLow)
+	{
+		double increment = frequency / (double)samplingRate;
+
+		switch (waveform)
+		{
+		case PrimitiveSynthVoices::Sine:
+			for (int index = 0; index < frameCount; index++, Advance(increment))
+				destination[index] = SignalFactoryCore::GenerateSineSample(_phase, signalHigh, signalLow);
+			break;
+		case PrimitiveSynthVoices::Square:
+			for (int index = 0; index < frameCount; index++, Advance(increment))
+				destination[index] = SignalFactoryCore::GenerateSquareSample(_phase, signalHigh, signalLow);
+			break;
+		case PrimitiveSynthVoices::Triangle:
+			for (int index = 0; index < frameCount; index++, Advance(increment))
+				destination[index] = SignalFactoryCore::GenerateTriangleSample(_phase, signalHigh, signalLow);
+			break;
+		case PrimitiveSynthVoices::Sawtooth:
+			for (int index = 0; index < frameCount; index++, Advance(increment))
+				destination[index] = SignalFactoryCore::GenerateSawtoothSample(_phase, signalHigh, signalLow);
+			break;
+		case PrimitiveSynthVoices::SquareBandLimited:
+			for (int index = 0; index < frameCount; index++, Advance(increment))
+				destination[index] = SignalFactoryCore::GenerateSquareSampleBandLimited(_phase, increment, signalHigh, signalLow);
+			break;
+		case PrimitiveSynthVoices::TriangleBandLimited:
+			for (int index = 0; index < frameCount; index++, Advance(increment))
+				destination[index] = SignalFactoryCore::GenerateTriangleSampleBandLimited(_phase, increment, signalHigh, signalLow);
+			break;
+		case PrimitiveSynthVoices::SawtoothBandLimited:
+			for (int index = 0; index < frameCount; index++, Advance(increment))
+				destination[index] = SignalFactoryCore::GenerateSawtoothSampleBandLimited(_phase, increment, signalHigh, signalLow);
+			break;
+		default:
+			throw new std::exception("Unhandled oscillator waveform:  Oscillator.h");
+		}
+	}
+
+	/// <summary>
+	/// Advances the phase by the number of frames since the last call; and returns the sample at that phase. This
+	/// is for oscillators that are sampled at irregular intervals (e.g. parameter automation). Only the (small) frame
+	/// difference is used; so the accuracy does not depend on the stream time.
+	/// </summary>
+	float SampleAt(PrimitiveSynthVoices waveform, size_t frameCursor, float frequency, float samplingRate, float signalHigh, float signalLow)
+	{
+		double increment = frequency / (double)samplingRate;
+
+		if (_synced && frameCursor > _lastFrameCursor)
+			Advance((frameCursor - _lastFrameCursor) * increment);
+
+		_lastFrameCursor = frameCursor;
+		_synced = true;
+
+		return GetSample(waveform, _phase, increment, signalHigh, signalLow);
+	}
+
+	/// <summary>
+	/// Returns the waveform sample at the phase (in cycles [0, 1)). The phase increment (per frame) is used by
+	/// the band-limited waveforms.
+	/// </summary>
+	static float GetSample(PrimitiveSynthVoices waveform, double phase, double phaseIncrement, float signalHigh, float signalLow)
+	{
+		switch (waveform)
+		{
+		case PrimitiveSynthVoices::Sine:
+			return SignalFactoryCore::GenerateSineSample(phase, signalHigh, signalLow);
+		case PrimitiveSynthVoices::Square:
+			return SignalFactoryCore::GenerateSquareSample(phase, signalHigh, signalLow);
+		case PrimitiveSynthVoices::Triangle:
+			return SignalFactoryCore::GenerateTriangleSample(phase, signalHigh, signalLow);
+		case PrimitiveSynthVoices::Sawtooth:
+			return SignalFactoryCore::GenerateSawtoothSample(phase, signalHigh, signalLow);
+		case PrimitiveSynthVoices::SquareBandLimited:
+			return SignalFactoryCore::GenerateSquareSampleBandLimited(phase, phaseIncrement, signalHigh, signalLow);
+		case PrimitiveSynthVoices::TriangleBandLimited:
+			return SignalFactoryCore::GenerateTriangleSampleBandLimited(phase, phaseIncrement, signalHigh, signalLow);
+		case PrimitiveSynthVoices::SawtoothBandLimited:
+			return SignalFactoryCore::GenerateSawtoothSampleBandLimited(phase, phaseIncrement, signalHigh, signalLow);
+		default:
+			throw new std::exception("Unhandled oscillator waveform:  Oscillator.h");
+		}
+	}
+
+private:
+
+	void Advance(double increment)
+	{
+		_phase += increment;
+
+		// Wrap (increments are usually < 1 cycle)
+		if (_phase >= 1.0)
+			_phase -= std::floor(_phase);
+	}
+
+private:
+
+	double _phase;
+
+	// (see SampleAt)
+	size_t _lastFrameCursor;
+	bool _synced;
+};
+
+#endif
@@ -152,6 +152,21 @@ public:
 		TerminalSynth::HashCombine(hash1, hash5);
 		TerminalSynth::HashCombine(hash1, hash6);
 
+		// Harmonic Shaper:  The wave table is built from the harmonics (see WaveTableCache)
+		if (_voiceType == SynthVoiceType::HarmonicShaper)
+		{
+			size_t hash7 = floatHasher(_waveshaperRandomPhaseAmplitude);
+
+			TerminalSynth::HashCombine(hash1, hash7);
+
+			for (int index = 0; index < _waveshaperHarmonics->size(); index++)
+			{
+				size_t harmonicHash = floatHasher(_waveshaperHarmonics->at(index));
+
+				TerminalSynth::HashCombine(hash1, harmonicHash);
+			}
+		}
+
 		return hash1;
 	}
 
@@ -102,7 +102,10 @@ OscillatorUI::OscillatorUI(const SoundBankSettings* soundBankSettings, const Osc
 		"Sine",
 		"Square",
 		"Triangle",
-		"Sawtooth"
+		"Sawtooth",
+		"Square (Band Limited)",
+		"Triangle (Band Limited)",
+		"Sawtooth (Band Limited)"
 	});
 	_synthVoiceOtherItems = new std::vector<std::string>({
 		"SynthesizedStringPluck"
@@ -1,20 +1,32 @@
 #include "AtomicLock.h"
+#include "AudioBlock.h"
 #include "BaseController.h"
 #include "Constant.h"
+#include "DenormalGuard.h"
 #include "EqualizerOutput.h"
 #include "IntervalTimer.h"
+#include "KeyboardInput.h"
 #include "LoopTimer.h"
+#include "MidiFile.h"
 #include "MidiPlaybackDevice.h"
+#include "NoteEvent.h"
 #include "PlaybackClock.h"
 #include "PlaybackController.h"
+#include "PlaybackDither.h"
 #include "PlaybackFormatTransformer.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "PlaybackUserData.h"
+#include "SnapshotBuffer.h"
 #include "SoundRegistry.h"
+#include "SpscQueue.h"
+#include "Synth.h"
+#include "SynthBuilder.h"
+#include "SynthChainEdit.h"
 #include "SynthPlaybackDevice.h"
 #include "SynthSettings.h"
+#include <algorithm>
 #include <exception>
 #include <string>
 
@@ -30,6 +42,14 @@ PlaybackController::PlaybackController(AtomicLock* playbackLock) : BaseControlle
 	_audioSampleTimer = new IntervalTimer();
 	_audioLockAcquireTimer = new IntervalTimer();
 	_playbackTime = new PlaybackTime();
+	_outputBlock = nullptr;
+	_synthBuilder = nullptr;
+	_initialStructureHash = 0;
+	_initialChainHash = 0;
+	_keyboardInput = new KeyboardInput();
+	_initialSettings = nullptr;
+	_equalizer = nullptr;
+	_dither = new PlaybackDither();
 }
 
 PlaybackController::~PlaybackController()
@@ -46,6 +66,16 @@ bool PlaybackController::Initialize(PlaybackUserData* playbackData)
 	_synthDevice->Initialize(playbackData->GetEffectRegistry(), playbackData->GetSynthSettings(), playbackData->GetPlaybackInfo());
 	_midiDevice->Initialize(playbackData->GetEffectRegistry(), playbackData->GetSynthSettings(), playbackData->GetPlaybackInfo());
 
+	// MEMORY! ~PlaybackController -> Dispose
+	_outputBlock = new AudioBlock(AUDIO_BLOCK_SIZE, playbackData->GetPlaybackInfo()->GetStreamInfo()->streamSampleRate);
+
+	// MEMORY! ~PlaybackController -> Dispose
+	_synthBuilder = new SynthBuilder(playbackData->GetEffectRegistry(), playbackData->GetPlaybackInfo());
+	_initialStructureHash = Synth::GetStructureHashCode(playbackData->GetSynthSettings()->GetCurrentSoundSettings());
+	_initialChainHash = Synth::GetChainHashCode(playbackData->GetSynthSettings()->GetCurrentSoundSettings());
+	_initialSettings = playbackData->GetSynthSettings();
+	_equalizer = playbackData->GetEqualizer();
+
 	_initialized = true;
 
 	return _initialized;
@@ -64,116 +94,178 @@ int PlaybackController::ProcessAudioCallback(void* outputBuffer, AudioStreamForm
 	// Full Audio Loop Timer
 	_audioTimer->Mark();
 
-	SynthSettings* configuration = userData->GetSynthSettings();
+	// FTZ / DAZ for the render (restored when the callback returns)
+	DenormalGuard denormalGuard;
+
+	SnapshotBuffer<SynthSettings>* settingsSnapshot = userData->GetSynthSettingsSnapshot();
 	SoundRegistry* effectRegistry = userData->GetEffectRegistry();
 	PlaybackInfo* outputSettings = userData->GetPlaybackInfo();
 	EqualizerOutput* equalizer = userData->GetEqualizer();
 
 	// Some RT Updates
 	float avgAudioMilli = _audioTimer->GetAvgMilli();
-	float avgAudioSampleMicro = _audioSampleTimer->AvgMicro();
+	float avgAudioSampleMicro = numberOfFrames > 0 ? _audioSampleTimer->AvgMicro() / numberOfFrames : 0;
 	float avgAudioLockAcquireNano = _audioLockAcquireTimer->AvgNano();
 
-	// std::atomic wait loop (timing the lock acquire)
+	// Settings Snapshot:  The UI thread publishes copies of the SynthSettings*, so picking up the latest one is
+	//					  a single atomic load (and exchange, when there is a new one). This never blocks.
+	//
 	_audioLockAcquireTimer->Reset();
-	this->PlaybackLock->AcquireLock();
+	bool configurationChanged = settingsSnapshot->Acquire();
 	_audioLockAcquireTimer->Mark();
 
-	// Update Synth Device (DIRTY FLAG IS IN REAL TIME! WE NEED TO AVOID IT UNTIL THE USER HAS CHANGED A SYNTH SETTING!)
-	if (configuration->IsDirty())
+	const SynthSettings* configuration = settingsSnapshot->GetFront();
+
+	// Synth Builder:  Structural changes (voice type, effect chains) are built off the audio thread. The new Synth* is
+	//				   swapped in here; and the previous one is handed back to the builder to be deleted.
+	//
+	Synth* builtSynth = _synthBuilder->TakePending();
+
+	if (builtSynth != nullptr)
+	{
+		// (A crossfade that was still in progress is cut short; see Synth::Adopt)
+		Synth* retiredSynth = _midiMode ? _midiDevice->SwapSynth(builtSynth, *_playbackTime, configuration) :
+										  _synthDevice->SwapSynth(builtSynth, *_playbackTime, configuration);
+
+		if (retiredSynth != nullptr)
+			_synthBuilder->Retire(retiredSynth);
+
+		// Apply the latest parameters to the new Synth*
+		configurationChanged = true;
+	}
+
+	// Chain Edits:  Effect chain changes are built off the audio thread too; and adopted by the playing Synth*, which
+	//				 keeps its voices. The edit goes back to the builder with the replaced chains (or its own, if it was
+	//				 built before the latest Synth*).
+	//
+	SynthChainEdit* chainEdit = _synthBuilder->TakePendingEdit();
+
+	if (chainEdit != nullptr)
+	{
+		bool adopted = _midiMode ? _midiDevice->AdoptChains(chainEdit, *_playbackTime) :
+								   _synthDevice->AdoptChains(chainEdit, *_playbackTime);
+
+		_synthBuilder->RetireEdit(chainEdit);
+
+		// Apply the latest parameters to the new chains
+		configurationChanged |= adopted;
+	}
+
+	// Update Synth Device (Only when the user has changed a synth setting)
+	if (configurationChanged)
 	{
 		if (_midiMode)
 			_midiDevice->Update(effectRegistry, configuration, outputSettings);
 		else
 			_synthDevice->Update(effectRegistry, configuration, outputSettings);
-
-		configuration->ClearDirty();
 	}
 
-	// Write Output Buffer:  The PlaybackDevice* is handled per frame. Since the SynthPlaybackDevice* sets all notes at
-	//						 once, the call should only be made on the first frame.
+	// Write Output Buffer:  The PlaybackDevice* renders the buffer in blocks (of up to AUDIO_BLOCK_SIZE frames). Since the
+	//						 SynthPlaybackDevice* sets all notes at once, the call should only be made on the first block.
 	//
-	//						 The PlaybackTime* is updated each iteration. THE STREAM TIME WILL ONLY BE APPROXIMATE! There
+	//						 The PlaybackTime* is updated each block. THE STREAM TIME WILL ONLY BE APPROXIMATE! There
 	//						 have been issues using the stream time to do sampling. So, the sample time is calculated using
 	//						 the frame cursor.
 	//
 	
-	// Synth Device:  Pressed notes, or check Midi Device each frame
-	bool hasOutput = !_midiMode ? _synthDevice->SetForFrame(*_playbackTime, configuration) : false;
-	bool sampleSuccess = true;
-
 	float gain = configuration->GetGain();
 	float leftRight = configuration->GetLeftRightBalance();
+	float samplingRate = outputSettings->GetStreamInfo()->streamSampleRate;
+
+	// Keyboard Input -> Note Events (scheduled at their frame offset in this buffer)
+	ScheduleNoteEvents(numberOfFrames, samplingRate);
+
+	// Synth Device:  Pressed notes, or check Midi Device each block
+	bool hasOutput = !_midiMode ? _synthDevice->SetForFrame(*_playbackTime, configuration) : false;
+	bool sampleSuccess = true;
 
-	PlaybackFrame playbackFrame(0, 0);
+	// Audio Sample Timer (averaged per frame below)
+	_audioSampleTimer->Reset();
 
-	// Output || Midi Mode
-	for (int frameIndex = 0; frameIndex < numberOfFrames && sampleSuccess; frameIndex++)
+	for (int frameOffset = 0; frameOffset < numberOfFrames && sampleSuccess; frameOffset += AUDIO_BLOCK_SIZE)
 	{
+		int frameCount = std::min((int)numberOfFrames - frameOffset, AUDIO_BLOCK_SIZE);
+
 		if (_midiMode)
 			hasOutput = _midiDevice->SetForFrame(*_playbackTime, configuration);
 
-		//if (hasOutput)
-		//{
-			// Audio Sample Timer
-			_audioSampleTimer->Reset();
+		sampleSuccess = _midiMode ? _midiDevice->WriteBlock(_outputBlock, *_playbackTime, frameCount, gain, leftRight) :
+									_synthDevice->WriteBlock(_outputBlock, *_playbackTime, frameCount, gain, leftRight);
 
-			sampleSuccess = _midiMode ? _midiDevice->WriteSample(playbackFrame, *_playbackTime, gain, leftRight) :
-										_synthDevice->WriteSample(playbackFrame, *_playbackTime, gain, leftRight);
+		const float* left = _outputBlock->GetLeft();
+		const float* right = _outputBlock->GetRight();
 
-			_audioSampleTimer->Mark();
+		// Apply Sample Frames
+		WriteBufferWithTransform(outputBuffer, streamFormat, left, right, frameOffset, frameCount);
 
-			// Apply Sample Frame
-			WriteBufferWithTransform(outputBuffer, streamFormat, playbackFrame, frameIndex);
+		// Equalizer:  Copied into the analyzer tap (the analysis is done on the analyzer thread)
+		equalizer->AddBlock(left, right, frameCount);
 
-			// Apply Sample to Equalizer
-			equalizer->AddSample(playbackFrame.GetLeft(), playbackFrame.GetRight());
+		// Stream Time:  PRIMARY STREAM TIME SOURCE (Incrementing, instead of querying the stream source). There could be
+		//				 real time audio forums about how to do this. It may be more accurate to query; but there could
+		//				 be a problem getting the latest stream time (perhaps a mutex, but not likely). It's better to 
+		//				 use the frame cursor to get the stream time; but this will set an equivalent, anyway.
+		//
+		_playbackTime->Advance(frameCount, samplingRate);
+	}
 
-			// Clear Sample Frame (any reference to the frame has been copied by the backend; and will be stored separately)
-			playbackFrame.ClearSample();
+	_audioSampleTimer->Mark();
 
-			// Stream Time:  PRIMARY STREAM TIME SOURCE (Incrementing, instead of querying the stream source). There could be
-			//				 real time audio forums about how to do this. It may be more accurate to query; but there could
-			//				 be a problem getting the latest stream time (perhaps a mutex, but not likely). It's better to 
-			//				 use the frame cursor to get the stream time; but this will set an equivalent, anyway.
-			//
-			_playbackTime->streamTime += 1 / outputSettings->GetStreamInfo()->streamSampleRate;
-			_playbackTime->frameCursor++;
-		//}
-	}
+	// Synth Builder:  The previous Synth* is handed back once it has been crossfaded out
+	Synth* fadedSynth = _midiMode ? _midiDevice->TakeFadedSynth() : _synthDevice->TakeFadedSynth();
+
+	if (fadedSynth != nullptr)
+		_synthBuilder->Retire(fadedSynth);
 
 	// RT Update (Audio)
 	outputSettings->UpdateRT_Audio(streamTime, avgAudioMilli, avgAudioSampleMicro, avgAudioLockAcquireNano, streamLatency);
 
-	// std::atomic end loop
-	this->PlaybackLock->Release();
-
 	// NEED ERROR CODE ENUMS
 	return sampleSuccess ? 0 : -1;
 }
 
-void PlaybackController::WriteBufferWithTransform(void* outputBuffer, AudioStreamFormat streamFormat, const PlaybackFrame& frame, int frameIndex)
+void PlaybackController::ScheduleNoteEvents(unsigned int numberOfFrames, float samplingRate)
 {
-	char* buffer = (char*)outputBuffer;
-
-	// Transform buffers (two floats)
-	int frameSize = 4;
-	char leftBuffer[4];
-	char rightBuffer[4];
+	// Note Event Timing:  Each event is delayed by exactly one buffer. The buffer being rendered covers the
+	//					   previous buffer period on the input clock, so an event lands at the same offset
+	//					   into this buffer as it arrived in the last one. This trades the polling jitter (up to
+	//					   one buffer) for a constant latency.
+	//
+	SpscQueue<NoteEvent>* events = _keyboardInput->GetEvents();
+	NoteEvent noteEvent;
 
-	// TRANSFORM STREAM:  The byte stream must match the output format
-	PlaybackFormatTransformer::Transform(streamFormat, frame.GetLeft(), leftBuffer, frameSize);
-	PlaybackFormatTransformer::Transform(streamFormat, frame.GetRight(), rightBuffer, frameSize);
+	double callbackTime = NoteEvent::Clock();
+	double bufferStartTime = callbackTime - (numberOfFrames / (double)samplingRate);
 
-	// Write Transformed Buffer
-	for (int index = 0; index < frameSize; index++)
+	while (events->Peek(noteEvent))
 	{
-		// Interleved frames
-		buffer[(2 * frameIndex * frameSize) + index] = leftBuffer[index];
-		buffer[(2 * frameIndex * frameSize) + frameSize + index] = rightBuffer[index];
+		// Arrived after this callback started (next buffer)
+		if (noteEvent.timestamp > callbackTime)
+			break;
+
+		int frameOffset = (int)((noteEvent.timestamp - bufferStartTime) * samplingRate);
+
+		frameOffset = std::clamp(frameOffset, 0, (int)numberOfFrames - 1);
+
+		// (Note events are dropped in MIDI mode)
+		if (!_midiMode && !_synthDevice->ScheduleNote(noteEvent, _playbackTime->frameCursor + frameOffset))
+			break;
+
+		events->Pop(noteEvent);
 	}
 }
 
+void PlaybackController::WriteBufferWithTransform(void* outputBuffer, AudioStreamFormat streamFormat, const float* left, const float* right, int frameOffset, int frameCount)
+{
+	// Interleaved (stereo) frames of the stream's sample size
+	int frameSize = 2 * PlaybackFormatTransformer::GetSampleSize(streamFormat);
+
+	char* buffer = (char*)outputBuffer + (frameOffset * frameSize);
+
+	// TRANSFORM STREAM:  The byte stream must match the output format
+	PlaybackFormatTransformer::TransformBlock(streamFormat, left, right, buffer, frameCount, _dither);
+}
+
 void PlaybackController::Start()
 {
 	_streamClock->Reset();
@@ -181,6 +273,10 @@ void PlaybackController::Start()
 	_audioTimer->Reset();
 	_audioSampleTimer->Reset();
 	_audioLockAcquireTimer->Reset();
+
+	_synthBuilder->Start(_initialStructureHash, _initialChainHash);
+	_keyboardInput->Start(_initialSettings);
+	_equalizer->Start();
 }
 
 bool PlaybackController::Dispose()
@@ -188,6 +284,13 @@ bool PlaybackController::Dispose()
 	if (!_initialized)
 		throw new std::exception("Audio Controller not yet initialized!");
 
+	// Builder thread must stop before the devices (and their Synth*) are deleted
+	_synthBuilder->Stop();
+	_keyboardInput->Stop();
+	_equalizer->Stop();
+
+	delete _synthBuilder;
+	delete _keyboardInput;
 	delete _synthDevice;
 	delete _midiDevice;
 	delete _streamClock;
@@ -195,6 +298,8 @@ bool PlaybackController::Dispose()
 	delete _audioSampleTimer;
 	delete _audioLockAcquireTimer;
 	delete _playbackTime;
+	delete _outputBlock;
+	delete _dither;
 
 	_midiDevice = nullptr;
 	_synthDevice = nullptr;
@@ -203,6 +308,11 @@ bool PlaybackController::Dispose()
 	_audioSampleTimer = nullptr;
 	_audioLockAcquireTimer = nullptr;
 	_playbackTime = nullptr;
+	_outputBlock = nullptr;
+	_dither = nullptr;
+	_synthBuilder = nullptr;
+	_keyboardInput = nullptr;
+	_equalizer = nullptr;
 
 	_initialized = false;
 
@@ -214,10 +324,26 @@ void PlaybackController::SetMidiMode(const std::string& midiFile)
 	if (!_initialized)
 		throw new std::exception("Audio Controller not yet initialized!");
 
+	// Prepare MIDI Playback (the timeline is compiled here; and swapped in by the audio thread)
+	_midiDevice->Load(midiFile);
+
 	_midiMode = true;
 
-	// Prepare MIDI Playback
+	// Re-build for the MIDI device (it may have missed structural changes)
+	_synthBuilder->Invalidate();
+}
+
+void PlaybackController::SetMidiMode(smf::MidiFile& midiFile)
+{
+	if (!_initialized)
+		throw new std::exception("Audio Controller not yet initialized!");
+
 	_midiDevice->Load(midiFile);
+
+	_midiMode = true;
+
+	// Re-build for the MIDI device (it may have missed structural changes)
+	_synthBuilder->Invalidate();
 }
 
 void PlaybackController::SetSynthMode()
@@ -227,5 +353,22 @@ void PlaybackController::SetSynthMode()
 
 	_midiMode = false;
 
-	// Nothing else to do..
+	// Re-build for the synth device (it may have missed structural changes)
+	_synthBuilder->Invalidate();
+}
+
+void PlaybackController::RequestSynthBuild(const SynthSettings* configuration)
+{
+	if (!_initialized)
+		throw new std::exception("Audio Controller not yet initialized!");
+
+	_synthBuilder->Request(configuration);
+}
+
+void PlaybackController::UpdateKeyMap(const SynthSettings* configuration)
+{
+	if (!_initialized)
+		throw new std::exception("Audio Controller not yet initialized!");
+
+	_keyboardInput->UpdateKeyMap(configuration);
 }
@@ -4,16 +4,23 @@
 #define PLAYBACK_CONTROLLER_H
 
 #include "AtomicLock.h"
+#include "AudioBlock.h"
 #include "BaseController.h"
 #include "Constant.h"
+#include "EqualizerOutput.h"
 #include "IntervalTimer.h"
+#include "KeyboardInput.h"
 #include "LoopTimer.h"
+#include "MidiFile.h"
 #include "MidiPlaybackDevice.h"
 #include "PlaybackClock.h"
+#include "PlaybackDither.h"
 #include "PlaybackFrame.h"
 #include "PlaybackTime.h"
 #include "PlaybackUserData.h"
+#include "SynthBuilder.h"
 #include "SynthPlaybackDevice.h"
+#include "SynthSettings.h"
 #include <string>
 
 class PlaybackController : public BaseController
@@ -33,11 +40,27 @@ public:
 	/// </summary>
 	void SetMidiMode(const std::string& midiFile);
 
+	/// <summary>
+	/// Switches to midi mode, playing the (loaded, or generated) midi file
+	/// </summary>
+	void SetMidiMode(smf::MidiFile& midiFile);
+
 	/// <summary>
 	/// Switches between midi / synth mode
 	/// </summary>
 	void SetSynthMode();
 
+	/// <summary>
+	/// (UI Thread) Requests a new Synth* to be built off the audio thread, if the settings require a new voice
+	/// pool, or effect chain. This should follow each published settings snapshot.
+	/// </summary>
+	void RequestSynthBuild(const SynthSettings* configuration);
+
+	/// <summary>
+	/// (UI Thread) Updates the computer keyboard -> midi note map for the keyboard input thread
+	/// </summary>
+	void UpdateKeyMap(const SynthSettings* configuration);
+
 public:
 
 	/// <summary>
@@ -52,7 +75,8 @@ public:
 
 private:
 
-	void WriteBufferWithTransform(void* outputBuffer, AudioStreamFormat streamFormat, const PlaybackFrame& frame, int frameIndex);
+	void ScheduleNoteEvents(unsigned int numberOfFrames, float samplingRate);
+	void WriteBufferWithTransform(void* outputBuffer, AudioStreamFormat streamFormat, const float* left, const float* right, int frameOffset, int frameCount);
 
 private:
 
@@ -62,6 +86,22 @@ private:
 	SynthPlaybackDevice* _synthDevice;
 	MidiPlaybackDevice* _midiDevice;
 	PlaybackTime* _playbackTime;
+	AudioBlock* _outputBlock;
+
+	// Output conversion (dither state for the integer formats)
+	PlaybackDither* _dither;
+
+	// Builds Synth* instances for structural changes (voice type, effect chains) off the audio thread
+	SynthBuilder* _synthBuilder;
+	size_t _initialStructureHash;
+	size_t _initialChainHash;
+
+	// Computer keyboard input (timestamped note events, polled on the input thread)
+	KeyboardInput* _keyboardInput;
+	const SynthSettings* _initialSettings;
+
+	// Spectrum analyzer (owned by the PlaybackUserData*)
+	EqualizerOutput* _equalizer;
 
 	PlaybackClock* _streamClock;
 	LoopTimer* _audioTimer;
@@ -3,10 +3,13 @@
 #ifndef PLAYBACK_DEVICE_H
 #define PLAYBACK_DEVICE_H
 
+#include "AudioBlock.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "SoundRegistry.h"
+#include "Synth.h"
+#include "SynthChainEdit.h"
 #include "SynthSettings.h"
 
 class PlaybackDevice
@@ -29,6 +32,25 @@ public:
 	/// <returns>Returns true if device is ready, otherwise false for some sort of error</returns>
 	virtual bool Update(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters) = 0;
 
+	/// <summary>
+	/// (Audio Thread) Swaps in a Synth* that was built off the audio thread (see SynthBuilder). The sounding notes are
+	/// continued by the new instance; and the previous instance is crossfaded out (see Synth::Adopt), then handed back
+	/// by TakeFadedSynth. Returns an instance that must be disposed of off the audio thread now, or nullptr.
+	/// </summary>
+	virtual Synth* SwapSynth(Synth* synth, const PlaybackTime& playbackTime, const SynthSettings* configuration) = 0;
+
+	/// <summary>
+	/// (Audio Thread) Returns the previous Synth* once its crossfade has finished (see SwapSynth); or nullptr. The
+	/// instance must be disposed of off the audio thread.
+	/// </summary>
+	virtual Synth* TakeFadedSynth() = 0;
+
+	/// <summary>
+	/// (Audio Thread) The Synth* takes over the effect chains of the edit, keeping its voices (see Synth::AdoptChains).
+	/// Returns false if the edit was not adopted. Either way, the edit must be disposed of off the audio thread.
+	/// </summary>
+	virtual bool AdoptChains(SynthChainEdit* chainEdit, const PlaybackTime& playbackTime) = 0;
+
 	/// <summary>
 	/// Sets the playback device for this stream time prior to writing playback buffer. Returns
 	/// true if the setup was successful; and that there is anything to play this frame.
@@ -42,6 +64,12 @@ public:
 	/// date parameters supplied by the PlaybackController*
 	/// </summary>
 	virtual bool WriteSample(PlaybackFrame& playbackFrame, const PlaybackTime& playbackTime, float gain, float leftRightBalance) = 0;
+
+	/// <summary>
+	/// Tells the playback device to write a block of frames (overwriting the block), starting at the playback time. Returns true
+	/// if the write was successful. The frame count must not exceed AUDIO_BLOCK_SIZE.
+	/// </summary>
+	virtual bool WriteBlock(AudioBlock* block, const PlaybackTime& playbackTime, int frameCount, float gain, float leftRightBalance) = 0;
 };
 
 
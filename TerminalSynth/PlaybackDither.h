@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef PLAYBACK_DITHER_H
+#define PLAYBACK_DITHER_H
+
+#include <cmath>
+#include <cstdint>
+
+/// <summary>
+/// TPDF (triangular) dither, with first order noise shaping, for the integer output formats. The state (noise
+/// generator, and the quantization error of each channel) carries over between blocks; so there is one instance
+/// per output stream.
+/// </summary>
+class PlaybackDither
+{
+public:
+
+	PlaybackDither()
+	{
+		_enabled = true;
+		_seed = 0x9E3779B9u;
+		_errorLeft = 0;
+		_errorRight = 0;
+	}
+	~PlaybackDither() {};
+
+	bool GetEnabled() const { return _enabled; }
+	void SetEnabled(bool value) { _enabled = value; }
+
+	/// <summary>
+	/// Quantizes the (scaled) sample of the channel to an integer in [minimum, maximum]. The error of the
+	/// previous sample is subtracted first (the noise is shaped toward high frequencies); and a TPDF dither
+	/// of +/- 1 LSB is added before rounding.
+	/// </summary>
+	float Quantize(float sample, bool left, float minimum, float maximum)
+	{
+		float& error = left ? _errorLeft : _errorRight;
+
+		float shaped = sample - error;
+		float quantized = std::floor(shaped + NextTriangular() + 0.5f);
+
+		quantized = quantized < minimum ? minimum : (quantized > maximum ? maximum : quantized);
+
+		// (Clamp the fed back error; so a clipped sample does not ring)
+		error = quantized - shaped;
+		error = error < -1.0f ? -1.0f : (error > 1.0f ? 1.0f : error);
+
+		return quantized;
+	}
+
+private:
+
+	/// <summary>
+	/// Triangular noise in (-1, 1):  Difference of two uniform values (xorshift)
+	/// </summary>
+	float NextTriangular()
+	{
+		return NextUniform() - NextUniform();
+	}
+
+	float NextUniform()
+	{
+		_seed ^= _seed << 13;
+		_seed ^= _seed >> 17;
+		_seed ^= _seed << 5;
+
+		return (_seed >> 8) * (1.0f / 16777216.0f);
+	}
+
+private:
+
+	bool _enabled;
+
+	uint32_t _seed;
+
+	// Quantization error (LSB) of the last sample of each channel
+	float _errorLeft;
+	float _errorRight;
+};
+
+#endif
@@ -4,30 +4,68 @@
 #define PLAYBACK_FORMAT_TRANSFORMER_H
 
 #include "Constant.h"
+#include "PlaybackDither.h"
+#include <cmath>
 #include <cstdint>
 #include <exception>
 #include <limits>
-#include <string.h>
 
+/// <summary>
+/// Converts planar (left / right) float blocks into the interleaved output format of the stream. Each format has
+/// its own loop (clamp, scale, round, and store); so there is no branch per sample, and the compiler can vectorize
+/// the conversion, and interleaving, in one pass.
+/// </summary>
 class PlaybackFormatTransformer
 {
 public:
 
-	static void Transform(AudioStreamFormat format, float input, char* output, int& outputLength)
+	/// <summary>
+	/// Returns the size of one sample (one channel) of the format (bytes)
+	/// </summary>
+	static int GetSampleSize(AudioStreamFormat format)
 	{
 		switch (format)
 		{
 		case AudioStreamFormat::Float32:
-			Transform32_Float(input, output, outputLength);
+			return sizeof(float);
+		case AudioStreamFormat::Int32:
+			return sizeof(int32_t);
+		case AudioStreamFormat::Int16:
+			return sizeof(int16_t);
+		case AudioStreamFormat::Int8:
+			return sizeof(int8_t);
+		default:
+			throw new std::exception("Unhandled format:  PlaybackFormatTransformer.h");
+		}
+	}
+
+	/// <summary>
+	/// Writes frameCount interleaved (stereo) frames to the output, starting at the output's first frame. The
+	/// samples are clamped to [-1, 1]. The dither (optional) is applied to the 16, and 8, bit formats.
+	/// </summary>
+	static void TransformBlock(AudioStreamFormat format, const float* left, const float* right, void* output, int frameCount, PlaybackDither* dither)
+	{
+		bool useDither = dither != nullptr && dither->GetEnabled();
+
+		switch (format)
+		{
+		case AudioStreamFormat::Float32:
+			TransformBlock_Float32(left, right, (float*)output, frameCount);
 			break;
 		case AudioStreamFormat::Int32:
-			Transform32_Integer(input, output, outputLength);
+			TransformBlock_Integer<int32_t>(left, right, (int32_t*)output, frameCount, INT32_SCALE);
 			break;
 		case AudioStreamFormat::Int16:
-			Transform16_Integer(input, output, outputLength);
+			if (useDither)
+				TransformBlock_Dither<int16_t>(left, right, (int16_t*)output, frameCount, dither);
+			else
+				TransformBlock_Integer<int16_t>(left, right, (int16_t*)output, frameCount, std::numeric_limits<int16_t>::max());
 			break;
 		case AudioStreamFormat::Int8:
-			Transform8_Integer(input, output, outputLength);
+			if (useDither)
+				TransformBlock_Dither<int8_t>(left, right, (int8_t*)output, frameCount, dither);
+			else
+				TransformBlock_Integer<int8_t>(left, right, (int8_t*)output, frameCount, std::numeric_limits<int8_t>::max());
 			break;
 		default:
 			throw new std::exception("Unhandled format:  PlaybackFormatTransformer.h");
@@ -36,45 +74,47 @@ public:
 
 private:
 
-	static void Transform8_Integer(float input, char* output, int& outputLength)
-	{
-		outputLength = sizeof(int8_t);
-
-		int8_t outputSample = input * std::numeric_limits<int8_t>::max();
+	// Largest float below 2^31 (1.0f * INT32_MAX rounds up to 2^31, which overflows)
+	static constexpr float INT32_SCALE = 2147483520.0f;
 
-		std::memcpy(output, &outputSample, outputLength);
-	}
-	static void Transform16_Integer(float input, char* output, int& outputLength)
-	{
-		outputLength = sizeof(int16_t);
-
-		int16_t outputSample = input * std::numeric_limits<int16_t>::max();
-
-		std::memcpy(output, &outputSample, outputLength);
-	}
-	static void Transform32_Integer(float input, char* output, int& outputLength)
+	static float Clamp(float sample)
 	{
-		outputLength = sizeof(int32_t);
-
-		int32_t outputSample = input * std::numeric_limits<int32_t>::max();
-
-		std::memcpy(output, &outputSample, outputLength);
+		return sample < -1.0f ? -1.0f : (sample > 1.0f ? 1.0f : sample);
 	}
 
-	static void Transform8_Float(float input, char* output, int& outputLength)
+	static void TransformBlock_Float32(const float* left, const float* right, float* output, int frameCount)
 	{
-		throw new std::exception("Unhandled format type:  PlaybackFormatTransfomer.h");
+		for (int index = 0; index < frameCount; index++)
+		{
+			output[2 * index] = Clamp(left[index]);
+			output[(2 * index) + 1] = Clamp(right[index]);
+		}
 	}
-	static void Transform16_Float(float input, char* output, int& outputLength)
+
+	template<typename TInteger>
+	static void TransformBlock_Integer(const float* left, const float* right, TInteger* output, int frameCount, float scale)
 	{
-		throw new std::exception("Unhandled format type:  PlaybackFormatTransfomer.h");
+		for (int index = 0; index < frameCount; index++)
+		{
+			output[2 * index] = (TInteger)std::floor((Clamp(left[index]) * scale) + 0.5f);
+			output[(2 * index) + 1] = (TInteger)std::floor((Clamp(right[index]) * scale) + 0.5f);
+		}
 	}
-	static void Transform32_Float(float input, char* output, int& outputLength)
+
+	template<typename TInteger>
+	static void TransformBlock_Dither(const float* left, const float* right, TInteger* output, int frameCount, PlaybackDither* dither)
 	{
-		outputLength = sizeof(float);
+		const float scale = std::numeric_limits<TInteger>::max();
+		const float minimum = std::numeric_limits<TInteger>::min();
+		const float maximum = std::numeric_limits<TInteger>::max();
 
-		std::memcpy(output, &input, outputLength);
+		// (The error feedback is serial; so this loop is not vectorized)
+		for (int index = 0; index < frameCount; index++)
+		{
+			output[2 * index] = (TInteger)dither->Quantize(Clamp(left[index]) * scale, true, minimum, maximum);
+			output[(2 * index) + 1] = (TInteger)dither->Quantize(Clamp(right[index]) * scale, false, minimum, maximum);
+		}
 	}
 };
 
-#endif
\ No newline at end of file
+#endif
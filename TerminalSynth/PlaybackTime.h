@@ -26,6 +26,29 @@ struct PlaybackTime
 	{
 		return frameCursor / samplingRate;
 	}
+
+	/// <summary>
+	/// Returns a copy of the playback time, offset by the provided number of frames. This is used
+	/// to get the time of a frame inside of a block (or sub-block).
+	/// </summary>
+	PlaybackTime Offset(int frameCount, float samplingRate) const
+	{
+		PlaybackTime result;
+
+		result.streamTime = streamTime + (frameCount / (double)samplingRate);
+		result.frameCursor = frameCursor + frameCount;
+
+		return result;
+	}
+
+	/// <summary>
+	/// Advances the playback time by the provided number of frames
+	/// </summary>
+	void Advance(int frameCount, float samplingRate)
+	{
+		streamTime += frameCount / (double)samplingRate;
+		frameCursor += frameCount;
+	}
 };
 
 #endif
\ No newline at end of file
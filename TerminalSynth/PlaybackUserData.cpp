@@ -3,6 +3,7 @@
 #include "PlaybackInfo.h"
 #include "PlaybackUserData.h"
 #include "SignalSettings.h"
+#include "SnapshotBuffer.h"
 #include "SoundRegistry.h"
 #include "SynthSettingsLoader.h"
 #include <exception>
@@ -17,6 +18,7 @@ PlaybackUserData::PlaybackUserData(SynthSettingsLoader* synthSettingsLoader)
 	_deviceRegister = new PlaybackDeviceRegister();
 	_equalizer = new EqualizerOutput(FFT_INPUT_SIZE, FFT_OUTPUT_SIZE);
 	_effectList = new std::vector<SignalSettings*>();
+	_synthSettingsSnapshot = nullptr;
 
 	_initialized = false;
 }
@@ -29,10 +31,10 @@ PlaybackUserData::~PlaybackUserData()
 	}
 
 	delete _effectList;
+	delete _synthSettingsSnapshot;
 	delete _deviceRegister;
 	delete _equalizer;
 	delete _playbackInfo;
-	delete _equalizer;
 }
 bool PlaybackUserData::Initialize()
 {
@@ -49,6 +51,9 @@ bool PlaybackUserData::Initialize()
 		_effectList->push_back(new SignalSettings(effectList[index]));
 	}
 
+	// MEMORY! ~PlaybackUserData
+	_synthSettingsSnapshot = new SnapshotBuffer<SynthSettings>(*_synthSettingsLoader->GetCurrent());
+
 	_initialized = true;
 
 	return success;
@@ -69,6 +74,14 @@ void PlaybackUserData::SelectDevice(const std::string& deviceName)
 	_deviceRegister->SelectDevice(deviceName);
 }
 
+void PlaybackUserData::PublishSynthSettings()
+{
+	if (!_initialized)
+		throw new std::exception("Trying to publish synth settings before PlaybackUserData* is initialized");
+
+	_synthSettingsSnapshot->Publish(*_synthSettingsLoader->GetCurrent());
+}
+
 void PlaybackUserData::SaveSynthSettings()
 {
 	_synthSettingsLoader->SaveConfiguration();
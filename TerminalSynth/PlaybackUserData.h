@@ -5,6 +5,7 @@
 #include "PlaybackDeviceRegister.h"
 #include "PlaybackInfo.h"
 #include "SignalSettings.h"
+#include "SnapshotBuffer.h"
 #include "SoundRegistry.h"
 #include "SynthSettings.h"
 #include "SynthSettingsLoader.h"
@@ -24,6 +25,7 @@ public:
 	bool Initialize();
 
 	SynthSettings* GetSynthSettings() const { return _synthSettingsLoader->GetCurrent(); }
+	SnapshotBuffer<SynthSettings>* GetSynthSettingsSnapshot() const { return _synthSettingsSnapshot; }
 	SoundRegistry* GetEffectRegistry() const { return _effectRegistry; }
 	PlaybackInfo* GetPlaybackInfo() const { return _playbackInfo; }
 	EqualizerOutput* GetEqualizer() const { return _equalizer; }
@@ -43,6 +45,11 @@ public:
 	/// </summary>
 	void SelectDevice(const std::string& deviceName);
 
+	/// <summary>
+	/// (UI Thread) Publishes a copy of the current synth settings for the audio thread (see GetSynthSettingsSnapshot)
+	/// </summary>
+	void PublishSynthSettings();
+
 	/// <summary>
 	/// Saves synth settings in the current configuration
 	/// </summary>
@@ -56,6 +63,10 @@ private:
 	std::vector<SignalSettings*>* _effectList;
 
 	SynthSettingsLoader* _synthSettingsLoader;
+
+	// Immutable copies of the current SynthSettings* for the audio thread (published by the UI thread)
+	SnapshotBuffer<SynthSettings>* _synthSettingsSnapshot;
+
 	SoundRegistry* _effectRegistry;
 	PlaybackInfo* _playbackInfo;
 	PlaybackDeviceRegister* _deviceRegister;
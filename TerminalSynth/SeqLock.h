@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+/// <summary>
+/// Sequence lock for publishing a fixed length array of T from one (writer) thread to any number of readers. The
+/// writer never waits:  it makes the sequence odd, stores the values, and makes it even again. A reader retries
+/// if the sequence was odd, or changed, while it was copying. The values are stored as relaxed atomics (with
+/// fences around them); so a torn copy is detected, and discarded, instead of being a data race.
+/// </summary>
+/// <typeparam name="T">Trivially copyable element type (float, int, ...)</typeparam>
+template<typename T>
+class SeqLock
+{
+public:
+
+	SeqLock(size_t length)
+	{
+		_length = length;
+
+		// MEMORY! ~SeqLock
+		_values = new std::atomic<T>[length];
+
+		for (size_t index = 0; index < length; index++)
+			_values[index].store(T());
+
+		_sequence.store(0);
+	}
+	~SeqLock()
+	{
+		delete[] _values;
+	}
+
+	SeqLock(const SeqLock& copy) = delete;
+	SeqLock& operator=(const SeqLock& copy) = delete;
+
+	size_t GetLength() const { return _length; }
+
+	/// <summary>
+	/// (Writer Thread) Publishes GetLength() values from the source
+	/// </summary>
+	void Write(const T* source)
+	{
+		size_t sequence = _sequence.load(std::memory_order_relaxed);
+
+		_sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (size_t index = 0; index < _length; index++)
+			_values[index].store(source[index], std::memory_order_relaxed);
+
+		_sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// (Reader Thread) Copies GetLength() values into the destination. Returns false if the writer was publishing
+	/// during the copy (the destination is then incomplete).
+	/// </summary>
+	bool TryRead(T* destination) const
+	{
+		size_t sequence = _sequence.load(std::memory_order_acquire);
+
+		if (sequence & 1)
+			return false;
+
+		for (size_t index = 0; index < _length; index++)
+			destination[index] = _values[index].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		return _sequence.load(std::memory_order_relaxed) == sequence;
+	}
+
+	/// <summary>
+	/// (Reader Thread) Copies GetLength() values into the destination, retrying until the copy is consistent
+	/// </summary>
+	void Read(T* destination) const
+	{
+		while (!TryRead(destination))
+			std::this_thread::yield();
+	}
+
+private:
+
+	std::atomic<T>* _values;
+	size_t _length;
+
+	// Odd while the writer is publishing
+	std::atomic<size_t> _sequence;
+};
+
+#endif
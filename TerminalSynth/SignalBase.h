@@ -3,6 +3,7 @@
 #ifndef SIGNALBASE_H
 #define SIGNALBASE_H
 
+#include "AudioBlock.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -46,11 +47,26 @@ public:
 		frame->AddFrame(localFrame.GetLeft(), localFrame.GetRight());
 	}
 
+	/// <summary>
+	/// Function to call to process a block of frames, overwriting the block's data. This is the primary
+	/// render path; and the per-sample functions are kept for single frame callers.
+	/// </summary>
+	virtual void ProcessBlock(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+	{
+		ProcessBlockImpl(block, playbackTime, frameCount);
+	}
+
 	/// <summary>
 	/// Function used to alert the caller that the SignalBase* component still has output.
 	/// </summary>
 	virtual bool HasOutput(const PlaybackTime* playbackTime) const = 0;
 
+	/// <summary>
+	/// Returns true if the component can process a mono block (see AudioBlock::IsMono) on its left channel
+	/// only; and keep it mono. Otherwise, a mono block is widened to stereo before it is processed.
+	/// </summary>
+	virtual bool IsMonoCapable() const { return false; }
+
 	/// <summary>
 	/// Function called when the note is engaged, causing the SignalBase* to become engaged.
 	/// </summary>
@@ -79,6 +95,26 @@ protected:
 	/// </summary>
 	virtual void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) = 0;
 
+	/// <summary>
+	/// Function to process a block of frames (in place). The default is an adapter to the per-sample
+	/// SetFrameImpl(..); so sub-classes should override this when they can process the block directly.
+	/// </summary>
+	virtual void ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+	{
+		PlaybackFrame frame;
+
+		for (int index = 0; index < frameCount; index++)
+		{
+			PlaybackTime frameTime = playbackTime->Offset(index, block->GetSamplingRate());
+
+			block->GetFrame(index, &frame);
+
+			SetFrameImpl(&frame, &frameTime);
+
+			block->SetFrame(index, &frame);
+		}
+	}
+
 	/// <summary>
 	/// Returns a const pointer to the output settings
 	/// </summary>
@@ -1,3 +1,5 @@
+#include "AudioBlock.h"
+#include "Constant.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
@@ -5,16 +7,51 @@
 #include "SignalChainSettings.h"
 #include "SignalParameterizedBase.h"
 #include "SignalSettings.h"
+#include "SilenceDetector.h"
 #include "SoundRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <string>
+#include <utility>
 #include <vector>
 
 SignalChain::SignalChain()
 {
 	_chain = new std::vector<SignalParameterizedBase*>();
+	_nodes = new std::vector<NodeState>();
+	_retired = new std::vector<SignalParameterizedBase*>();
+	_dryLeft = new float[AUDIO_BLOCK_SIZE];
+	_dryRight = new float[AUDIO_BLOCK_SIZE];
+	_topologyHashCode = 0;
+	_samplingRate = 0;
+	_silenceThreshold = SILENCE_THRESHOLD_DB;
+	_silenceHoldSeconds = SILENCE_HOLD_SECONDS;
+	_fadeFrames = 0;
+
+	// Chain edits (see Adopt) must not allocate on the audio thread
+	_chain->reserve(SIGNAL_CHAIN_CAPACITY);
+	_nodes->reserve(SIGNAL_CHAIN_CAPACITY);
+	_retired->reserve(SIGNAL_CHAIN_CAPACITY);
 }
 SignalChain::SignalChain(const SignalChain& copy)
 {
 	_chain = new std::vector<SignalParameterizedBase*>(*copy.GetChain());
+	_nodes = new std::vector<NodeState>(*copy._nodes);
+	_retired = new std::vector<SignalParameterizedBase*>();
+	_dryLeft = new float[AUDIO_BLOCK_SIZE];
+	_dryRight = new float[AUDIO_BLOCK_SIZE];
+	_topologyHashCode = copy._topologyHashCode;
+	_samplingRate = copy._samplingRate;
+	_silenceThreshold = copy._silenceThreshold;
+	_silenceHoldSeconds = copy._silenceHoldSeconds;
+	_fadeFrames = copy._fadeFrames;
+
+	_chain->reserve(SIGNAL_CHAIN_CAPACITY);
+	_nodes->reserve(SIGNAL_CHAIN_CAPACITY);
+	_retired->reserve(SIGNAL_CHAIN_CAPACITY);
 }
 SignalChain::~SignalChain()
 {
@@ -22,12 +59,52 @@ SignalChain::~SignalChain()
 	//
 
 	delete _chain;
+	delete _nodes;
+	delete _retired;
+	delete[] _dryLeft;
+	delete[] _dryRight;
+}
+
+SignalChain::NodeState SignalChain::CreateNodeState(const SignalParameterizedBase* effect) const
+{
+	NodeState node;
+
+	node.nameHash = std::hash<std::string>{}(effect->GetName());
+	node.detector.Configure(_silenceThreshold, _silenceHoldSeconds, _samplingRate);
+	node.fadeDirection = 0;
+	node.fadePosition = 0;
+
+	return node;
+}
+
+void SignalChain::SetSilenceDetection(float thresholdDecibels, float holdSeconds)
+{
+	_silenceThreshold = thresholdDecibels;
+	_silenceHoldSeconds = holdSeconds;
+
+	for (int index = 0; index < _nodes->size(); index++)
+	{
+		_nodes->at(index).detector.Configure(_silenceThreshold, _silenceHoldSeconds, _samplingRate);
+	}
 }
 
 void SignalChain::Initialize(const SoundRegistry* effectRegistry, const SignalChainSettings* signalChainSettings, const PlaybackInfo* parameters)
 {
+	Initialize(effectRegistry, signalChainSettings, parameters, std::numeric_limits<int>::max());
+}
+void SignalChain::Initialize(const SoundRegistry* effectRegistry, const SignalChainSettings* signalChainSettings, const PlaybackInfo* parameters, int maxCount)
+{
+	_samplingRate = parameters->GetStreamInfo()->streamSampleRate;
+	_fadeFrames = (int)(SIGNAL_CHAIN_CROSSFADE_SECONDS * _samplingRate);
+	_topologyHashCode = signalChainSettings->GetTopologyHashCode();
+
+	if (signalChainSettings->GetEnabledCount() > maxCount)
+		throw new std::exception("Signal chain has more enabled effects than its limit (see SYNTH_VOICE_EFFECT_MAX):  SignalChain.cpp");
+
+	maxCount = std::min(maxCount, SIGNAL_CHAIN_CAPACITY);
+
 	// Add
-	for (int index = 0; index < signalChainSettings->GetCount(); index++)
+	for (int index = 0; index < signalChainSettings->GetCount() && _chain->size() < maxCount; index++)
 	{
 		SignalSettings* settings = signalChainSettings->Get(index);
 
@@ -39,20 +116,98 @@ void SignalChain::Initialize(const SoundRegistry* effectRegistry, const SignalCh
 		SignalParameterizedBase* effect = effectRegistry->Checkout(settings->GetName());
 
 		_chain->push_back(effect);
+		_nodes->push_back(CreateNodeState(effect));
 	}
 }
-void SignalChain::Update(SoundRegistry* effectRegistry, const SignalChainSettings* signalChainSettings)
+void SignalChain::Adopt(SignalChain* previous)
 {
-	// Checkin (preserve memory cache)
-	for (int index = _chain->size() - 1; index >= 0; index--)
+	int previousCount = previous->GetCount();
+
+	// Position (in this chain) of each kept node of the previous chain (or -1)
+	int keptPositions[SIGNAL_CHAIN_CAPACITY];
+
+	for (int index = 0; index < previousCount; index++)
+		keptPositions[index] = -1;
+
+	int searchStart = 0;
+
+	// Kept:  Matched in order; and exchanged, so that the state carries over (the new instance goes back with
+	//		  the previous chain)
+	for (int index = 0; index < _chain->size(); index++)
 	{
-		effectRegistry->Checkin(_chain->at(index));
+		for (int previousIndex = searchStart; previousIndex < previousCount; previousIndex++)
+		{
+			NodeState& previousNode = previous->_nodes->at(previousIndex);
 
-		_chain->pop_back();
+			if (previousNode.nameHash != _nodes->at(index).nameHash || previousNode.fadeDirection < 0)
+				continue;
+
+			std::swap(_chain->at(index), previous->_chain->at(previousIndex));
+			std::swap(_nodes->at(index), previous->_nodes->at(previousIndex));
+
+			keptPositions[previousIndex] = index;
+			searchStart = previousIndex + 1;
+			break;
+		}
+
+		// Inserted:  Faded in
+		if (searchStart == 0 || keptPositions[searchStart - 1] != index)
+		{
+			_nodes->at(index).fadeDirection = 1;
+			_nodes->at(index).fadePosition = 0;
+		}
+	}
+
+	// Removed:  Moved into this chain (before the next kept node), and faded out. They are inserted from the
+	//			 back; so the positions of the earlier nodes do not move.
+	int insertPosition = _chain->size();
+
+	for (int previousIndex = previousCount - 1; previousIndex >= 0; previousIndex--)
+	{
+		if (keptPositions[previousIndex] >= 0)
+		{
+			insertPosition = keptPositions[previousIndex];
+			continue;
+		}
+
+		NodeState& previousNode = previous->_nodes->at(previousIndex);
+
+		// Already fading out (a quick edit), or the chain is full:  Left to the previous chain (cut)
+		if (previousNode.fadeDirection < 0 || _chain->size() + _retired->size() >= SIGNAL_CHAIN_CAPACITY)
+			continue;
+
+		NodeState node = previousNode;
+
+		node.fadeDirection = -1;
+		node.fadePosition = 0;
+		node.detector.Wake();
+
+		_chain->insert(_chain->begin() + insertPosition, previous->_chain->at(previousIndex));
+		_nodes->insert(_nodes->begin() + insertPosition, node);
+
+		previous->_chain->erase(previous->_chain->begin() + previousIndex);
+		previous->_nodes->erase(previous->_nodes->begin() + previousIndex);
+	}
+}
+
+void SignalChain::EngageInserted(const PlaybackTime* playbackTime)
+{
+	for (int index = 0; index < _chain->size(); index++)
+	{
+		if (_nodes->at(index).fadeDirection > 0)
+			_chain->at(index)->Engage(playbackTime);
 	}
+}
 
-	// Checkout (from registry)
-	for (int index = 0; index < signalChainSettings->GetCount(); index++)
+void SignalChain::UpdateParameters(const SignalChainSettings* signalChainSettings)
+{
+	// Chain Edit:  Not adopted yet (see SynthChainEdit)
+	if (signalChainSettings->GetTopologyHashCode() != _topologyHashCode)
+		return;
+
+	int chainIndex = 0;
+
+	for (int index = 0; index < signalChainSettings->GetCount() && chainIndex < _chain->size(); index++)
 	{
 		SignalSettings* settings = signalChainSettings->Get(index);
 
@@ -60,21 +215,168 @@ void SignalChain::Update(SoundRegistry* effectRegistry, const SignalChainSetting
 		if (!settings->GetIsEnabled())
 			continue;
 
-		// DO NOT DELETE! (these are all handled by the SoundRegistry*)
-		SignalParameterizedBase* effect = effectRegistry->Checkout(settings->GetName());
+		// Fading Out:  Not part of the settings (see Adopt)
+		while (chainIndex < _chain->size() && _nodes->at(chainIndex).fadeDirection < 0)
+			chainIndex++;
 
-		// OPTIMIZE!
-		effect->Update(settings);
+		if (chainIndex < _chain->size())
+			_chain->at(chainIndex++)->Update(settings);
+	}
+}
 
-		_chain->push_back(effect);
+void SignalChain::Release(SoundRegistry* effectRegistry)
+{
+	// Checkin (preserve memory cache)
+	for (int index = _chain->size() - 1; index >= 0; index--)
+	{
+		effectRegistry->Checkin(_chain->at(index));
+
+		_chain->pop_back();
+	}
+
+	for (int index = 0; index < _retired->size(); index++)
+	{
+		effectRegistry->Checkin(_retired->at(index));
+	}
+
+	_nodes->clear();
+	_retired->clear();
+}
+
+void SignalChain::RetireNode(int index)
+{
+	_retired->push_back(_chain->at(index));
+
+	_chain->erase(_chain->begin() + index);
+	_nodes->erase(_nodes->begin() + index);
+}
+
+bool SignalChain::ApplyFade(NodeState& node, const float* dryLeft, const float* dryRight, float* left, float* right, int frameCount)
+{
+	const float quarterCycle = 0.5f * std::numbers::pi_v<float>;
+
+	for (int index = 0; index < frameCount; index++)
+	{
+		float position = std::min((node.fadePosition + index) / (float)std::max(_fadeFrames, 1), 1.0f);
+
+		// Equal Power
+		float fadeIn = std::sin(quarterCycle * position);
+		float fadeOut = std::cos(quarterCycle * position);
+
+		float wet = node.fadeDirection > 0 ? fadeIn : fadeOut;
+		float dry = node.fadeDirection > 0 ? fadeOut : fadeIn;
+
+		left[index] = (wet * left[index]) + (dry * dryLeft[index]);
+
+		if (right != nullptr)
+			right[index] = (wet * right[index]) + (dry * dryRight[index]);
 	}
+
+	node.fadePosition += frameCount;
+
+	if (node.fadePosition < _fadeFrames)
+		return false;
+
+	// Faded In
+	if (node.fadeDirection > 0)
+	{
+		node.fadeDirection = 0;
+		return false;
+	}
+
+	return true;
 }
 
 void SignalChain::SetFrame(PlaybackFrame* frame, const PlaybackTime* playbackTime)
 {
+	float peak = std::fmax(std::fabs(frame->GetLeft()), std::fabs(frame->GetRight()));
+
 	for (int index = 0; index < _chain->size(); index++)
 	{
+		NodeState& node = _nodes->at(index);
+
+		bool inputSilent = node.detector.IsSilent(peak);
+
+		// Crossfade (see Adopt)
+		if (node.fadeDirection != 0)
+		{
+			float dryLeft = frame->GetLeft();
+			float dryRight = frame->GetRight();
+
+			_chain->at(index)->SetFrame(frame, playbackTime);
+
+			float left = frame->GetLeft();
+			float right = frame->GetRight();
+
+			bool finished = ApplyFade(node, &dryLeft, &dryRight, &left, &right, 1);
+
+			frame->SetFrame(left, right);
+
+			peak = std::fmax(std::fabs(left), std::fabs(right));
+
+			if (finished)
+				RetireNode(index--);
+
+			continue;
+		}
+
+		// Asleep:  Bypassed (the frame is unchanged)
+		if (node.detector.IsAsleep() && inputSilent)
+			continue;
+
 		_chain->at(index)->SetFrame(frame, playbackTime);
+
+		peak = std::fmax(std::fabs(frame->GetLeft()), std::fabs(frame->GetRight()));
+
+		node.detector.Update(inputSilent && node.detector.IsSilent(peak), 1);
+	}
+}
+
+void SignalChain::ProcessBlock(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+{
+	// The output peak of each node is the input peak of the next (a sleeping node leaves the block unchanged)
+	float peak = SilenceDetector::GetPeak(block->GetLeft(), block->GetRightSignal(), frameCount);
+
+	for (int index = 0; index < _chain->size(); index++)
+	{
+		NodeState& node = _nodes->at(index);
+
+		bool inputSilent = node.detector.IsSilent(peak);
+
+		// Asleep:  Bypassed, until there is input (a crossfading node is always processed)
+		if (node.detector.IsAsleep() && inputSilent && node.fadeDirection == 0)
+			continue;
+
+		// Mono:  Widened to stereo at the first node that needs both channels
+		if (block->IsMono() && !_chain->at(index)->IsMonoCapable())
+			block->Widen(frameCount);
+
+		// Crossfade:  Dry input (see Adopt)
+		if (node.fadeDirection != 0)
+		{
+			std::copy(block->GetLeft(), block->GetLeft() + frameCount, _dryLeft);
+
+			if (!block->IsMono())
+				std::copy(block->GetRight(), block->GetRight() + frameCount, _dryRight);
+		}
+
+		_chain->at(index)->ProcessBlock(block, playbackTime, frameCount);
+
+		if (node.fadeDirection != 0)
+		{
+			bool finished = ApplyFade(node, _dryLeft, _dryRight, block->GetLeft(), block->IsMono() ? nullptr : block->GetRight(), frameCount);
+
+			peak = SilenceDetector::GetPeak(block->GetLeft(), block->GetRightSignal(), frameCount);
+
+			if (finished)
+				RetireNode(index--);
+
+			continue;
+		}
+
+		peak = SilenceDetector::GetPeak(block->GetLeft(), block->GetRightSignal(), frameCount);
+
+		node.detector.Update(inputSilent && node.detector.IsSilent(peak), frameCount);
 	}
 }
 
@@ -93,14 +395,40 @@ void SignalChain::DisEngage(const PlaybackTime* playbackTime)
 	}
 }
 
+void SignalChain::Clear()
+{
+	for (int index = 0; index < _chain->size(); index++)
+	{
+		_chain->at(index)->Clear();
+		_nodes->at(index).detector.Wake();
+	}
+}
+
+int SignalChain::GetCount() const
+{
+	return _chain->size();
+}
+
 bool SignalChain::HasOutput(const PlaybackTime* playbackTime) const
 {
 	bool hasOutput = false;
 
+	// Sleeping nodes have no output (see SilenceDetector)
 	for (int index = 0; index < _chain->size() && !hasOutput; index++)
 	{
-		hasOutput |= _chain->at(index)->HasOutput(playbackTime);
+		hasOutput |= !_nodes->at(index).detector.IsAsleep() && _chain->at(index)->HasOutput(playbackTime);
 	}
 
 	return hasOutput;
-}
\ No newline at end of file
+}
+
+bool SignalChain::IsAsleep() const
+{
+	for (int index = 0; index < _nodes->size(); index++)
+	{
+		if (!_nodes->at(index).detector.IsAsleep())
+			return false;
+	}
+
+	return true;
+}
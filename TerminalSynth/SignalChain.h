@@ -3,16 +3,25 @@
 #ifndef SIGNAL_CHAIN_H
 #define SIGNAL_CHAIN_H
 
+#include "AudioBlock.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "SignalChainSettings.h"
 #include "SignalParameterizedBase.h"
+#include "SilenceDetector.h"
 #include "SoundRegistry.h"
+#include <cstddef>
 #include <vector>
 
 /// <summary>
-/// Container class for a chain of SignalBase* instances
+/// Container class for a chain of SignalBase* instances. Each node has a SilenceDetector:  A node whose input, and
+/// output, have been silent for the hold time is put to sleep (bypassed, with its state kept); and it is woken by
+/// the next input above the threshold. So, an idle chain costs one peak scan per block.
+///
+/// Chain Edits:  A new chain (built off the audio thread, see SynthChainEdit) takes over the nodes of the chain it
+/// replaces (see Adopt), so unchanged effects keep their state. Only the inserted, and removed, effects change; and
+/// they are crossfaded (equal power) in, and out, of the signal path instead of switching between two samples.
 /// </summary>
 class SignalChain
 {
@@ -24,23 +33,127 @@ public:
 
 	void Initialize(const SoundRegistry* effectRegistry, const SignalChainSettings* signalChainSettings, const PlaybackInfo* parameters);
 
-	void Update(SoundRegistry* effectRegistry, const SignalChainSettings* signalChainSettings);
+	/// <summary>
+	/// Initializes the chain with the enabled effects of the settings. Throws an exception if there are more than
+	/// maxCount enabled effects.
+	/// </summary>
+	void Initialize(const SoundRegistry* effectRegistry, const SignalChainSettings* signalChainSettings, const PlaybackInfo* parameters, int maxCount);
+
+	/// <summary>
+	/// (Audio Thread) Takes over the nodes of the previous chain (that is being replaced by this one). Kept effects
+	/// exchange instances with the previous chain (so their state carries over); inserted effects are faded in; and
+	/// removed effects are moved into this chain, and faded out. Nothing is allocated:  The previous chain is left
+	/// with the instances to check in (see Release).
+	/// </summary>
+	void Adopt(SignalChain* previous);
+
+	/// <summary>
+	/// (Audio Thread) Engages the effects that were inserted by Adopt (the nodes fading in)
+	/// </summary>
+	void EngageInserted(const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// Updates the effect parameters only. The settings are skipped if their topology (see SignalChainSettings::
+	/// GetTopologyHashCode) is not the one the chain was built for:  The chain edit has not been adopted yet. This
+	/// does not use the SoundRegistry*; so it is safe for the audio thread.
+	/// </summary>
+	void UpdateParameters(const SignalChainSettings* signalChainSettings);
+
+	/// <summary>
+	/// Checks all effects (including those that have been faded out) back in to the SoundRegistry*, leaving the
+	/// chain empty
+	/// </summary>
+	void Release(SoundRegistry* effectRegistry);
 
 	void SetFrame(PlaybackFrame* frame, const PlaybackTime* playbackTime);
+	void ProcessBlock(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount);
 	bool HasOutput(const PlaybackTime* playbackTime) const;
 
 	void Engage(const PlaybackTime* playbackTime);
 	void DisEngage(const PlaybackTime* playbackTime);
 
+	/// <summary>
+	/// Clears the signal history of the effects (see SignalBase::Clear); and wakes the nodes
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Returns the number of effects in the chain
+	/// </summary>
+	int GetCount() const;
+
+	/// <summary>
+	/// Sets the silence threshold (dB, peak), and hold time (seconds), of the nodes (see SilenceDetector)
+	/// </summary>
+	void SetSilenceDetection(float thresholdDecibels, float holdSeconds);
+
+	/// <summary>
+	/// Returns true if every node of the chain is asleep (see SilenceDetector)
+	/// </summary>
+	bool IsAsleep() const;
+
 protected:
 
 	//SHARED POINTERS!  These effects are held by the SoundRegistry*
 	std::vector<SignalParameterizedBase*>* GetChain() const { return _chain; }
 
+private:
+
+	/// <summary>
+	/// State of each node of the chain (in the same order)
+	/// </summary>
+	struct NodeState
+	{
+		// Effect name (hash), used to match the nodes of two chains (see Adopt)
+		size_t nameHash;
+
+		SilenceDetector detector;
+
+		// Crossfade:  +1 fading in, -1 fading out, 0 none (see Adopt); and the frames faded so far
+		int fadeDirection;
+		int fadePosition;
+	};
+
+private:
+
+	/// <summary>
+	/// Creates the state for a node of the effect
+	/// </summary>
+	NodeState CreateNodeState(const SignalParameterizedBase* effect) const;
+
+	/// <summary>
+	/// Mixes the dry (input), and wet (output), frames of a node that is crossfading; and advances the fade.
+	/// Returns true when a node that was fading out has finished.
+	/// </summary>
+	bool ApplyFade(NodeState& node, const float* dryLeft, const float* dryRight, float* left, float* right, int frameCount);
+
+	/// <summary>
+	/// (Audio Thread) Removes a node that has faded out (see Release)
+	/// </summary>
+	void RetireNode(int index);
+
 private:
 
 	// SHARED POINTERS!  These effects are not created here! They are created and stored by the SoundRegistry*
 	std::vector<SignalParameterizedBase*>* _chain;
+
+	// Node state (silence detection, and crossfade) for each node of the chain (in the same order)
+	std::vector<NodeState>* _nodes;
+
+	// SHARED POINTERS!  Effects that have faded out (checked in by Release)
+	std::vector<SignalParameterizedBase*>* _retired;
+
+	// Dry input of a crossfading node (AUDIO_BLOCK_SIZE)
+	float* _dryLeft;
+	float* _dryRight;
+
+	// Topology of the settings the chain was built for (see UpdateParameters)
+	size_t _topologyHashCode;
+
+	float _samplingRate;
+	float _silenceThreshold;
+	float _silenceHoldSeconds;
+	int _fadeFrames;
 };
 
 #endif
\ No newline at end of file
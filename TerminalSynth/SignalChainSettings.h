@@ -4,7 +4,9 @@
 #define SIGNAL_CHAIN_SETTINGS_H
 
 #include "SignalSettings.h"
+#include "Utility.h"
 #include <exception>
+#include <functional>
 #include <istream>
 #include <iterator>
 #include <ostream>
@@ -51,6 +53,22 @@ public:
 
 	int GetCount() const { return _chain->size(); }
 
+	/// <summary>
+	/// Returns the number of enabled effects (the nodes of a SignalChain* built from these settings)
+	/// </summary>
+	int GetEnabledCount() const
+	{
+		int count = 0;
+
+		for (int index = 0; index < _chain->size(); index++)
+		{
+			if (_chain->at(index)->GetIsEnabled())
+				count++;
+		}
+
+		return count;
+	}
+
 	SignalSettings* Get(int index) const
 	{
 		return _chain->at(index);
@@ -91,6 +109,29 @@ public:
 
 		_chain->erase(iter);
 	}
+	/// <summary>
+	/// Returns a hash of the enabled effects (by name, in order). Parameter values are not included; so this
+	/// changes only when a SignalChain* built from these settings would have to be re-built.
+	/// </summary>
+	size_t GetTopologyHashCode() const
+	{
+		std::hash<std::string> stringHasher;
+
+		size_t hash = 0;
+
+		for (int index = 0; index < _chain->size(); index++)
+		{
+			if (!_chain->at(index)->GetIsEnabled())
+				continue;
+
+			size_t nextHash = stringHasher(_chain->at(index)->GetName());
+
+			TerminalSynth::HashCombine(hash, nextHash);
+		}
+
+		return hash;
+	}
+
 	bool Contains(const std::string& name) const
 	{
 		for (int index = 0; index < _chain->size(); index++)
@@ -1,73 +1,105 @@
-#include "PlaybackTime.h"
 #include "SignalFactoryCore.h"
-#include <algorithm>
 #include <cmath>
 #include <numbers>
 
-float SignalFactoryCore::GenerateTriangleSample(float frequency, float samplingRate, float signalHigh, float signalLow, const PlaybackTime* playbackTime)
+float SignalFactoryCore::GenerateTriangleSample(double phase, float signalHigh, float signalLow)
 {
-	float period = 1 / frequency;
-	float periodQuarter = 0.25f * period;
-	float high = signalHigh;
-	float low = signalLow;
-	float sample = 0;
+	// Normalized [-1, 1]:  Rises from 0, peaks at 0.25, and bottoms out at 0.75
+	double sample = phase < 0.25 ? 4.0 * phase :
+					phase < 0.75 ? 2.0 - (4.0 * phase) :
+								   (4.0 * phase) - 4.0;
 
-	// Using modulo arithmetic to get the relative period time
-	float periodTime = fmod(playbackTime->FromCursor(samplingRate), period);
+	return (0.5f * (signalHigh - signalLow) * sample) + (0.5f * (signalHigh + signalLow));
+}
 
-	// First Quadrant
-	if (periodTime < periodQuarter)
-	{
-		sample = (2.0 * (high - low) / period) * periodTime;
-	}
+float SignalFactoryCore::GenerateSquareSample(double phase, float signalHigh, float signalLow)
+{
+	return phase < 0.5 ? signalHigh : signalLow;
+}
 
-	// Second Quadrant
-	else if (periodTime < (2.0 * periodQuarter))
-	{
-		sample = ((-2.0 * (high - low) / period) * (periodTime - (float)periodQuarter)) - low;
-	}
+float SignalFactoryCore::GenerateSawtoothSample(double phase, float signalHigh, float signalLow)
+{
+	return ((signalHigh - signalLow) * phase) + signalLow;
+}
 
-	// Third Quadrant
-	else if (periodTime < 3.0 * periodQuarter)
-	{
-		sample = (-2.0 * (high - low) / period) * (periodTime - (2.0 * periodQuarter));
-	}
+float SignalFactoryCore::GenerateSineSample(double phase, float signalHigh, float signalLow)
+{
+	return (0.5f * (signalHigh - signalLow) * sinf(2.0 * std::numbers::pi * phase)) + (0.5f * (signalHigh + signalLow));
+}
 
-	// Fourth Quadrant
-	else
-	{
-		sample = ((2.0 * (high - low) / period) * (periodTime - (3.0 * periodQuarter))) + low;
-	}
+float SignalFactoryCore::GenerateSquareSampleBandLimited(double phase, double phaseIncrement, float signalHigh, float signalLow)
+{
+	// Naive (normalized [-1, 1]) with a step correction at each edge
+	double falling = phase + 0.5;
+
+	if (falling >= 1.0)
+		falling -= 1.0;
 
-	return sample;
+	double sample = (phase < 0.5 ? 1.0 : -1.0) + PolyBlep(phase, phaseIncrement) - PolyBlep(falling, phaseIncrement);
+
+	return (0.5f * (signalHigh - signalLow) * sample) + (0.5f * (signalHigh + signalLow));
 }
 
-float SignalFactoryCore::GenerateSquareSample(float frequency, float samplingRate, float signalHigh, float signalLow, const PlaybackTime* playbackTime)
+float SignalFactoryCore::GenerateTriangleSampleBandLimited(double phase, double phaseIncrement, float signalHigh, float signalLow)
 {
-	// Using modulo arithmetic to get the relative period time
-	float period = 1 / frequency;
-	float periodTime = fmod(playbackTime->FromCursor(samplingRate), period);
-	float sample = 0;
+	// Naive (normalized [-1, 1]):  Rises from 0, peaks at 0.25, and bottoms out at 0.75 (see GenerateTriangleSample)
+	double sample = phase < 0.25 ? 4.0 * phase :
+					phase < 0.75 ? 2.0 - (4.0 * phase) :
+								   (4.0 * phase) - 4.0;
+
+	// Corners:  The slope changes by -8 (peak), and +8 (trough) per cycle
+	double peak = phase - 0.25;
+	double trough = phase - 0.75;
+
+	if (peak < 0)
+		peak += 1.0;
 
-	if (periodTime < period / 2.0)
-		sample = signalHigh;
+	if (trough < 0)
+		trough += 1.0;
 
-	else
-		sample = signalLow;
+	sample += 8.0 * phaseIncrement * (PolyBlamp(trough, phaseIncrement) - PolyBlamp(peak, phaseIncrement));
 
-	return sample;
+	return (0.5f * (signalHigh - signalLow) * sample) + (0.5f * (signalHigh + signalLow));
 }
 
-float SignalFactoryCore::GenerateSawtoothSample(float frequency, float samplingRate, float signalHigh, float signalLow, const PlaybackTime* playbackTime)
+float SignalFactoryCore::GenerateSawtoothSampleBandLimited(double phase, double phaseIncrement, float signalHigh, float signalLow)
 {
-	// Using modulo arithmetic to get the relative period time
-	float period = 1 / frequency;
-	float periodTime = fmod(playbackTime->FromCursor(samplingRate), period);
+	// Naive (normalized [-1, 1]) with a step correction at the reset
+	double sample = (2.0 * phase) - 1.0 - PolyBlep(phase, phaseIncrement);
 
-	return (((signalHigh - signalLow) / period) * periodTime) + signalLow;
+	return (0.5f * (signalHigh - signalLow) * sample) + (0.5f * (signalHigh + signalLow));
 }
 
-float SignalFactoryCore::GenerateSineSample(float frequency, float samplingRate, float signalHigh, float signalLow, const PlaybackTime* playbackTime)
+double SignalFactoryCore::PolyBlep(double phase, double phaseIncrement)
 {
-	return (0.5f * (signalHigh - signalLow) * sinf(2.0 * std::numbers::pi * frequency * playbackTime->FromCursor(samplingRate))) + (0.5f * (signalHigh + signalLow));
-}
\ No newline at end of file
+	// Two-sample polynomial residual of a (unit) band-limited step at phase = 0
+	if (phase < phaseIncrement)
+	{
+		double t = phase / phaseIncrement;
+		return t + t - (t * t) - 1.0;
+	}
+	else if (phase > 1.0 - phaseIncrement)
+	{
+		double t = (phase - 1.0) / phaseIncrement;
+		return (t * t) + t + t + 1.0;
+	}
+
+	return 0;
+}
+
+double SignalFactoryCore::PolyBlamp(double phase, double phaseIncrement)
+{
+	// Two-sample polynomial residual of a (unit per sample) band-limited ramp at phase = 0
+	if (phase < phaseIncrement)
+	{
+		double t = (phase / phaseIncrement) - 1.0;
+		return -(t * t * t) / 3.0;
+	}
+	else if (phase > 1.0 - phaseIncrement)
+	{
+		double t = ((phase - 1.0) / phaseIncrement) + 1.0;
+		return (t * t * t) / 3.0;
+	}
+
+	return 0;
+}
@@ -3,20 +3,32 @@
 #ifndef SIGNAL_FACTORY_CORE_H
 #define SIGNAL_FACTORY_CORE_H
 
-#include "PlaybackTime.h"
-
 /// <summary>
 /// Core of SignalFactory* that does not depend on SignalBase*. There can be no filters or complex
-/// SignalBase* effects because there will be a circular dependency.
+/// SignalBase* effects because there will be a circular dependency. The waveforms are functions of the
+/// oscillator phase (in cycles [0, 1)), which is kept by the Oscillator* (phase accumulator).
 /// </summary>
 class SignalFactoryCore
 {
 public:
 
-	static float GenerateTriangleSample(float frequency, float samplingRate, float signalHigh, float signalLow, const PlaybackTime* playbackTime);
-	static float GenerateSquareSample(float frequency, float samplingRate, float signalHigh, float signalLow, const PlaybackTime* playbackTime);
-	static float GenerateSawtoothSample(float frequency, float samplingRate, float signalHigh, float signalLow, const PlaybackTime* playbackTime);
-	static float GenerateSineSample(float frequency, float samplingRate, float signalHigh, float signalLow, const PlaybackTime* playbackTime);
+	static float GenerateTriangleSample(double phase, float signalHigh, float signalLow);
+	static float GenerateSquareSample(double phase, float signalHigh, float signalLow);
+	static float GenerateSawtoothSample(double phase, float signalHigh, float signalLow);
+	static float GenerateSineSample(double phase, float signalHigh, float signalLow);
+
+	/// <summary>
+	/// Band-limited (PolyBLEP) waveforms:  The phase increment (frequency / sampling rate) sets the width of the
+	/// correction around each discontinuity. The triangle uses PolyBLAMP at its corners.
+	/// </summary>
+	static float GenerateSquareSampleBandLimited(double phase, double phaseIncrement, float signalHigh, float signalLow);
+	static float GenerateTriangleSampleBandLimited(double phase, double phaseIncrement, float signalHigh, float signalLow);
+	static float GenerateSawtoothSampleBandLimited(double phase, double phaseIncrement, float signalHigh, float signalLow);
+
+private:
+
+	static double PolyBlep(double phase, double phaseIncrement);
+	static double PolyBlamp(double phase, double phaseIncrement);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,10 +1,10 @@
 #include "Constant.h"
 #include "Envelope.h"
+#include "Oscillator.h"
 #include "OscillatorParameters.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
-#include "SignalFactoryCore.h"
 #include "SignalParameter.h"
 #include "SignalParameterAutomater.h"
 #include <exception>
@@ -27,6 +27,7 @@ SignalParameterAutomater::SignalParameterAutomater()
 	_type = ParameterAutomationType::EnvelopeSweep;
 	_oscillatorType = ParameterAutomationOscillator::Sine;
 	_envelope = new Envelope();
+	_oscillator = new Oscillator();
 }
 
 SignalParameterAutomater::~SignalParameterAutomater()
@@ -34,6 +35,7 @@ SignalParameterAutomater::~SignalParameterAutomater()
 	delete _frame;
 	delete _oscillatorParameters;
 	delete _envelope;
+	delete _oscillator;
 }
 
 void SignalParameterAutomater::Initialize(const PlaybackInfo* parameters)
@@ -77,13 +79,13 @@ float SignalParameterAutomater::GetValue(const PlaybackFrame* frame, const Playb
 		switch (_oscillatorType)
 		{
 		case ParameterAutomationOscillator::Sine:
-			return SignalFactoryCore::GenerateSineSample(_oscillatorFrequency, _samplingRate, _oscillatorParameters->GetSignalHigh(), _oscillatorParameters->GetSignalLow(), playbackTime);
+			return _oscillator->SampleAt(PrimitiveSynthVoices::Sine, playbackTime->frameCursor, _oscillatorFrequency, _samplingRate, _oscillatorParameters->GetSignalHigh(), _oscillatorParameters->GetSignalLow());
 		case ParameterAutomationOscillator::Square:
-			return SignalFactoryCore::GenerateSquareSample(_oscillatorFrequency, _samplingRate, _oscillatorParameters->GetSignalHigh(), _oscillatorParameters->GetSignalLow(), playbackTime);
+			return _oscillator->SampleAt(PrimitiveSynthVoices::Square, playbackTime->frameCursor, _oscillatorFrequency, _samplingRate, _oscillatorParameters->GetSignalHigh(), _oscillatorParameters->GetSignalLow());
 		case ParameterAutomationOscillator::Triangle:
-			return SignalFactoryCore::GenerateTriangleSample(_oscillatorFrequency, _samplingRate, _oscillatorParameters->GetSignalHigh(), _oscillatorParameters->GetSignalLow(), playbackTime);
+			return _oscillator->SampleAt(PrimitiveSynthVoices::Triangle, playbackTime->frameCursor, _oscillatorFrequency, _samplingRate, _oscillatorParameters->GetSignalHigh(), _oscillatorParameters->GetSignalLow());
 		case ParameterAutomationOscillator::Sawtooth:
-			return SignalFactoryCore::GenerateSawtoothSample(_oscillatorFrequency, _samplingRate, _oscillatorParameters->GetSignalHigh(), _oscillatorParameters->GetSignalLow(), playbackTime);
+			return _oscillator->SampleAt(PrimitiveSynthVoices::Sawtooth, playbackTime->frameCursor, _oscillatorFrequency, _samplingRate, _oscillatorParameters->GetSignalHigh(), _oscillatorParameters->GetSignalLow());
 		default:
 			throw new std::exception("Unhandled automation oscillator type:  SignalParameterAutomater.h");
 		}
@@ -5,6 +5,7 @@
 
 #include "Constant.h"
 #include "Envelope.h"
+#include "Oscillator.h"
 #include "OscillatorParameters.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
@@ -60,6 +61,9 @@ private:
 
 	float _oscillatorFrequency;
 
+	// Phase accumulator (advanced by the frames between calls to GetValue)
+	Oscillator* _oscillator;
+
 	Envelope* _envelope;
 };
 
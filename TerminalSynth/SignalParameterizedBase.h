@@ -3,6 +3,7 @@
 #ifndef SIGNAL_PARAMETERIZED_BASE_H
 #define SIGNAL_PARAMETERIZED_BASE_H
 
+#include "AudioBlock.h"
 #include "Constant.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
@@ -11,6 +12,7 @@
 #include "SignalParameter.h"
 #include "SignalParameterAutomater.h"
 #include "SignalSettings.h"
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -22,11 +24,21 @@ public:
 	{
 		_settings = new SignalSettings();
 		_parameterAutomaters = new std::vector<SignalParameterAutomater*>();
+		_automationValues = new std::vector<float>();
+		_automationCursor = 0;
+		_automationValid = false;
+		_automationInterval = PARAMETER_AUTOMATION_INTERVAL;
+		_hasAutomation = false;
 	}
 	SignalParameterizedBase(const SignalSettings& settings) : SignalBase(settings.GetName())
 	{
 		_settings = new SignalSettings(settings);
 		_parameterAutomaters = new std::vector<SignalParameterAutomater*>();
+		_automationValues = new std::vector<float>(_settings->GetParameterCount(), 0.0f);
+		_automationCursor = 0;
+		_automationValid = false;
+		_automationInterval = PARAMETER_AUTOMATION_INTERVAL;
+		_hasAutomation = _settings->HasAutomation();
 
 		for (int index = 0; index < _settings->GetParameterCount(); index++)
 		{
@@ -47,6 +59,7 @@ public:
 		}
 
 		delete _parameterAutomaters;
+		delete _automationValues;
 	}
 
 	virtual void Initialize(const PlaybackInfo* outputSettings)
@@ -67,6 +80,10 @@ public:
 	{
 		_settings->Update(settings, false);		// Catches name change and parameter count change
 
+		// Automation ramps start over from the new settings
+		_automationValid = false;
+		_hasAutomation = _settings->HasAutomation();
+
 		// Parameter Automation
 		for (int index = 0; index < settings->GetParameterCount(); index++)
 		{
@@ -88,7 +105,7 @@ public:
 	void SetFrame(PlaybackFrame* frame, const PlaybackTime* playbackTime) override
 	{
 		// Update Parameters (may have level dependence)
-		UpdateParameterAutomaters(frame, playbackTime);
+		UpdateParameterAutomatersAtControlRate(frame, playbackTime);
 
 		// Set Frame (sub-class)
 		SetFrameImpl(frame, playbackTime);
@@ -106,7 +123,7 @@ public:
 	void AddFrame(PlaybackFrame* frame, const PlaybackTime* playbackTime) override
 	{
 		// Update Parameters (may have level dependence)
-		UpdateParameterAutomaters(frame, playbackTime);
+		UpdateParameterAutomatersAtControlRate(frame, playbackTime);
 
 		PlaybackFrame localFrame(0, 0);
 
@@ -120,6 +137,38 @@ public:
 		frame->AddFrame(localFrame.GetLeft() * output, localFrame.GetRight() * output);
 	}
 
+	/// <summary>
+	/// Function to call to process a block of frames, overwriting the block's data. Parameter automation
+	/// is applied at sub-block boundaries (see GetAutomationInterval), as a ramp, only when it is enabled.
+	/// </summary>
+	void ProcessBlock(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount) override
+	{
+		if (_hasAutomation)
+		{
+			PlaybackFrame frame;
+
+			for (int frameOffset = 0; frameOffset < frameCount; frameOffset += _automationInterval)
+			{
+				int subFrameCount = std::min(_automationInterval, frameCount - frameOffset);
+
+				AudioBlock subBlock(block, frameOffset, subFrameCount);
+				PlaybackTime subBlockTime = playbackTime->Offset(frameOffset, block->GetSamplingRate());
+
+				block->GetFrame(frameOffset, &frame);
+
+				// Update Parameters (may have level dependence)
+				UpdateParameterAutomaters(&frame, &subBlockTime, subFrameCount, block->GetSamplingRate());
+
+				ProcessBlockImpl(&subBlock, &subBlockTime, subFrameCount);
+			}
+		}
+		else
+			ProcessBlockImpl(block, playbackTime, frameCount);
+
+		// Set Output (Gain, Envelope, etc...)
+		ApplyOutputLevel(block, playbackTime, frameCount);
+	}
+
 	/// <summary>
 	/// Function used to alert the caller that the SignalBase* component still has output.
 	/// </summary>
@@ -183,6 +232,20 @@ public:
 		return *_settings;
 	}
 
+	/// <summary>
+	/// Number of frames between parameter automation updates (the control rate). The automation is evaluated at
+	/// each update, and ramped linearly in between (see UpdateParameterRamp). (Default PARAMETER_AUTOMATION_INTERVAL)
+	/// </summary>
+	int GetAutomationInterval() const
+	{
+		return _automationInterval;
+	}
+	void SetAutomationInterval(int frameCount)
+	{
+		_automationInterval = std::clamp(frameCount, 1, AUDIO_BLOCK_SIZE);
+		_automationValid = false;
+	}
+
 protected:
 
 	/// <summary>
@@ -196,6 +259,7 @@ protected:
 
 		_settings->AddParameter(SignalParameter(name, initialValue, min, max));
 		_parameterAutomaters->push_back(automater);
+		_automationValues->push_back(initialValue);
 	}
 
 	/// <summary>
@@ -203,6 +267,16 @@ protected:
 	/// </summary>
 	virtual void UpdateParameter(int index, float value) = 0;
 
+	/// <summary>
+	/// Function to update an automated parameter with a (linear) ramp over the next frameCount frames (one control
+	/// interval). The default sets the value at the middle of the ramp with UpdateParameter(..), once per interval;
+	/// sub-classes that can interpolate per frame (see BiQuadFilter) should override this.
+	/// </summary>
+	virtual void UpdateParameterRamp(int index, float startValue, float endValue, int frameCount)
+	{
+		this->UpdateParameter(index, 0.5f * (startValue + endValue));
+	}
+
 	/// <summary>
 	/// Function to set the frame with the next sample
 	/// </summary>
@@ -220,25 +294,78 @@ protected:
 	}
 
 	/// <summary>
-	/// Function to update parameter automaters before playback
+	/// Applies the output level to the block. The default calls GetOutputLevel(..) for each frame; so
+	/// sub-classes with a block-wise output level (envelope ramps) should override this.
+	/// </summary>
+	virtual void ApplyOutputLevel(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+	{
+		for (int index = 0; index < frameCount; index++)
+		{
+			PlaybackTime frameTime = playbackTime->Offset(index, block->GetSamplingRate());
+
+			float output = GetOutputLevel(&frameTime);
+
+			block->MultFrame(index, output, output);
+		}
+	}
+
+	/// <summary>
+	/// Returns true if any of the parameters have automation enabled (set with the parameters; see Update)
 	/// </summary>
-	void UpdateParameterAutomaters(PlaybackFrame* frame, const PlaybackTime* playbackTime)
+	bool HasParameterAutomation() const
 	{
+		return _hasAutomation;
+	}
+
+	/// <summary>
+	/// Function to update parameter automaters for the next frameCount frames. The automation is evaluated at
+	/// the end of the segment; and ramped from the previous value (or the value at the start of the segment, if
+	/// the playback was not continuous).
+	/// </summary>
+	void UpdateParameterAutomaters(PlaybackFrame* frame, const PlaybackTime* playbackTime, int frameCount, float samplingRate)
+	{
+		bool continuous = _automationValid && playbackTime->frameCursor == _automationCursor;
+
+		PlaybackTime endTime = playbackTime->Offset(frameCount, samplingRate);
+
 		for (int index = 0; index < _settings->GetParameterCount(); index++)
 		{
 			if (_settings->GetParameter(index)->GetAutomationEnabled())
 			{
-				float value = _parameterAutomaters->at(index)->GetValue(frame, playbackTime);
+				float startValue = continuous ? _automationValues->at(index) : _parameterAutomaters->at(index)->GetValue(frame, playbackTime);
+				float endValue = _parameterAutomaters->at(index)->GetValue(frame, &endTime);
+
+				_automationValues->at(index) = endValue;
 
-				// Call function to set the current parameter value before sample
-				// is calculated
-				this->UpdateParameter(index, value);
+				// Call function to set the parameter ramp before the samples are calculated
+				this->UpdateParameterRamp(index, startValue, endValue, frameCount);
 			}
 		}
+
+		_automationCursor = endTime.frameCursor;
+		_automationValid = true;
+	}
+
+	/// <summary>
+	/// (Per-sample callers) Updates the parameter automaters once per control interval (see GetAutomationInterval)
+	/// </summary>
+	void UpdateParameterAutomatersAtControlRate(PlaybackFrame* frame, const PlaybackTime* playbackTime)
+	{
+		if (!_hasAutomation)
+			return;
+
+		// Next control point (or a jump in the stream)
+		if (!_automationValid ||
+			playbackTime->frameCursor >= _automationCursor ||
+			playbackTime->frameCursor + _automationInterval < _automationCursor)
+			UpdateParameterAutomaters(frame, playbackTime, _automationInterval, this->GetPlaybackInfo()->GetStreamInfo()->streamSampleRate);
 	}
 
 	void EngageParameterAutomaters(const PlaybackTime* playbackTime, bool engaged)
 	{
+		// (The envelope sweeps start over)
+		_automationValid = false;
+
 		for (int index = 0; index < _settings->GetParameterCount(); index++)
 		{
 			if (_settings->GetParameter(index)->GetAutomationEnabled())
@@ -256,6 +383,16 @@ private:
 	SignalSettings* _settings;
 
 	std::vector<SignalParameterAutomater*>* _parameterAutomaters;
+
+	// Control rate automation:  The value of each automated parameter at the automation cursor (the end of
+	// the last ramp)
+	std::vector<float>* _automationValues;
+	size_t _automationCursor;
+	bool _automationValid;
+	int _automationInterval;
+
+	// Any parameter has automation enabled (see Update)
+	bool _hasAutomation;
 };
 
 #endif
\ No newline at end of file
@@ -74,6 +74,20 @@ public:
 	std::string GetParameterName(int index) const { return _parameters->at(index)->GetName(); }
 	int GetParameterCount() const { return _parameters->size(); }
 
+	/// <summary>
+	/// Returns true if any of the parameters have automation enabled
+	/// </summary>
+	bool HasAutomation() const
+	{
+		for (int index = 0; index < _parameters->size(); index++)
+		{
+			if (_parameters->at(index)->GetAutomationEnabled())
+				return true;
+		}
+
+		return false;
+	}
+
 	void AddParameter(const SignalParameter& parameter)
 	{
 		_parameters->push_back(new SignalParameter(parameter));
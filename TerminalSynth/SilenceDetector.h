@@ -0,0 +1,93 @@
+#pragma once
+
+#ifndef SILENCE_DETECTOR_H
+#define SILENCE_DETECTOR_H
+
+#include "Constant.h"
+#include <cmath>
+
+/// <summary>
+/// Tail detector for one node of the signal path. A node is silent when the peak of its input, and output, stays
+/// below the threshold; and it goes to sleep once it has been silent for the hold time. A sleeping node is
+/// bypassed (its state is kept); and it wakes on the next input above the threshold (see SignalChain).
+/// </summary>
+class SilenceDetector
+{
+public:
+
+	SilenceDetector()
+	{
+		_threshold = std::pow(10.0f, SILENCE_THRESHOLD_DB / 20.0f);
+		_holdFrames = 0;
+		_silentFrames = 0;
+		_asleep = false;
+	}
+	~SilenceDetector() {};
+
+	/// <summary>
+	/// Sets the threshold (dB, peak), and the hold time (seconds)
+	/// </summary>
+	void Configure(float thresholdDecibels, float holdSeconds, float samplingRate)
+	{
+		_threshold = std::pow(10.0f, thresholdDecibels / 20.0f);
+		_holdFrames = (size_t)(holdSeconds * samplingRate);
+	}
+
+	/// <summary>
+	/// Returns true if the peak is below the threshold
+	/// </summary>
+	bool IsSilent(float peak) const
+	{
+		return peak < _threshold;
+	}
+
+	bool IsAsleep() const { return _asleep; }
+
+	/// <summary>
+	/// Adds the frames to the silent time (or resets it); and updates the sleep state
+	/// </summary>
+	void Update(bool isSilent, int frameCount)
+	{
+		if (isSilent)
+		{
+			_silentFrames += frameCount;
+			_asleep = _silentFrames >= _holdFrames;
+		}
+		else
+			Wake();
+	}
+
+	void Wake()
+	{
+		_silentFrames = 0;
+		_asleep = false;
+	}
+
+	/// <summary>
+	/// Returns the largest absolute sample of the (planar) frames
+	/// </summary>
+	static float GetPeak(const float* left, const float* right, int frameCount)
+	{
+		float peak = 0;
+
+		for (int index = 0; index < frameCount; index++)
+		{
+			float value = std::fmax(std::fabs(left[index]), std::fabs(right[index]));
+
+			peak = value > peak ? value : peak;
+		}
+
+		return peak;
+	}
+
+private:
+
+	// Linear (peak) threshold
+	float _threshold;
+
+	size_t _holdFrames;
+	size_t _silentFrames;
+	bool _asleep;
+};
+
+#endif
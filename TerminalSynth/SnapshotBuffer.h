@@ -0,0 +1,96 @@
+#pragma once
+
+#ifndef SNAPSHOT_BUFFER_H
+#define SNAPSHOT_BUFFER_H
+
+#include <atomic>
+
+/// <summary>
+/// Triple buffer for publishing snapshots of T from one (writer) thread to one (reader) thread without locking. The
+/// writer copies into its private back slot, and publishes it with one atomic exchange. The reader checks for a new
+/// snapshot with one atomic load; and swaps it in with one atomic exchange. Neither side ever waits on the other; and
+/// the reader never allocates (the copies are made on the writer thread).
+/// </summary>
+/// <typeparam name="T">Copy-constructible snapshot type</typeparam>
+template<typename T>
+class SnapshotBuffer
+{
+public:
+
+	SnapshotBuffer(const T& initialValue)
+	{
+		// MEMORY! ~SnapshotBuffer
+		for (int index = 0; index < SLOT_COUNT; index++)
+			_slots[index] = new T(initialValue);
+
+		_frontIndex = 0;
+		_middleIndex.store(1);
+		_backIndex = 2;
+	}
+	~SnapshotBuffer()
+	{
+		for (int index = 0; index < SLOT_COUNT; index++)
+			delete _slots[index];
+	}
+
+	SnapshotBuffer(const SnapshotBuffer& copy) = delete;
+	SnapshotBuffer& operator=(const SnapshotBuffer& copy) = delete;
+
+	/// <summary>
+	/// (Writer Thread) Copies the value into the back slot; and publishes it as the latest snapshot. Any snapshot
+	/// that was published, but not yet acquired, is recycled.
+	/// </summary>
+	void Publish(const T& value)
+	{
+		// MEMORY! (The back slot is owned by the writer thread)
+		delete _slots[_backIndex];
+		_slots[_backIndex] = new T(value);
+
+		int previous = _middleIndex.exchange(_backIndex | FRESH_FLAG, std::memory_order_acq_rel);
+
+		_backIndex = previous & INDEX_MASK;
+	}
+
+	/// <summary>
+	/// (Reader Thread) Swaps in the latest snapshot, if one was published since the last call. Returns true if
+	/// the front snapshot has changed.
+	/// </summary>
+	bool Acquire()
+	{
+		if ((_middleIndex.load(std::memory_order_relaxed) & FRESH_FLAG) == 0)
+			return false;
+
+		int previous = _middleIndex.exchange(_frontIndex, std::memory_order_acq_rel);
+
+		_frontIndex = previous & INDEX_MASK;
+
+		return true;
+	}
+
+	/// <summary>
+	/// (Reader Thread) Returns the current snapshot. This remains valid until the next call to Acquire().
+	/// </summary>
+	const T* GetFront() const
+	{
+		return _slots[_frontIndex];
+	}
+
+private:
+
+	static const int SLOT_COUNT = 3;
+	static const int INDEX_MASK = 0x3;
+	static const int FRESH_FLAG = 0x4;
+
+	T* _slots[SLOT_COUNT];
+
+	// Reader Thread
+	int _frontIndex;
+
+	// Shared:  Index of the published slot, with the fresh flag set until the reader has acquired it
+	std::atomic<int> _middleIndex;
+
+	// Writer Thread
+	int _backIndex;
+};
+
+#endif
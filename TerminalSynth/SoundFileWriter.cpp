@@ -0,0 +1,103 @@
+#include "AudioBlock.h"
+#include "SoundFileWriter.h"
+#include <algorithm>
+#include <exception>
+#include <sndfile.h>
+#include <string>
+
+SoundFileWriter::SoundFileWriter(const std::string& fileName, int sampleRate)
+{
+	_fileName = new std::string(fileName);
+	_sfinfo = new SF_INFO();
+	_sndFile = nullptr;
+	_buffer = new float[2 * BUFFER_FRAMES];
+	_framesWritten = 0;
+
+	_sfinfo->samplerate = sampleRate;
+	_sfinfo->channels = 2;
+}
+
+SoundFileWriter::~SoundFileWriter()
+{
+	if (_sndFile != nullptr)
+		this->Close();
+
+	delete _fileName;
+	delete _sfinfo;
+	delete[] _buffer;
+}
+
+bool SoundFileWriter::Open()
+{
+	if (_sndFile != nullptr)
+		throw new std::exception("Trying to open sound file with existing file already open!");
+
+	// Format:  File Type | Data Type
+	//
+	if (_fileName->ends_with(".flac"))
+		_sfinfo->format = SF_FORMAT_FLAC | SF_FORMAT_PCM_24;
+
+	else
+		_sfinfo->format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	if (!sf_format_check(_sfinfo))
+		return false;
+
+	if ((_sndFile = sf_open(_fileName->c_str(), SFM_WRITE, _sfinfo)) == NULL)
+		return false;
+
+	_framesWritten = 0;
+
+	return true;
+}
+
+bool SoundFileWriter::Write(const AudioBlock* block, int frameCount)
+{
+	const float* left = block->GetLeft();
+	const float* right = block->GetRight();
+
+	for (int frameOffset = 0; frameOffset < frameCount; frameOffset += BUFFER_FRAMES)
+	{
+		int count = std::min(frameCount - frameOffset, BUFFER_FRAMES);
+
+		for (int index = 0; index < count; index++)
+		{
+			_buffer[2 * index] = left[frameOffset + index];
+			_buffer[(2 * index) + 1] = right[frameOffset + index];
+		}
+
+		if (!this->Write(_buffer, count))
+			return false;
+	}
+
+	return true;
+}
+
+bool SoundFileWriter::Write(const float* interleavedFrames, int frameCount)
+{
+	if (_sndFile == nullptr)
+		throw new std::exception("Must call open before writing sound file!");
+
+	sf_count_t written = sf_writef_float(_sndFile, interleavedFrames, frameCount);
+
+	_framesWritten += written;
+
+	return written == frameCount;
+}
+
+long long SoundFileWriter::GetFramesWritten() const
+{
+	return _framesWritten;
+}
+
+bool SoundFileWriter::Close()
+{
+	if (_sndFile == nullptr)
+		return false;
+
+	bool success = sf_close(_sndFile) == 0;
+
+	_sndFile = nullptr;
+
+	return success;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#ifndef SOUNDFILEWRITER_H
+#define SOUNDFILEWRITER_H
+
+#include "AudioBlock.h"
+#include <sndfile.h>
+#include <string>
+
+// libsndfile:  Small tutorial https://digitalsoundandmusic.com/5-3-3-reading-and-writing-formatted-audio-files-in-c/
+//
+class SoundFileWriter
+{
+public:
+
+	SoundFileWriter(const std::string& fileName, int sampleRate);
+	~SoundFileWriter();
+
+	/// <summary>
+	/// Opens (creates) the stereo file. The format is chosen from the extension:  .flac (24 bit), otherwise
+	/// .wav (32 bit float). Returns false if the file could not be created.
+	/// </summary>
+	bool Open();
+
+	/// <summary>
+	/// Writes the first frameCount frames of the block (interleaving the L/R channels)
+	/// </summary>
+	bool Write(const AudioBlock* block, int frameCount);
+
+	/// <summary>
+	/// Writes interleaved (L/R) 32 bit float frames
+	/// </summary>
+	bool Write(const float* interleavedFrames, int frameCount);
+
+	/// <summary>
+	/// Returns the number of frames written since Open()
+	/// </summary>
+	long long GetFramesWritten() const;
+
+	/// <summary>
+	/// Closes and completes the stream
+	/// </summary>
+	bool Close();
+
+private:
+
+	static const int BUFFER_FRAMES = 512;
+
+	std::string* _fileName;
+	SNDFILE* _sndFile;
+	SF_INFO* _sfinfo;
+
+	// Interleaving buffer (L/R)
+	float* _buffer;
+
+	long long _framesWritten;
+};
+
+#endif
@@ -5,9 +5,14 @@
 
 #include "AirwindowsEffect.h"
 #include "AirwindowsEffectLoader.h"
+#include "AirwindowsManifest.h"
+#include "AirwindowsSparePool.h"
+#include "OscillatorParameters.h"
 #include "PlaybackInfo.h"
 #include "SignalParameterizedBase.h"
 #include "SignalSettings.h"
+#include "WaveTable.h"
+#include "WaveTableCache.h"
 #include <AirwinRegistry.h>
 #include <AirwinRegistryEntry.h>
 #include <airwin_consolidated_base.h>
@@ -19,19 +24,25 @@
 #include <vector>
 
 /// <summary>
-/// Registry for AirwinEffect* instances, SignalSettings* for the signal chain, and also sound bank
+/// Registry for AirwinEffect* instances, SignalSettings* for the signal chain, wave tables, and also sound bank
 /// data for the UI. (This was separated from the configuration because of a circular dependency with SignalBase*)
 /// </summary>
 class SoundRegistry
 {
+public:
+
+	// Airwindows plugin metadata cache (see AirwindowsManifest)
+	const char* DEFAULT_MANIFEST_FILE_NAME = ".terminal-synth-airwin-manifest";
+
 public:
 
 	SoundRegistry();
 	~SoundRegistry();
 
 	/// <summary>
-	/// Creates an initial collection of effects plugins from the Airwin .lib, and creates a basic
-	/// cache of instances. The destination list may be used to initialize the names of the plugins.
+	/// Loads the effects plugin metadata from the Airwin .lib (and the manifest cache). Plugins are not
+	/// created until they're first checked out, unless they are missing from the manifest. The destination 
+	/// list may be used to initialize the names of the plugins.
 	/// </summary>
 	bool Initialize(const PlaybackInfo* outputSettings, std::vector<SignalSettings>& destinationList);
 
@@ -65,6 +76,37 @@ public:
 	/// </summary>
 	void Checkin(SignalParameterizedBase* effect);
 
+	/// <summary>
+	/// Creates instances of the effect (off the audio thread), until there are at least count instances available
+	/// for checkout. This is used to pre-allocate the per-voice effects when the patch is loaded.
+	/// </summary>
+	void Reserve(const std::string& name, int count);
+
+	/// <summary>
+	/// Returns the (shared, read-only) wave table for the oscillator parameters. Tables are built on first use,
+	/// so this should not be called from the audio thread. THE WAVE TABLE SHOULD NOT BE DELETED!
+	/// </summary>
+	const WaveTable* GetWaveTable(const OscillatorParameters& parameters) const;
+
+	/// <summary>
+	/// Releases a wave table taken with GetWaveTable (once per call). Tables that are no longer held are deleted;
+	/// so this should not be called from the audio thread.
+	/// </summary>
+	void ReleaseWaveTable(const WaveTable* waveTable) const;
+
+	/// <summary>
+	/// (Off the audio thread) Replaces the spare plugin instances that were used to reset effects (see
+	/// AirwindowsSparePool). This is polled by the SynthBuilder*.
+	/// </summary>
+	void RefreshEffects();
+
+private:
+
+	/// <summary>
+	/// Creates (and initializes) a new instance of the effect. MEMORY! ~SoundRegistry
+	/// </summary>
+	SignalParameterizedBase* CreateInstance(const std::string& name) const;
+
 private:
 
 	// Loaded from airwindows-plugins.lib 
@@ -73,12 +115,24 @@ private:
 	// Created from Airwin / Local effects (DO NOT DELETE AIRWIN DATA HERE!)
 	std::map<std::string, AirwinRegistryEntry*>* _registryEntries;
 
+	// Plugin settings (loaded from the manifest, or the plugin) used to create the effect wrappers
+	std::map<std::string, SignalSettings*>* _effectSettings;
+
 	// Instances of our SignalBase* effects
 	std::map<std::string, std::vector<SignalParameterizedBase*>*>* _effectInstances;
 
 	// Instances that are being used
 	std::map<std::string, std::vector<SignalParameterizedBase*>*>* _effectInstancesCheckedOut;
 
+	// Spare plugin instances, used to reset the effects (one pool per plugin; filled on first checkout)
+	std::map<std::string, AirwindowsSparePool*>* _sparePools;
+
+	// Pools that have been filled (see RefreshEffects) (DO NOT DELETE! These are held in the map above)
+	std::vector<AirwindowsSparePool*>* _activeSparePools;
+
+	// Wave tables (shared by the voices)
+	WaveTableCache* _waveTableCache;
+
 	const PlaybackInfo* _outputSettings;
 };
 
@@ -86,8 +140,12 @@ SoundRegistry::SoundRegistry()
 {
 	_airwinEffectRegistry = new AirwinRegistry();
 	_registryEntries = new std::map<std::string, AirwinRegistryEntry*>();
+	_effectSettings = new std::map<std::string, SignalSettings*>();
 	_effectInstances = new std::map<std::string, std::vector<SignalParameterizedBase*>*>();
 	_effectInstancesCheckedOut = new std::map<std::string, std::vector<SignalParameterizedBase*>*>();
+	_sparePools = new std::map<std::string, AirwindowsSparePool*>();
+	_activeSparePools = new std::vector<AirwindowsSparePool*>();
+	_waveTableCache = new WaveTableCache();
 	_outputSettings = nullptr;
 }
 
@@ -114,15 +172,25 @@ SoundRegistry::~SoundRegistry()
 	}
 
 	// MEMORY! ~SignalSettings*
-	for (auto iter = _effectInstances->begin(); iter != _effectInstances->end(); ++iter)
+	for (auto iter = _effectSettings->begin(); iter != _effectSettings->end(); ++iter)
+	{
+		delete iter->second;
+	}
+
+	// MEMORY! ~AirwindowsSparePool*
+	for (auto iter = _sparePools->begin(); iter != _sparePools->end(); ++iter)
 	{
 		delete iter->second;
 	}
 
 	delete _airwinEffectRegistry;
+	delete _effectSettings;
 	delete _registryEntries;				// AirwinRegistryEntry* instances are handled in the other .lib
 	delete _effectInstances;
 	delete _effectInstancesCheckedOut;
+	delete _sparePools;
+	delete _activeSparePools;
+	delete _waveTableCache;
 }
 
 bool SoundRegistry::Initialize(const PlaybackInfo* outputSettings, std::vector<SignalSettings>& destinationList)
@@ -137,6 +205,12 @@ bool SoundRegistry::Initialize(const PlaybackInfo* outputSettings, std::vector<S
 	// Get Plugin Name List
 	_airwinEffectRegistry->GetPlugins(pluginList);
 
+	// Plugin Metadata (cached)
+	AirwindowsManifest manifest;
+	manifest.Load(DEFAULT_MANIFEST_FILE_NAME);
+
+	bool manifestDirty = false;
+
 	for (int index = 0; index < pluginList.size(); index++)
 	{
 		// Airwin Plugin
@@ -146,27 +220,46 @@ bool SoundRegistry::Initialize(const PlaybackInfo* outputSettings, std::vector<S
 		_registryEntries->insert(std::make_pair(pluginList.at(index), pluginEntry));
 		_effectInstances->insert(std::make_pair(pluginList.at(index), new std::vector<SignalParameterizedBase*>()));					// MEMORY! ~SoundRegistry
 		_effectInstancesCheckedOut->insert(std::make_pair(pluginList.at(index), new std::vector<SignalParameterizedBase*>()));		    // MEMORY! ~SoundRegistry
-
-		// Airwindows Instance!
-		AudioEffectX* effect = pluginEntry->CreateEffect(_outputSettings->GetStreamInfo()->streamSampleRate);
+		_sparePools->insert(std::make_pair(pluginList.at(index), new AirwindowsSparePool(pluginEntry, _outputSettings->GetStreamInfo()->streamSampleRate)));	// MEMORY! ~SoundRegistry
 
 		// Signal Settings (for our wrapper)
 		SignalSettings pluginSettings;
 
-		AirwindowsEffectLoader::LoadSettings(pluginEntry, effect, pluginSettings);
+		// Manifest:  No plugin instance required
+		if (manifest.Contains(pluginList[index], AirwindowsEffectLoader::GetParameterCount(pluginEntry)))
+		{
+			AirwindowsEffectLoader::LoadSettings(pluginEntry, manifest.Get(pluginList[index]), pluginSettings);
+		}
 
-		// MEMORY! ~SoundRegistry
-		AirwindowsEffect* wrappedEffect = new AirwindowsEffect(pluginSettings, effect);
+		// Missing (or stale) manifest entry:  Airwindows Instance! (Kept as the first cached instance)
+		else
+		{
+			AudioEffectX* effect = pluginEntry->CreateEffect(_outputSettings->GetStreamInfo()->streamSampleRate);
 
-		// Effect Instance Initialize
-		wrappedEffect->Initialize(_outputSettings);
+			AirwindowsEffectLoader::LoadSettings(pluginEntry, effect, pluginSettings);
 
-		// Effect Instance (initial)
-		_effectInstances->at(pluginList[index])->push_back(wrappedEffect);
+			// MEMORY! ~SoundRegistry
+			AirwindowsEffect* wrappedEffect = new AirwindowsEffect(pluginSettings, effect, _sparePools->at(pluginList[index]));
 
-		destinationList.push_back(wrappedEffect->GetSettings());
+			// Effect Instance Initialize
+			wrappedEffect->Initialize(_outputSettings);
+
+			// Effect Instance (initial)
+			_effectInstances->at(pluginList[index])->push_back(wrappedEffect);
+
+			manifest.Set(pluginSettings);
+			manifestDirty = true;
+		}
+
+		// MEMORY! ~SoundRegistry
+		_effectSettings->insert(std::make_pair(pluginList.at(index), new SignalSettings(pluginSettings)));
+
+		destinationList.push_back(pluginSettings);
 	}
 
+	if (manifestDirty)
+		manifest.Save(DEFAULT_MANIFEST_FILE_NAME);
+
 	return true;
 }
 
@@ -191,6 +284,15 @@ SignalParameterizedBase* SoundRegistry::Checkout(const std::string& name) const
 	if (!_registryEntries->contains(name))
 		throw new std::exception("Effect name not found in SoundRegistry*");
 
+	// Spare Instances:  Used to reset the effect (see AirwindowsEffect::Clear)
+	AirwindowsSparePool* sparePool = _sparePools->at(name);
+
+	if (!sparePool->IsActive())
+	{
+		sparePool->Activate();
+		_activeSparePools->push_back(sparePool);
+	}
+
 	// Available Instances
 	if (_effectInstances->at(name)->size() > 0)
 	{
@@ -202,28 +304,46 @@ SignalParameterizedBase* SoundRegistry::Checkout(const std::string& name) const
 		return instance;
 	}
 
-	AirwinRegistryEntry* entry = _registryEntries->at(name);
+	// Airwindows Instance! (created on first checkout)
+	SignalParameterizedBase* instance = CreateInstance(name);
 
-	// Airwindows Instance!
-	AudioEffectX* effect = entry->CreateEffect(_outputSettings->GetStreamInfo()->streamSampleRate);
+	// Checked Out
+	_effectInstancesCheckedOut->at(name)->push_back(instance);
 
-	// Signal Settings (for our wrapper)
-	SignalSettings pluginSettings;
+	return instance;
+}
 
-	AirwindowsEffectLoader::LoadSettings(entry, effect, pluginSettings);
+void SoundRegistry::Reserve(const std::string& name, int count)
+{
+	if (!_registryEntries->contains(name))
+		throw new std::exception("Effect name not found in SoundRegistry*");
+
+	while (_effectInstances->at(name)->size() < count)
+		_effectInstances->at(name)->push_back(CreateInstance(name));
+}
+
+SignalParameterizedBase* SoundRegistry::CreateInstance(const std::string& name) const
+{
+	AirwinRegistryEntry* entry = _registryEntries->at(name);
+
+	AudioEffectX* effect = entry->CreateEffect(_outputSettings->GetStreamInfo()->streamSampleRate);
 
 	// MEMORY! ~SoundRegistry
-	AirwindowsEffect* wrappedEffect = new AirwindowsEffect(pluginSettings, effect);
+	AirwindowsEffect* wrappedEffect = new AirwindowsEffect(*_effectSettings->at(name), effect, _sparePools->at(name));
 
 	// Effect Instance Initialize
 	wrappedEffect->Initialize(_outputSettings);
 
-	// Checked Out
-	_effectInstancesCheckedOut->at(name)->push_back(wrappedEffect);
-
 	return wrappedEffect;
 }
 
+void SoundRegistry::RefreshEffects()
+{
+	// (Pools with no spare taken are skipped)
+	for (int index = 0; index < _activeSparePools->size(); index++)
+		_activeSparePools->at(index)->Refresh();
+}
+
 void SoundRegistry::Checkin(SignalParameterizedBase* effect)
 {
 	if (!_effectInstancesCheckedOut->contains(effect->GetName()))
@@ -248,5 +368,14 @@ void SoundRegistry::Checkin(SignalParameterizedBase* effect)
 	}
 }
 
+const WaveTable* SoundRegistry::GetWaveTable(const OscillatorParameters& parameters) const
+{
+	return _waveTableCache->Get(parameters);
+}
+
+void SoundRegistry::ReleaseWaveTable(const WaveTable* waveTable) const
+{
+	_waveTableCache->Release(waveTable);
+}
 
 #endif
\ No newline at end of file
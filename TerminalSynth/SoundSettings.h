@@ -33,6 +33,8 @@ public:
 		_noteParameters->chord = ArpeggiatorChord::TriadMajor;
 		_noteParameters->mode = SynthNoteMode::Normal;
 		_noteParameters->portamentoSeconds = 0.5f;
+		_noteParameters->polyphony = SYNTH_POLYPHONY_DEFAULT;
+		_noteParameters->stealMode = VoiceStealMode::Oldest;
 	}
 	SoundSettings(const SoundSettings& copy)
 	{
@@ -82,6 +84,8 @@ public:
 		_noteParameters->chord = settings->GetNoteParameters()->chord;
 		_noteParameters->mode = settings->GetNoteParameters()->mode;
 		_noteParameters->portamentoSeconds = settings->GetNoteParameters()->portamentoSeconds;
+		_noteParameters->polyphony = settings->GetNoteParameters()->polyphony;
+		_noteParameters->stealMode = settings->GetNoteParameters()->stealMode;
 
 		return isDirty;
 	}
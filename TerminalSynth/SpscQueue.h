@@ -0,0 +1,155 @@
+#pragma once
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/// <summary>
+/// Wait-free, fixed capacity, single-producer / single-consumer ring buffer. Push is only called from the
+/// producer thread, and Pop from the consumer thread. Neither call allocates, or blocks; so either side may
+/// be the audio thread.
+/// </summary>
+/// <typeparam name="T">Copyable element type (pointers, or small structs)</typeparam>
+template<typename T>
+class SpscQueue
+{
+public:
+
+	/// <summary>
+	/// Creates the queue with (at least) the requested capacity. The capacity is rounded up to a power of two.
+	/// </summary>
+	SpscQueue(size_t capacity)
+	{
+		_capacity = 1;
+
+		while (_capacity < capacity + 1)
+			_capacity <<= 1;
+
+		_mask = _capacity - 1;
+
+		// MEMORY! ~SpscQueue
+		_buffer = new T[_capacity];
+
+		_head.store(0);
+		_tail.store(0);
+	}
+	~SpscQueue()
+	{
+		delete[] _buffer;
+	}
+
+	SpscQueue(const SpscQueue& copy) = delete;
+	SpscQueue& operator=(const SpscQueue& copy) = delete;
+
+	/// <summary>
+	/// (Producer Thread) Adds the value to the queue. Returns false if the queue is full.
+	/// </summary>
+	bool Push(const T& value)
+	{
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		size_t next = (tail + 1) & _mask;
+
+		if (next == _head.load(std::memory_order_acquire))
+			return false;
+
+		_buffer[tail] = value;
+		_tail.store(next, std::memory_order_release);
+
+		return true;
+	}
+
+	/// <summary>
+	/// (Producer Thread) Adds all of the values to the queue; or none of them, if they do not fit. Returns false if
+	/// the queue does not have room for count values.
+	/// </summary>
+	bool PushRange(const T* values, size_t count)
+	{
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		size_t head = _head.load(std::memory_order_acquire);
+
+		// (One slot is always left empty)
+		size_t available = (head - tail - 1) & _mask;
+
+		if (count > available)
+			return false;
+
+		for (size_t index = 0; index < count; index++)
+			_buffer[(tail + index) & _mask] = values[index];
+
+		_tail.store((tail + count) & _mask, std::memory_order_release);
+
+		return true;
+	}
+
+	/// <summary>
+	/// (Consumer Thread) Removes up to count values from the queue. Returns the number of values removed.
+	/// </summary>
+	size_t PopRange(T* destination, size_t count)
+	{
+		size_t head = _head.load(std::memory_order_relaxed);
+		size_t tail = _tail.load(std::memory_order_acquire);
+
+		size_t available = (tail - head) & _mask;
+		size_t length = count < available ? count : available;
+
+		for (size_t index = 0; index < length; index++)
+			destination[index] = _buffer[(head + index) & _mask];
+
+		_head.store((head + length) & _mask, std::memory_order_release);
+
+		return length;
+	}
+
+	/// <summary>
+	/// (Consumer Thread) Removes the next value from the queue. Returns false if the queue is empty.
+	/// </summary>
+	bool Pop(T& destination)
+	{
+		size_t head = _head.load(std::memory_order_relaxed);
+
+		if (head == _tail.load(std::memory_order_acquire))
+			return false;
+
+		destination = _buffer[head];
+		_head.store((head + 1) & _mask, std::memory_order_release);
+
+		return true;
+	}
+
+	/// <summary>
+	/// (Consumer Thread) Returns the next value without removing it. Returns false if the queue is empty.
+	/// </summary>
+	bool Peek(T& destination) const
+	{
+		size_t head = _head.load(std::memory_order_relaxed);
+
+		if (head == _tail.load(std::memory_order_acquire))
+			return false;
+
+		destination = _buffer[head];
+
+		return true;
+	}
+
+	/// <summary>
+	/// Returns true if the queue is empty (approximate, when called from the producer thread)
+	/// </summary>
+	bool IsEmpty() const
+	{
+		return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+	}
+
+private:
+
+	T* _buffer;
+	size_t _capacity;
+	size_t _mask;
+
+	// Separate cache lines for the consumer (head) and producer (tail) indices
+	alignas(64) std::atomic<size_t> _head;
+	alignas(64) std::atomic<size_t> _tail;
+};
+
+#endif
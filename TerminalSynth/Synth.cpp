@@ -1,45 +1,168 @@
+#include "AudioBlock.h"
+#include "BlockEventSchedule.h"
+#include "Constant.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "SignalChain.h"
+#include "SignalChainSettings.h"
 #include "SoundRegistry.h"
 #include "SoundSettings.h"
 #include "Synth.h"
 #include "SynthSettings.h"
+#include "SynthVoiceBank.h"
 #include "SynthVoiceBase.h"
 #include "SynthVoicePool.h"
+#include "Utility.h"
+#include <algorithm>
+#include <exception>
 
 Synth::Synth(const SynthSettings* configuration, unsigned int numberOfChannels, unsigned int samplingRate)
 {
 	_numberOfChannels = numberOfChannels;
 	_samplingRate = samplingRate;
 	_postProcessing = new SignalChain();
+	_postProcessingSettings = new SignalChainSettings(*configuration->GetCurrentSoundSettings()->GetPostProcessing());
+	_voiceBlock = new AudioBlock(AUDIO_BLOCK_SIZE, samplingRate);
+	_voiceBank = new SynthVoiceBank();
 	_octave = configuration->GetCurrentSoundSettings()->GetOscillatorParameters()->GetOctave();
 	_notePool = nullptr;
+	_previous = nullptr;
+	_faded = nullptr;
+	_crossfadeBlock = new AudioBlock(AUDIO_BLOCK_SIZE, samplingRate);
+	_crossfadeFrame = 0;
+	_crossfadeFrames = std::max((int)(SYNTH_SWAP_CROSSFADE_SECONDS * samplingRate), 1);
+	_effectRegistry = nullptr;
+	_structureHashCode = 0;
+	_revision = 0;
 }
 
 Synth::~Synth()
 {
+	// Effects are returned to the SoundRegistry* (synths are disposed off the audio thread)
+	if (_effectRegistry != nullptr)
+		_postProcessing->Release(_effectRegistry);
+
 	delete _postProcessing;
+	delete _postProcessingSettings;
+	delete _voiceBlock;
+	delete _voiceBank;
+	delete _crossfadeBlock;
 
 	if (_notePool != nullptr)
 		delete _notePool;
+
+	// (Synth Swap) Not yet handed back (see TakeFadedSynth)
+	if (_previous != nullptr)
+		delete _previous;
+
+	if (_faded != nullptr)
+		delete _faded;
 }
 
 void Synth::Initialize(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters)
 {
 	// MEMORY! ~Synth
-	_notePool = new SynthVoicePool(effectRegistry, configuration->GetCurrentSoundSettings(), parameters, 10);
+	_notePool = new SynthVoicePool(effectRegistry, configuration->GetCurrentSoundSettings(), parameters);
 
 	_postProcessing->Initialize(effectRegistry, configuration->GetCurrentSoundSettings()->GetPostProcessing(), parameters);
+	_postProcessing->UpdateParameters(configuration->GetCurrentSoundSettings()->GetPostProcessing());
 	_octave = configuration->GetCurrentSoundSettings()->GetOscillatorParameters()->GetOctave();
+
+	_effectRegistry = effectRegistry;
+	_structureHashCode = GetStructureHashCode(configuration->GetCurrentSoundSettings());
 }
 
-void Synth::Update(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters)
+bool Synth::Update(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters)
 {
-	_postProcessing->Update(effectRegistry, soundSettings->GetPostProcessing());
+	// Voice change:  (see SynthBuilder)
+	if (GetStructureHashCode(soundSettings) != _structureHashCode)
+		return false;
+
+	// (Effect chains are skipped until the chain edit is adopted; see SignalChain::UpdateParameters)
+
+	_postProcessing->UpdateParameters(soundSettings->GetPostProcessing());
+	_postProcessingSettings->Update(soundSettings->GetPostProcessing(), true);
 	_notePool->Update(effectRegistry, soundSettings, parameters);
 	_octave = soundSettings->GetOscillatorParameters()->GetOctave();
+
+	return true;
+}
+
+size_t Synth::GetStructureHashCode(const SoundSettings* soundSettings)
+{
+	size_t hash = soundSettings->GetOscillatorParameters()->GetVoiceHashCode();
+	size_t polyphonyHash = soundSettings->GetNoteParameters()->polyphony;
+
+	TerminalSynth::HashCombine(hash, polyphonyHash);
+
+	return hash;
+}
+
+size_t Synth::GetChainHashCode(const SoundSettings* soundSettings)
+{
+	size_t hash = soundSettings->GetSignalChain()->GetTopologyHashCode();
+	size_t postProcessingHash = soundSettings->GetPostProcessing()->GetTopologyHashCode();
+
+	TerminalSynth::HashCombine(hash, postProcessingHash);
+
+	return hash;
+}
+
+bool Synth::AdoptChains(SynthChainEdit* chainEdit, const PlaybackTime* playbackTime)
+{
+	if (chainEdit->GetStructureHashCode() != _structureHashCode || chainEdit->GetRevision() <= _revision)
+		return false;
+
+	// Voices:  Each voice adopts the chain of its slot (the replaced chains are left in the edit)
+	if (!_notePool->AdoptChains(chainEdit->GetVoiceChains(), chainEdit->GetVoiceCount(), playbackTime))
+		return false;
+
+	SignalChain* postProcessing = chainEdit->ExchangePostProcessing(_postProcessing);
+
+	postProcessing->Adopt(_postProcessing);
+
+	_postProcessing = postProcessing;
+
+	if (_notePool->HasEngagedNotes())
+		_postProcessing->EngageInserted(playbackTime);
+
+	_revision = chainEdit->GetRevision();
+
+	return true;
+}
+
+Synth* Synth::Adopt(Synth* previous, const PlaybackTime* playbackTime)
+{
+	_postProcessing->Adopt(previous->_postProcessing);
+
+	// Kept effects carry the previous synth's parameters
+	_postProcessing->UpdateParameters(_postProcessingSettings);
+
+	// Sounding notes are continued (not re-attacked) by this synth's voices
+	_notePool->AdoptNotes(previous->_notePool, playbackTime);
+
+	if (_notePool->HasEngagedNotes())
+		_postProcessing->Engage(playbackTime);
+
+	// A crossfade that is still in progress is cut short (its notes were continued by the previous synth)
+	Synth* retired = previous->_previous;
+
+	previous->_previous = nullptr;
+
+	_previous = previous;
+	_crossfadeFrame = 0;
+
+	return retired;
+}
+
+Synth* Synth::TakeFadedSynth()
+{
+	Synth* faded = _faded;
+
+	_faded = nullptr;
+
+	return faded;
 }
 
 void Synth::SetNote(int midiNumber, bool pressed, const PlaybackTime* playbackTime)
@@ -55,8 +178,8 @@ void Synth::SetNote(int midiNumber, bool pressed, const PlaybackTime* playbackTi
 	else if (isEngaged && !pressed)
 		_notePool->NoteOff(midiNumber, playbackTime);
 
-	// Note On
-	else if (!isEngaged && pressed && _notePool->CanEngageNextNote())
+	// Note On (steals a voice when the polyphony is used up)
+	else if (!isEngaged && pressed)
 		_notePool->NoteOn(midiNumber, playbackTime);
 
 	// Post-Processing (All Notes)
@@ -65,6 +188,20 @@ void Synth::SetNote(int midiNumber, bool pressed, const PlaybackTime* playbackTi
 	else
 		_postProcessing->DisEngage(playbackTime);
 }
+void Synth::ReleaseNotes(const PlaybackTime* playbackTime)
+{
+	for (int midiNumber = 0; midiNumber < MIDI_NOTE_COUNT; midiNumber++)
+	{
+		if (_notePool->IsEngaged(midiNumber))
+			SetNote(midiNumber, false, playbackTime);
+	}
+}
+
+bool Synth::HasEngagedNotes() const
+{
+	return _notePool->HasEngagedNotes();
+}
+
 bool Synth::GetSample(PlaybackFrame* frame, const PlaybackTime* playbackTime, float gain, float leftRightBalance)
 {
 	bool hasOutput = false;
@@ -75,18 +212,144 @@ bool Synth::GetSample(PlaybackFrame* frame, const PlaybackTime* playbackTime, fl
 		voice->AddFrame(frame, playbackTime);
 	});
 
-	// Post Processing
+	// Synth Swap:  The previous voices are crossfaded out (see Crossfade)
+	if (_previous != nullptr)
+	{
+		PlaybackFrame previousFrame;
+
+		_previous->_notePool->IterateNotes(playbackTime, [&previousFrame, &playbackTime](SynthVoiceBase* voice, bool isEnagaged)
+		{
+			voice->AddFrame(&previousFrame, playbackTime);
+		});
+
+		float level = _crossfadeFrame / (float)_crossfadeFrames;
+
+		frame->MultFrame(level, level);
+		frame->AddFrame(previousFrame.GetLeft() * (1 - level), previousFrame.GetRight() * (1 - level));
+
+		if (++_crossfadeFrame >= _crossfadeFrames)
+		{
+			_faded = _previous;
+			_previous = nullptr;
+		}
+	}
+
+	// Post Processing:  Silent effects are put to sleep by the chain (see SilenceDetector)
 	hasOutput |= _postProcessing->HasOutput(playbackTime);
 
-	//if (_postProcessing->HasOutput(absoluteTime))
-		_postProcessing->SetFrame(frame, playbackTime);
+	_postProcessing->SetFrame(frame, playbackTime);
+
+	// This is now being used for error modes (the output is tracked per node by the SignalChain)
+	return true;
+}
+
+bool Synth::ProcessBlock(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount, float gain, float leftRightBalance)
+{
+	RenderVoices(block, playbackTime, frameCount);
+
+	// Synth Swap:  The previous voices are crossfaded out (see Adopt)
+	if (_previous != nullptr)
+		Crossfade(block, playbackTime, frameCount);
+
+	// Post Processing:  Nodes that are silent (input, and output) are bypassed (see SignalChain)
+	_postProcessing->ProcessBlock(block, playbackTime, frameCount);
 
-	// This is now being used for error modes. The has output has been put on hold.. The problem is that the
-	// post processing chain must have a way to have a "signal" way to say whether the output has dimished. So,
-	// there would be some sort of filter or difference equation specifying how the output has "gone away" so 
-	// that the output may be shut off. Essentially, that would be a noise gate; but we want to allow the
-	// effect to say when it's finished - so each effect must be responsible for that output.. But, we could add
-	// a noise gate "default" somehow.
-	//
+	// (see GetSample)
 	return true;
 }
+
+void Synth::RenderVoices(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+{
+	AudioBlock* voiceBlock = _voiceBlock;
+	SynthVoiceBank* voiceBank = _voiceBank;
+
+	block->Clear(frameCount);
+	voiceBank->Clear();
+
+	// Primary Synth Voice(s) (Also, prunes note pool):  Plain oscillator voices are rendered together by the
+	// voice bank; and the rest render themselves.
+	_notePool->IterateNotes(playbackTime, [&block, &voiceBlock, &voiceBank, &playbackTime, &frameCount](SynthVoiceBase* voice, bool isEnagaged)
+	{
+		if (voice->AddToBank(voiceBank, playbackTime))
+			return;
+
+		// Mono voices stay mono until a node of their insert chain needs both channels (see AudioBlock::IsMono)
+		voiceBlock->SetMono(voice->HasMonoOutput());
+
+		voice->ProcessBlock(voiceBlock, playbackTime, frameCount);
+
+		block->AddBlock(voiceBlock, frameCount);
+	});
+
+	voiceBank->Render(block, playbackTime, frameCount);
+}
+
+void Synth::Crossfade(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+{
+	_previous->RenderVoices(_crossfadeBlock, playbackTime, frameCount);
+
+	float* left = block->GetLeft();
+	float* right = block->GetRight();
+	const float* previousLeft = _crossfadeBlock->GetLeft();
+	const float* previousRight = _crossfadeBlock->GetRightSignal();
+
+	// Linear crossfade (the continued notes are correlated with the previous notes)
+	for (int index = 0; index < frameCount; index++)
+	{
+		float level = std::min((_crossfadeFrame + index) / (float)_crossfadeFrames, 1.0f);
+
+		left[index] = (left[index] * level) + (previousLeft[index] * (1 - level));
+		right[index] = (right[index] * level) + (previousRight[index] * (1 - level));
+	}
+
+	_crossfadeFrame += frameCount;
+
+	// Finished:  Handed back to the device to be retired (see TakeFadedSynth)
+	if (_crossfadeFrame >= _crossfadeFrames)
+	{
+		_faded = _previous;
+		_previous = nullptr;
+	}
+}
+
+bool Synth::ProcessBlock(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount, float gain, float leftRightBalance, BlockEventSchedule* events)
+{
+	bool hasOutput = false;
+	int frameOffset = 0;
+
+	// Sub-blocks are views of the output block (no allocation)
+	while (frameOffset < frameCount)
+	{
+		PlaybackTime subBlockTime = playbackTime->Offset(frameOffset, _samplingRate);
+
+		// Apply events that are due
+		while (events->IsDue(subBlockTime.frameCursor))
+			ApplyEvent(events->Next(), &subBlockTime);
+
+		// Render up to the next event (or the end of the block)
+		int subBlockCount = events->GetNextOffset(&subBlockTime, frameCount - frameOffset);
+
+		AudioBlock subBlock(block, frameOffset, subBlockCount);
+
+		hasOutput |= this->ProcessBlock(&subBlock, &subBlockTime, subBlockCount, gain, leftRightBalance);
+
+		frameOffset += subBlockCount;
+	}
+
+	return hasOutput;
+}
+
+void Synth::ApplyEvent(const BlockEvent& blockEvent, const PlaybackTime* playbackTime)
+{
+	switch (blockEvent.type)
+	{
+	case BlockEventType::NoteOn:
+		SetNote(blockEvent.midiNumber, true, playbackTime);
+		break;
+	case BlockEventType::NoteOff:
+		SetNote(blockEvent.midiNumber, false, playbackTime);
+		break;
+	default:
+		throw new std::exception("Unhandled block event type:  Synth.cpp");
+	}
+}
@@ -3,13 +3,18 @@
 #ifndef SYNTH_H
 #define SYNTH_H
 
+#include "AudioBlock.h"
+#include "BlockEventSchedule.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "SignalChain.h"
+#include "SignalChainSettings.h"
 #include "SoundRegistry.h"
 #include "SoundSettings.h"
+#include "SynthChainEdit.h"
 #include "SynthSettings.h"
+#include "SynthVoiceBank.h"
 #include "SynthVoiceBase.h"
 #include "SynthVoicePool.h"
 
@@ -26,17 +31,103 @@ public:
 	// Update Configuration
 	void Initialize(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters);
 
-	// Update Configuration
-	void Update(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters);
+	/// <summary>
+	/// Updates the synth parameters (safe for the audio thread). Returns false if the settings require a new
+	/// voice pool (see GetStructureHashCode); which must be built by the SynthBuilder*. Effect chains that do not
+	/// match the settings topology are updated once their chain edit is adopted (see AdoptChains).
+	/// </summary>
+	bool Update(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters);
+
+	/// <summary>
+	/// Returns the hash of the settings used to build the voice pool, and effect chains
+	/// </summary>
+	size_t GetStructureHashCode() const { return _structureHashCode; }
+
+	/// <summary>
+	/// Returns a hash of the settings that require re-building the synth:  voice type, and polyphony. Any other
+	/// setting may be updated in place (effect chain edits are adopted, see AdoptChains).
+	/// </summary>
+	static size_t GetStructureHashCode(const SoundSettings* soundSettings);
+
+	/// <summary>
+	/// Returns a hash of the effect chain topologies (insert, and post processing); which are changed by a chain
+	/// edit (see SynthChainEdit)
+	/// </summary>
+	static size_t GetChainHashCode(const SoundSettings* soundSettings);
+
+	/// <summary>
+	/// Revision of the settings that the synth was built from (or its chains; see AdoptChains). Set by the
+	/// SynthBuilder*.
+	/// </summary>
+	size_t GetRevision() const { return _revision; }
+	void SetRevision(size_t revision) { _revision = revision; }
+
+	/// <summary>
+	/// (Audio Thread) Takes over the effect chains of the edit (see SignalChain::Adopt), keeping the voices, and the
+	/// sounding notes. The edit is left with the replaced chains; and must be disposed of off the audio thread.
+	/// Returns false (without changes) if the edit was built for a different structure, or an older revision.
+	/// </summary>
+	bool AdoptChains(SynthChainEdit* chainEdit, const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// (Audio Thread) Takes over from the synth that this one replaces:  The post processing effects are adopted (see
+	/// SignalChain::Adopt); and the sounding notes are continued by this synth's voices, with their envelopes (see
+	/// SynthVoicePool::AdoptNotes). The previous voices keep rendering, and are crossfaded out; then the previous synth
+	/// is handed back by TakeFadedSynth. Returns a synth that must be retired now (a crossfade that was cut short), or
+	/// nullptr.
+	/// </summary>
+	Synth* Adopt(Synth* previous, const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// (Audio Thread) Returns the previous synth once its crossfade has finished (see Adopt); or nullptr. The synth must
+	/// be disposed of off the audio thread.
+	/// </summary>
+	Synth* TakeFadedSynth();
 
 	// Sets midi notes on / off
 	void SetNote(int midiNumber, bool pressed, const PlaybackTime* playbackTime);
 
+	/// <summary>
+	/// Sets every engaged note off (the notes ring out)
+	/// </summary>
+	void ReleaseNotes(const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// Returns true if any notes are engaged (the events that have been applied)
+	/// </summary>
+	bool HasEngagedNotes() const;
+
 	/// <summary>
 	/// Synthesizes a full output at the specified stream time. Returns true if there was output this call.
 	/// </summary>
 	bool GetSample(PlaybackFrame* frame, const PlaybackTime* playbackTime, float gain, float leftRightBalance);
 
+	/// <summary>
+	/// Synthesizes a block of frames starting at the playback time, overwriting the block. The frame count
+	/// must not exceed AUDIO_BLOCK_SIZE. Returns true if there was output this call.
+	/// </summary>
+	bool ProcessBlock(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount, float gain, float leftRightBalance);
+
+	/// <summary>
+	/// Synthesizes a block of frames, applying the scheduled events on their exact frame. The block is split at
+	/// each event; and the sub-blocks are rendered in between. Returns true if there was output this call.
+	/// </summary>
+	bool ProcessBlock(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount, float gain, float leftRightBalance, BlockEventSchedule* events);
+
+private:
+
+	void ApplyEvent(const BlockEvent& blockEvent, const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// Renders the voices (without post processing), overwriting the block
+	/// </summary>
+	void RenderVoices(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount);
+
+	/// <summary>
+	/// Fades the block in, and mixes in the previous synth's voices fading out (see Adopt)
+	/// </summary>
+	void Crossfade(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount);
+
 private:
 
 	// Synth Note Pool (maintains a small cache of notes) (these contain envelope, and note processor data)
@@ -45,6 +136,28 @@ private:
 	// Post-processing effects	
 	SignalChain* _postProcessing;
 
+	// Post-processing settings (applied to the effects taken over from the previous synth; see Adopt)
+	SignalChainSettings* _postProcessingSettings;
+
+	// Scratch block for rendering each voice before it is mixed
+	AudioBlock* _voiceBlock;
+
+	// Struct-of-arrays renderer for the plain oscillator voices
+	SynthVoiceBank* _voiceBank;
+
+	// Synth Swap:  Previous synth (its voices are crossfaded out); and the previous synth after the crossfade
+	Synth* _previous;
+	Synth* _faded;
+	AudioBlock* _crossfadeBlock;
+	int _crossfadeFrame;
+	int _crossfadeFrames;
+
+	// Registry for the checked out effects (returned on ~Synth)
+	SoundRegistry* _effectRegistry;
+
+	size_t _structureHashCode;
+	size_t _revision;
+
 	unsigned int _numberOfChannels;
 	unsigned int _samplingRate;
 	unsigned int _octave;
@@ -0,0 +1,253 @@
+#include "PlaybackInfo.h"
+#include "SoundRegistry.h"
+#include "SpscQueue.h"
+#include "Synth.h"
+#include "SynthBuilder.h"
+#include "SynthChainEdit.h"
+#include "SynthSettings.h"
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+SynthBuilder::SynthBuilder(SoundRegistry* effectRegistry, const PlaybackInfo* parameters)
+{
+	_effectRegistry = effectRegistry;
+	_parameters = parameters;
+
+	// MEMORY! ~SynthBuilder
+	_pending = new SpscQueue<Synth*>(QUEUE_CAPACITY);
+	_retired = new SpscQueue<Synth*>(QUEUE_CAPACITY);
+	_pendingEdits = new SpscQueue<SynthChainEdit*>(QUEUE_CAPACITY);
+	_retiredEdits = new SpscQueue<SynthChainEdit*>(QUEUE_CAPACITY);
+
+	_thread = nullptr;
+	_requestedSettings = nullptr;
+	_requestDirty = false;
+	_invalidated = false;
+	_stopping = false;
+	_lastBuiltHash = 0;
+	_lastChainHash = 0;
+	_revision = 0;
+}
+
+SynthBuilder::~SynthBuilder()
+{
+	if (_thread != nullptr)
+		this->Stop();
+
+	delete _pending;
+	delete _retired;
+	delete _pendingEdits;
+	delete _retiredEdits;
+
+	if (_requestedSettings != nullptr)
+		delete _requestedSettings;
+}
+
+void SynthBuilder::Start(size_t currentStructureHash, size_t currentChainHash)
+{
+	if (_thread != nullptr)
+		throw new std::exception("Synth builder already started:  SynthBuilder.cpp");
+
+	_lastBuiltHash = currentStructureHash;
+	_lastChainHash = currentChainHash;
+	_stopping = false;
+
+	// MEMORY! ~SynthBuilder -> Stop
+	_thread = new std::thread(&SynthBuilder::Loop, this);
+}
+
+void SynthBuilder::Stop()
+{
+	if (_thread == nullptr)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_requestMutex);
+		_stopping = true;
+	}
+
+	_requestCondition.notify_one();
+	_thread->join();
+
+	delete _thread;
+	_thread = nullptr;
+
+	// (The audio stream must be stopped, see MainController::Dispose) Pending builds were never played
+	Synth* synth = nullptr;
+
+	while (_pending->Pop(synth))
+		_retired->Push(synth);
+
+	SynthChainEdit* chainEdit = nullptr;
+
+	while (_pendingEdits->Pop(chainEdit))
+		_retiredEdits->Push(chainEdit);
+
+	DeleteRetired();
+}
+
+void SynthBuilder::Request(const SynthSettings* configuration)
+{
+	{
+		std::lock_guard<std::mutex> lock(_requestMutex);
+
+		if (_requestedSettings != nullptr)
+			delete _requestedSettings;
+
+		// MEMORY! ~SynthBuilder
+		_requestedSettings = new SynthSettings(*configuration);
+		_requestDirty = true;
+	}
+
+	_requestCondition.notify_one();
+}
+
+void SynthBuilder::Invalidate()
+{
+	{
+		std::lock_guard<std::mutex> lock(_requestMutex);
+
+		_invalidated = true;
+		_requestDirty = _requestedSettings != nullptr;
+	}
+
+	_requestCondition.notify_one();
+}
+
+Synth* SynthBuilder::TakePending()
+{
+	Synth* latest = nullptr;
+	Synth* synth = nullptr;
+
+	while (_pending->Pop(synth))
+	{
+		// Superseded builds go straight back to the builder
+		if (latest != nullptr)
+			_retired->Push(latest);
+
+		latest = synth;
+	}
+
+	return latest;
+}
+
+void SynthBuilder::Retire(Synth* synth)
+{
+	// The retired queue is drained every builder cycle; so it will not fill up in practice
+	_retired->Push(synth);
+}
+
+SynthChainEdit* SynthBuilder::TakePendingEdit()
+{
+	SynthChainEdit* latest = nullptr;
+	SynthChainEdit* chainEdit = nullptr;
+
+	while (_pendingEdits->Pop(chainEdit))
+	{
+		// Superseded edits go straight back to the builder
+		if (latest != nullptr)
+			_retiredEdits->Push(latest);
+
+		latest = chainEdit;
+	}
+
+	return latest;
+}
+
+void SynthBuilder::RetireEdit(SynthChainEdit* chainEdit)
+{
+	// (see Retire)
+	_retiredEdits->Push(chainEdit);
+}
+
+void SynthBuilder::Loop()
+{
+	while (true)
+	{
+		SynthSettings* settings = nullptr;
+		bool invalidated = false;
+
+		{
+			// Wake on request; or poll the retired queue
+			std::unique_lock<std::mutex> lock(_requestMutex);
+
+			_requestCondition.wait_for(lock, std::chrono::milliseconds(10), [this] { return _stopping || _requestDirty; });
+
+			if (_stopping)
+				break;
+
+			if (_requestDirty)
+			{
+				// MEMORY! (Copied under the lock, and built outside of it)
+				settings = new SynthSettings(*_requestedSettings);
+				invalidated = _invalidated;
+
+				_requestDirty = false;
+				_invalidated = false;
+			}
+		}
+
+		DeleteRetired();
+
+		// Voice effects that were reset by the audio thread (see AirwindowsEffect::Clear)
+		_effectRegistry->RefreshEffects();
+
+		if (settings == nullptr)
+			continue;
+
+		size_t structureHash = Synth::GetStructureHashCode(settings->GetCurrentSoundSettings());
+		size_t chainHash = Synth::GetChainHashCode(settings->GetCurrentSoundSettings());
+
+		// Parameter changes are applied by the audio thread (see Synth::Update)
+		if (invalidated || structureHash != _lastBuiltHash)
+		{
+			// MEMORY! ~SynthBuilder -> TakePending -> PlaybackDevice -> Retire
+			Synth* synth = new Synth(settings, _parameters->GetStreamInfo()->streamChannels, _parameters->GetStreamInfo()->streamSampleRate);
+
+			synth->Initialize(_effectRegistry, settings, _parameters);
+			synth->SetRevision(++_revision);
+
+			if (_pending->Push(synth))
+			{
+				_lastBuiltHash = structureHash;
+				_lastChainHash = chainHash;
+			}
+
+			else
+				delete synth;
+		}
+
+		// Chain edits are adopted by the playing synth (its voices are kept)
+		else if (chainHash != _lastChainHash)
+		{
+			int voiceCount = SynthVoicePool::GetCapacity(settings->GetCurrentSoundSettings());
+
+			// MEMORY! ~SynthBuilder -> TakePendingEdit -> RetireEdit
+			SynthChainEdit* chainEdit = new SynthChainEdit(_effectRegistry, settings->GetCurrentSoundSettings(), _parameters, voiceCount, structureHash, ++_revision);
+
+			if (_pendingEdits->Push(chainEdit))
+				_lastChainHash = chainHash;
+
+			else
+				delete chainEdit;
+		}
+
+		delete settings;
+	}
+}
+
+void SynthBuilder::DeleteRetired()
+{
+	Synth* synth = nullptr;
+
+	while (_retired->Pop(synth))
+		delete synth;
+
+	SynthChainEdit* chainEdit = nullptr;
+
+	while (_retiredEdits->Pop(chainEdit))
+		delete chainEdit;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#ifndef SYNTH_BUILDER_H
+#define SYNTH_BUILDER_H
+
+#include "PlaybackInfo.h"
+#include "SoundRegistry.h"
+#include "SpscQueue.h"
+#include "Synth.h"
+#include "SynthChainEdit.h"
+#include "SynthSettings.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/// <summary>
+/// Builds Synth* instances (voice pools, and effect chains) on a background thread. The audio thread picks up the
+/// latest build with TakePending(), and hands back the previous instance with Retire(). Neither call blocks, or
+/// allocates; so all construction, plugin checkout, and deletion happen off the audio thread.
+///
+/// Effect chain edits do not re-build the synth:  The chains are built as a SynthChainEdit*, which the playing synth
+/// adopts (see Synth::AdoptChains); and are handed back the same way (see TakePendingEdit, and RetireEdit).
+/// </summary>
+class SynthBuilder
+{
+public:
+
+	SynthBuilder(SoundRegistry* effectRegistry, const PlaybackInfo* parameters);
+	~SynthBuilder();
+
+	/// <summary>
+	/// Starts the builder thread. The structure, and chain, hashes are those of the Synth* that is already playing
+	/// (see Synth::GetStructureHashCode, and Synth::GetChainHashCode).
+	/// </summary>
+	void Start(size_t currentStructureHash, size_t currentChainHash);
+
+	/// <summary>
+	/// Stops the builder thread; and deletes any pending, or retired, Synth* instances.
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// (UI Thread) Requests a build for the settings, if they require a new voice pool, or effect chains. The
+	/// settings are copied.
+	/// </summary>
+	void Request(const SynthSettings* configuration);
+
+	/// <summary>
+	/// (UI Thread) Forces a build for the last requested settings (e.g. when switching playback devices)
+	/// </summary>
+	void Invalidate();
+
+	/// <summary>
+	/// (Audio Thread) Returns the latest built Synth*, or nullptr. Older builds are retired.
+	/// </summary>
+	Synth* TakePending();
+
+	/// <summary>
+	/// (Audio Thread) Hands a Synth* back to the builder to be deleted
+	/// </summary>
+	void Retire(Synth* synth);
+
+	/// <summary>
+	/// (Audio Thread) Returns the latest chain edit, or nullptr. Older edits are retired. Call after TakePending
+	/// (edits that were built before the latest synth are rejected by it; see Synth::AdoptChains).
+	/// </summary>
+	SynthChainEdit* TakePendingEdit();
+
+	/// <summary>
+	/// (Audio Thread) Hands a chain edit (adopted, or rejected) back to the builder to be deleted
+	/// </summary>
+	void RetireEdit(SynthChainEdit* chainEdit);
+
+private:
+
+	void Loop();
+	void DeleteRetired();
+
+private:
+
+	static const int QUEUE_CAPACITY = 8;
+
+	SoundRegistry* _effectRegistry;
+	const PlaybackInfo* _parameters;
+
+	SpscQueue<Synth*>* _pending;
+	SpscQueue<Synth*>* _retired;
+	SpscQueue<SynthChainEdit*>* _pendingEdits;
+	SpscQueue<SynthChainEdit*>* _retiredEdits;
+
+	// Builder Thread
+	std::thread* _thread;
+	std::mutex _requestMutex;
+	std::condition_variable _requestCondition;
+
+	// Shared:  Protected by the request mutex
+	SynthSettings* _requestedSettings;
+	bool _requestDirty;
+	bool _invalidated;
+	bool _stopping;
+
+	// Builder Thread
+	size_t _lastBuiltHash;
+	size_t _lastChainHash;
+	size_t _revision;
+};
+
+#endif
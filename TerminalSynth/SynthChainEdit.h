@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef SYNTH_CHAIN_EDIT_H
+#define SYNTH_CHAIN_EDIT_H
+
+#include "Constant.h"
+#include "PlaybackInfo.h"
+#include "SignalChain.h"
+#include "SoundRegistry.h"
+#include "SoundSettings.h"
+
+/// <summary>
+/// Effect chains for a chain edit (insert, remove, enable, or re-order effects), built off the audio thread by the
+/// SynthBuilder*:  The post processing chain, and the insert chain of each voice. The playing Synth* adopts them
+/// (see Synth::AdoptChains), keeping its voices; which leaves this holding the replaced chains. It is handed back
+/// to the builder, which checks the effects back in, and deletes it.
+/// </summary>
+class SynthChainEdit
+{
+public:
+
+	/// <summary>
+	/// Builds the chains for the sound settings. The structure hash (see Synth::GetStructureHashCode), and voice
+	/// count, must match the synth that adopts the chains; and the revision orders the edit against the synth builds.
+	/// </summary>
+	SynthChainEdit(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters, int voiceCount, size_t structureHashCode, size_t revision)
+	{
+		_effectRegistry = effectRegistry;
+		_structureHashCode = structureHashCode;
+		_revision = revision;
+		_voiceCount = voiceCount;
+
+		// MEMORY! ~SynthChainEdit (or exchanged with the synth's chains; see Synth::AdoptChains)
+		_postProcessing = new SignalChain();
+		_postProcessing->Initialize(effectRegistry, soundSettings->GetPostProcessing(), parameters);
+		_postProcessing->UpdateParameters(soundSettings->GetPostProcessing());
+		_postProcessing->Clear();
+
+		_voiceChains = new SignalChain*[_voiceCount];
+
+		for (int index = 0; index < _voiceCount; index++)
+		{
+			_voiceChains[index] = new SignalChain();
+			_voiceChains[index]->Initialize(effectRegistry, soundSettings->GetSignalChain(), parameters, SYNTH_VOICE_EFFECT_MAX);
+			_voiceChains[index]->UpdateParameters(soundSettings->GetSignalChain());
+			_voiceChains[index]->Clear();
+		}
+	}
+	~SynthChainEdit()
+	{
+		// Effects are returned to the SoundRegistry* (edits are disposed off the audio thread)
+		_postProcessing->Release(_effectRegistry);
+
+		delete _postProcessing;
+
+		for (int index = 0; index < _voiceCount; index++)
+		{
+			_voiceChains[index]->Release(_effectRegistry);
+
+			delete _voiceChains[index];
+		}
+
+		delete[] _voiceChains;
+	}
+
+	SynthChainEdit(const SynthChainEdit& copy) = delete;
+	SynthChainEdit& operator=(const SynthChainEdit& copy) = delete;
+
+	size_t GetStructureHashCode() const { return _structureHashCode; }
+	size_t GetRevision() const { return _revision; }
+	int GetVoiceCount() const { return _voiceCount; }
+
+	/// <summary>
+	/// (Audio Thread) Exchanges the post processing chain (see Synth::AdoptChains)
+	/// </summary>
+	SignalChain* ExchangePostProcessing(SignalChain* chain)
+	{
+		SignalChain* result = _postProcessing;
+
+		_postProcessing = chain;
+
+		return result;
+	}
+
+	/// <summary>
+	/// (Audio Thread) The insert chain for each voice (exchanged by SynthVoicePool::AdoptChains)
+	/// </summary>
+	SignalChain** GetVoiceChains() const { return _voiceChains; }
+
+private:
+
+	SoundRegistry* _effectRegistry;
+
+	size_t _structureHashCode;
+	size_t _revision;
+
+	SignalChain* _postProcessing;
+
+	// Voice Chains (voice count)
+	SignalChain** _voiceChains;
+	int _voiceCount;
+};
+
+#endif
@@ -16,12 +16,18 @@ public:
 	unsigned int arpeggioBPM;
 	double portamentoSeconds;
 
+	// Voice allocation (see SynthVoicePool)
+	unsigned int polyphony;
+	VoiceStealMode stealMode;
+
 	bool IsEqual(const SynthNoteParameters* other)
 	{
 		return this->mode == other->mode &&
 			this->chord == other->chord &&
 			this->arpeggioBPM == other->arpeggioBPM &&
-			this->portamentoSeconds == other->portamentoSeconds;
+			this->portamentoSeconds == other->portamentoSeconds &&
+			this->polyphony == other->polyphony &&
+			this->stealMode == other->stealMode;
 	}
 
 	void Save(std::ostream& stream)
@@ -30,18 +36,23 @@ public:
 		stream << (int)this->chord;
 		stream << this->arpeggioBPM;
 		stream << this->portamentoSeconds;
+		stream << this->polyphony;
+		stream << (int)this->stealMode;
 	}
 	void Read(std::istream& stream)
 	{
-		int mode_, chord_;
+		int mode_, chord_, stealMode_;
 
 		stream >> mode_;
 		stream >> chord_;
 		stream >> this->arpeggioBPM;
 		stream >> this->portamentoSeconds;
+		stream >> this->polyphony;
+		stream >> stealMode_;
 
 		this->mode = (SynthNoteMode)mode_;
 		this->chord = (ArpeggiatorChord)chord_;
+		this->stealMode = (VoiceStealMode)stealMode_;
 	}
 };
 
@@ -49,14 +49,17 @@ private:
 	// Synth Note Parameters
 	SliderUI* _arpeggiatorBPMUI;
 	SliderUI* _portamentoSecondsUI;
+	SliderUI* _polyphonyUI;
 
 	// Oscillator Selected Index
 	ValueCapture<int>* _noteModeSelectedIndex;
 	ValueCapture<int>* _arpeggiatorChordSelectedIndex;
+	ValueCapture<int>* _stealModeSelectedIndex;
 
 	// Oscillator Choices
 	std::vector<std::string>* _noteModeItems;
 	std::vector<std::string>* _arpeggiatorChordItems;
+	std::vector<std::string>* _stealModeItems;
 };
 
 SynthNoteParametersUI::SynthNoteParametersUI(const SynthNoteParameters& parameters)
@@ -77,12 +80,19 @@ SynthNoteParametersUI::SynthNoteParametersUI(const SynthNoteParameters& paramete
 		"Minor 7b5",
 		"Diminished 7"
 	});
+	_stealModeItems = new std::vector<std::string>({
+		"Steal Oldest",
+		"Steal Quietest",
+		"Steal Same Note"
+	});
 
 	_noteModeSelectedIndex = new ValueCapture<int>((int)parameters.mode);
 	_arpeggiatorChordSelectedIndex = new ValueCapture<int>((int)parameters.chord);
+	_stealModeSelectedIndex = new ValueCapture<int>((int)parameters.stealMode);
 
 	_arpeggiatorBPMUI = new SliderUI(parameters.arpeggioBPM, 60.0f, 240.0f, 1.0f, "ArpeggiatorBPM", "Arpeggiator BPM {:3.0f} ", ftxui::Color::Blue, ftxui::Color::BlueLight);
 	_portamentoSecondsUI = new SliderUI(parameters.portamentoSeconds, 0.0f, 1.0f, 0.01f, "Portamento", "Portamento      {:.2f}", ftxui::Color::Blue, ftxui::Color::BlueLight);
+	_polyphonyUI = new SliderUI(parameters.polyphony, 1.0f, SYNTH_POLYPHONY_MAX, 1.0f, "Polyphony", "Polyphony       {:3.0f} ", ftxui::Color::Blue, ftxui::Color::BlueLight);
 }
 
 SynthNoteParametersUI::~SynthNoteParametersUI()
@@ -91,16 +101,20 @@ SynthNoteParametersUI::~SynthNoteParametersUI()
 
 	delete _noteModeItems;
 	delete _arpeggiatorChordItems;
+	delete _stealModeItems;
 	delete _noteModeSelectedIndex;
 	delete _arpeggiatorChordSelectedIndex;
+	delete _stealModeSelectedIndex;
 	delete _arpeggiatorBPMUI;
 	delete _portamentoSecondsUI;
+	delete _polyphonyUI;
 }
 
 void SynthNoteParametersUI::Initialize(const SynthNoteParameters& parameters)
 {
 	_arpeggiatorBPMUI->Initialize(parameters.arpeggioBPM);
 	_portamentoSecondsUI->Initialize(parameters.portamentoSeconds);
+	_polyphonyUI->Initialize(parameters.polyphony);
 
 	_component = ftxui::Container::Vertical({
 
@@ -111,7 +125,10 @@ void SynthNoteParametersUI::Initialize(const SynthNoteParameters& parameters)
 		ftxui::Dropdown(_arpeggiatorChordItems, _arpeggiatorChordSelectedIndex->GetRef()),
 
 		_arpeggiatorBPMUI->GetComponent(),
-		_portamentoSecondsUI->GetComponent()
+		_portamentoSecondsUI->GetComponent(),
+
+		ftxui::Dropdown(_stealModeItems, _stealModeSelectedIndex->GetRef()),
+		_polyphonyUI->GetComponent()
 
 	}) | ftxui::CatchEvent([&](ftxui::Event event) {
 
@@ -138,6 +155,7 @@ void SynthNoteParametersUI::UpdateComponent()
 {
 	_arpeggiatorBPMUI->UpdateComponent();
 	_portamentoSecondsUI->UpdateComponent();
+	_polyphonyUI->UpdateComponent();
 }
 
 void SynthNoteParametersUI::Tick()
@@ -158,16 +176,20 @@ bool SynthNoteParametersUI::GetDirty() const
 {
 	return _arpeggiatorBPMUI->GetDirty() ||
 		_portamentoSecondsUI->GetDirty() ||
+		_polyphonyUI->GetDirty() ||
 		_noteModeSelectedIndex->HasChanged() ||
-		_arpeggiatorChordSelectedIndex->HasChanged();
+		_arpeggiatorChordSelectedIndex->HasChanged() ||
+		_stealModeSelectedIndex->HasChanged();
 }
 
 void SynthNoteParametersUI::ClearDirty()
 {
 	_arpeggiatorBPMUI->ClearDirty();
 	_portamentoSecondsUI->ClearDirty();
+	_polyphonyUI->ClearDirty();
 	_noteModeSelectedIndex->Clear();
 	_arpeggiatorChordSelectedIndex->Clear();
+	_stealModeSelectedIndex->Clear();
 }
 
 bool SynthNoteParametersUI::HasPendingAction() const
@@ -186,15 +208,18 @@ void SynthNoteParametersUI::FromUI(SynthNoteParameters& destination)
 
 void SynthNoteParametersUI::FromUI(SynthNoteParameters* destination)
 {
-	float arpeggioBPM, pornamentoSeconds;
+	float arpeggioBPM, pornamentoSeconds, polyphony;
 
 	_arpeggiatorBPMUI->FromUI(arpeggioBPM);
 	_portamentoSecondsUI->FromUI(pornamentoSeconds);
+	_polyphonyUI->FromUI(polyphony);
 
 	destination->arpeggioBPM = arpeggioBPM;
 	destination->portamentoSeconds = pornamentoSeconds;
 	destination->mode = (SynthNoteMode)_noteModeSelectedIndex->GetValue();
 	destination->chord = (ArpeggiatorChord)_arpeggiatorChordSelectedIndex->GetValue();
+	destination->polyphony = (unsigned int)polyphony;
+	destination->stealMode = (VoiceStealMode)_stealModeSelectedIndex->GetValue();
 }
 
 #endif	
\ No newline at end of file
@@ -28,7 +28,9 @@ public:
 			.mode = SynthNoteMode::Normal,
 			.chord = ArpeggiatorChord::TriadMajor,
 			.arpeggioBPM = 60,
-			.portamentoSeconds = 0.5
+			.portamentoSeconds = 0.5,
+			.polyphony = SYNTH_POLYPHONY_DEFAULT,
+			.stealMode = VoiceStealMode::Oldest
 			});
 
 		_arpeggioCursor = 0;
@@ -46,7 +48,9 @@ public:
 			.mode = SynthNoteMode::Normal,
 			.chord = ArpeggiatorChord::TriadMajor,
 			.arpeggioBPM = 60,
-			.portamentoSeconds = 0.5
+			.portamentoSeconds = 0.5,
+			.polyphony = SYNTH_POLYPHONY_DEFAULT,
+			.stealMode = VoiceStealMode::Oldest
 		});
 
 		_arpeggioCursor = 0;
@@ -107,6 +111,14 @@ public:
 		return CalculateFrequency(_midiNumber);
 	}
 
+	/// <summary>
+	/// Returns true if GetNextFrequency is constant for the note (false for the arpeggiator)
+	/// </summary>
+	bool HasConstantFrequency() const
+	{
+		return _parameters->mode != SynthNoteMode::Arpeggiator;
+	}
+
 	float GetNextFrequency(PlaybackFrame* frame, const PlaybackTime* playbackTime)
 	{
 		switch (_parameters->mode)
@@ -3,20 +3,18 @@
 #ifndef SYNTH_PLAYBACK_DEVICE_H
 #define SYNTH_PLAYBACK_DEVICE_H
 
+#include "AudioBlock.h"
+#include "BlockEventSchedule.h"
+#include "NoteEvent.h"
 #include "PlaybackDevice.h"
 #include "PlaybackFrame.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "SoundRegistry.h"
 #include "Synth.h"
+#include "SynthChainEdit.h"
 #include "SynthSettings.h"
-#include "ValueCapture.h"
-#include "WindowsKeyCodes.h"
-#include <Windows.h>
 #include <exception>
-#include <functional>
-#include <map>
-#include <utility>
 
 class SynthPlaybackDevice : public PlaybackDevice
 {
@@ -27,24 +25,31 @@ public:
 
 	bool Initialize(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters) override;
 	bool Update(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters) override;
+	Synth* SwapSynth(Synth* synth, const PlaybackTime& playbackTime, const SynthSettings* configuration) override;
+	Synth* TakeFadedSynth() override;
+	bool AdoptChains(SynthChainEdit* chainEdit, const PlaybackTime& playbackTime) override;
 	bool SetForFrame(const PlaybackTime& playbackTime, const SynthSettings* configuration) override;
 	bool WriteSample(PlaybackFrame& playbackFrame, const PlaybackTime& playbackTime, float gain, float leftRightBalance) override;
+	bool WriteBlock(AudioBlock* block, const PlaybackTime& playbackTime, int frameCount, float gain, float leftRightBalance) override;
 
-private:
-
-	using KeyCodeIterator = std::function<void(WindowsKeyCodes keyCode, int midiNumber, bool isPressed)>;
-
-	void IterateKeyCodes(const SynthSettings* configuration, const KeyCodeIterator& callback);
+	/// <summary>
+	/// (Audio Thread) Schedules the note event for the absolute frame (see PlaybackTime::frameCursor). The event
+	/// is applied by WriteBlock on its exact frame. Returns false if the schedule is full.
+	/// </summary>
+	bool ScheduleNote(const NoteEvent& noteEvent, size_t frameCursor);
 
 private:
 
+	static const int SCHEDULE_CAPACITY = 256;
+
 	Synth* _synth;
 	unsigned int _numberOfChannels;
 	unsigned int _samplingRate;
 	bool _lastOutput;
 	bool _initialized;
 
-	std::map<int, ValueCapture<bool>*>* _keyCaptures;
+	// Note events for the current buffer (pre-allocated)
+	BlockEventSchedule* _events;
 };
 
 
@@ -56,19 +61,14 @@ SynthPlaybackDevice::SynthPlaybackDevice()
 	_synth = nullptr;
 	_initialized = false;
 
-	_keyCaptures = new std::map<int, ValueCapture<bool>*>();
+	// MEMORY! ~SynthPlaybackDevice
+	_events = new BlockEventSchedule(SCHEDULE_CAPACITY);
 }
 
 SynthPlaybackDevice::~SynthPlaybackDevice()
 {
 	delete _synth;
-
-	for (auto iter = _keyCaptures->begin(); iter != _keyCaptures->end(); ++iter)
-	{
-		delete iter->second;
-	}
-
-	delete _keyCaptures;
+	delete _events;
 }
 
 bool SynthPlaybackDevice::Initialize(SoundRegistry* effectRegistry, const SynthSettings* configuration, const PlaybackInfo* parameters)
@@ -77,16 +77,6 @@ bool SynthPlaybackDevice::Initialize(SoundRegistry* effectRegistry, const SynthS
 	_samplingRate = parameters->GetStreamInfo()->streamSampleRate;
 
 	_synth = new Synth(configuration, _numberOfChannels, _samplingRate);
-	_keyCaptures = new std::map<int, ValueCapture<bool>*>();
-
-	// Key Captures
-	auto keyCaptures = _keyCaptures;
-
-	// Key Captures -> Initialize
-	IterateKeyCodes(configuration, [&keyCaptures](WindowsKeyCodes keyCode, int midiNumber, bool isPressed) {
-
-		keyCaptures->insert(std::make_pair((int)keyCode, new ValueCapture<bool>(false)));
-	});
 
 	// Update synth configuration
 	_synth->Initialize(effectRegistry, configuration, parameters);
@@ -103,66 +93,51 @@ bool SynthPlaybackDevice::Update(SoundRegistry* effectRegistry, const SynthSetti
 	return true;
 }
 
-bool SynthPlaybackDevice::SetForFrame(const PlaybackTime& playbackTime, const SynthSettings* configuration)
+Synth* SynthPlaybackDevice::SwapSynth(Synth* synth, const PlaybackTime& playbackTime, const SynthSettings* configuration)
 {
-	if (!_initialized)
-		throw new std::exception("Audio Controller not yet initialized!");
+	Synth* previous = _synth;
 
-	bool pressedKeys = false;
+	_synth = synth;
 
-	// Iterate Key Codes (cross platform solutions will just make the platform. The windows specific ones need to be wrapped anyway.)
-	//
-	auto keyCaptures = _keyCaptures;
-	auto synth = _synth;
+	// Sounding notes are continued by the new synth; and the previous one is crossfaded out (see Synth::Adopt)
+	if (previous == nullptr)
+		return nullptr;
 
-	IterateKeyCodes(configuration, [&keyCaptures, &synth, &playbackTime, &pressedKeys](WindowsKeyCodes keyCode, int midiNumber, bool isPressed) {
-
-		// Set (if already cleared)
-		if (!keyCaptures->at((int)keyCode)->HasChanged())
-			 keyCaptures->at((int)keyCode)->SetValue(isPressed);
+	return _synth->Adopt(previous, &playbackTime);
+}
 
-		// Engage / Dis-Engage
-		if (keyCaptures->at((int)keyCode)->HasChanged())
-		{
-			// Set Note (on / off)
-			synth->SetNote(midiNumber, keyCaptures->at((int)keyCode)->GetValue(), &playbackTime);
+Synth* SynthPlaybackDevice::TakeFadedSynth()
+{
+	return _synth->TakeFadedSynth();
+}
 
-			// Reset Capture
-			keyCaptures->at((int)keyCode)->Clear();
-		}
+bool SynthPlaybackDevice::AdoptChains(SynthChainEdit* chainEdit, const PlaybackTime& playbackTime)
+{
+	return _synth->AdoptChains(chainEdit, &playbackTime);
+}
 
-		pressedKeys |= isPressed;
-	});
+bool SynthPlaybackDevice::SetForFrame(const PlaybackTime& playbackTime, const SynthSettings* configuration)
+{
+	if (!_initialized)
+		throw new std::exception("Audio Controller not yet initialized!");
 
-	return pressedKeys;
+	// Key input is scheduled by the PlaybackController* (see ScheduleNote), and applied during WriteBlock
+	return _synth->HasEngagedNotes() || !_events->IsEmpty();
 }
 
-void SynthPlaybackDevice::IterateKeyCodes(const SynthSettings* configuration, const KeyCodeIterator& callback)
+bool SynthPlaybackDevice::ScheduleNote(const NoteEvent& noteEvent, size_t frameCursor)
 {
-	for (int keyCode = (int)WindowsKeyCodes::NUMBER_0; keyCode <= (int)WindowsKeyCodes::PERIOD; keyCode++)
-	{
-		// Check that enum is defined
-		if (keyCode < 0x30 ||
-			keyCode == 0x40 ||
-			(keyCode > 0x5A && keyCode < 0x80) ||
-			(keyCode > 0x80 && keyCode < 0xBB) ||
-			(keyCode > 0xBF && keyCode < 0xDB) ||
-			(keyCode > 0xDE))
-			continue;
-
-		// Check Configuration
-		if (!configuration->HasMidiNote((WindowsKeyCodes)keyCode))
-			continue;
-
-		// Midi Note (from the key map)
-		int midiNumber = configuration->GetMidiNote((WindowsKeyCodes)keyCode);
-
-		// Pressed
-		bool isPressed = GetAsyncKeyState(keyCode) & 0x8000;
-
-		// Callback
-		callback((WindowsKeyCodes)keyCode, midiNumber, isPressed);
-	}
+	if (noteEvent.midiNumber < 0 || noteEvent.midiNumber >= 128)
+		return true;
+
+	BlockEvent blockEvent{
+		.type = noteEvent.noteOn ? BlockEventType::NoteOn : BlockEventType::NoteOff,
+		.midiNumber = noteEvent.midiNumber,
+		.velocity = noteEvent.velocity,
+		.frameCursor = frameCursor
+	};
+
+	return _events->Add(blockEvent);
 }
 
 bool SynthPlaybackDevice::WriteSample(PlaybackFrame& playbackFrame, const PlaybackTime& playbackTime, float gain, float leftRightBalance)
@@ -174,4 +149,13 @@ bool SynthPlaybackDevice::WriteSample(PlaybackFrame& playbackFrame, const Playba
 	return _synth->GetSample(&playbackFrame, &playbackTime, gain, leftRightBalance);
 }
 
+bool SynthPlaybackDevice::WriteBlock(AudioBlock* block, const PlaybackTime& playbackTime, int frameCount, float gain, float leftRightBalance)
+{
+	if (!_initialized)
+		throw new std::exception("Trying to use SynthPlaybackDevice before initializing:  SynthPlaybackDevice.h");
+
+	// Scheduled notes are applied on their exact frame (see Synth::ProcessBlock)
+	return _synth->ProcessBlock(block, &playbackTime, frameCount, gain, leftRightBalance, _events);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "AudioBlock.h"
+#include "Constant.h"
+#include "PlaybackTime.h"
+#include "SynthVoiceBank.h"
+#include "SynthVoiceBase.h"
+#include "WaveTable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+SynthVoiceBank::SynthVoiceBank()
+{
+	_kernel = SynthVoiceBankKernel::None;
+	_count = 0;
+
+	for (int index = 0; index < AUDIO_BLOCK_SIZE; index++)
+		_mix[index] = 0;
+}
+
+SynthVoiceBank::~SynthVoiceBank()
+{
+}
+
+void SynthVoiceBank::Clear()
+{
+	_kernel = SynthVoiceBankKernel::None;
+	_count = 0;
+}
+
+bool SynthVoiceBank::AddPrimitive(SynthVoiceBase* voice, PrimitiveSynthVoices waveform, uint32_t phase, uint32_t phaseIncrement, float signalHigh, float signalLow)
+{
+	// Band-limited waveforms render themselves (see Oscillator::GenerateBlock)
+	switch (waveform)
+	{
+	case PrimitiveSynthVoices::Sine:
+		return AddLane(voice, SynthVoiceBankKernel::Sine, phase, phaseIncrement, signalHigh, signalLow);
+	case PrimitiveSynthVoices::Square:
+		return AddLane(voice, SynthVoiceBankKernel::Square, phase, phaseIncrement, signalHigh, signalLow);
+	case PrimitiveSynthVoices::Triangle:
+		return AddLane(voice, SynthVoiceBankKernel::Triangle, phase, phaseIncrement, signalHigh, signalLow);
+	case PrimitiveSynthVoices::Sawtooth:
+		return AddLane(voice, SynthVoiceBankKernel::Sawtooth, phase, phaseIncrement, signalHigh, signalLow);
+	default:
+		return false;
+	}
+}
+
+bool SynthVoiceBank::AddWaveTable(SynthVoiceBase* voice, const WaveTable* waveTable, uint32_t phase, uint32_t phaseIncrement, float signalHigh, float signalLow)
+{
+	if (!AddLane(voice, SynthVoiceBankKernel::WaveTable, phase, phaseIncrement, signalHigh, signalLow))
+		return false;
+
+	_tableData[_count - 1] = waveTable->GetLevelData(WaveTable::GetLevel(phaseIncrement));
+
+	return true;
+}
+
+bool SynthVoiceBank::AddLane(SynthVoiceBase* voice, SynthVoiceBankKernel kernel, uint32_t phase, uint32_t phaseIncrement, float signalHigh, float signalLow)
+{
+	if (_count >= CAPACITY)
+		return false;
+
+	// One kernel per block (the voices of a synth are all the same type)
+	if (_kernel != SynthVoiceBankKernel::None && _kernel != kernel)
+		return false;
+
+	_kernel = kernel;
+
+	_voices[_count] = voice;
+	_phase[_count] = phase;
+	_phaseIncrement[_count] = phaseIncrement;
+	_gain[_count] = 0;
+	_gainStep[_count] = 0;
+	_scale[_count] = 0.5f * (signalHigh - signalLow);
+	_offset[_count] = 0.5f * (signalHigh + signalLow);
+	_tableData[_count] = nullptr;
+	_count++;
+
+	return true;
+}
+
+void SynthVoiceBank::Render(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount)
+{
+	if (_count == 0)
+		return;
+
+	float gainEnd[CAPACITY];
+
+	// Envelope (start of the block)
+	for (int lane = 0; lane < _count; lane++)
+	{
+		_gain[lane] = _voices[lane]->GetEnvelopeLevel(playbackTime);
+		_peak[lane] = 0;
+	}
+
+	for (int frameOffset = 0; frameOffset < frameCount; frameOffset += PARAMETER_AUTOMATION_INTERVAL)
+	{
+		int chunkCount = std::min(PARAMETER_AUTOMATION_INTERVAL, frameCount - frameOffset);
+
+		PlaybackTime chunkEndTime = playbackTime->Offset(frameOffset + chunkCount, block->GetSamplingRate());
+
+		// Envelope (end of the chunk):  Ramped linearly across the chunk
+		for (int lane = 0; lane < _count; lane++)
+		{
+			gainEnd[lane] = _voices[lane]->GetEnvelopeLevel(&chunkEndTime);
+			_gainStep[lane] = (gainEnd[lane] - _gain[lane]) / chunkCount;
+		}
+
+		RenderChunk(_mix + frameOffset, chunkCount);
+
+		// (Exact values for the next chunk)
+		for (int lane = 0; lane < _count; lane++)
+			_gain[lane] = gainEnd[lane];
+	}
+
+	float* left = block->GetLeft();
+	float* right = block->GetRight();
+
+	// (Mono)
+	for (int index = 0; index < frameCount; index++)
+	{
+		left[index] += _mix[index];
+		right[index] += _mix[index];
+	}
+
+	// Oscillator State; and the release tail (the peak of each lane's output, see SynthVoiceBase::ApplyOutputLevel)
+	for (int lane = 0; lane < _count; lane++)
+	{
+		_voices[lane]->SetBankPhase(_phase[lane]);
+		_voices[lane]->UpdateBankTail(_peak[lane], frameCount);
+	}
+}
+
+void SynthVoiceBank::RenderChunk(float* destination, int frameCount)
+{
+	const float phaseScale = 1.0f / 4294967296.0f;
+	const float fractionScale = 1.0f / (float)(1 << (32 - WaveTable::TABLE_LENGTH_BITS));
+	const uint32_t fractionMask = (1 << (32 - WaveTable::TABLE_LENGTH_BITS)) - 1;
+	const float twoPi = 2.0f * std::numbers::pi_v<float>;
+
+	// Sine (Taylor series to x^11, on [-pi / 2, pi / 2]):  The error is about 2e-7 (near the float precision)
+	const float sine3 = -1.0f / 6.0f;
+	const float sine5 = 1.0f / 120.0f;
+	const float sine7 = -1.0f / 5040.0f;
+	const float sine9 = 1.0f / 362880.0f;
+	const float sine11 = -1.0f / 39916800.0f;
+
+	for (int frame = 0; frame < frameCount; frame++)
+		destination[frame] = 0;
+
+	// Voices (outer), and frames (inner):  The phase, and gain, of each frame are computed from the start of the
+	// chunk; so the inner loops have no branches on the waveform, or loop carried dependencies (other than the
+	// peak, which is a max reduction), and accumulate into contiguous frames of the mix.
+	for (int lane = 0; lane < _count; lane++)
+	{
+		const uint32_t startPhase = _phase[lane];
+		const uint32_t phaseIncrement = _phaseIncrement[lane];
+		const float startGain = _gain[lane];
+		const float gainStep = _gainStep[lane];
+		const float scale = _scale[lane];
+		const float offset = _offset[lane];
+
+		float peak = _peak[lane];
+
+		switch (_kernel)
+		{
+		case SynthVoiceBankKernel::Sine:
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				uint32_t phase = startPhase + ((uint32_t)frame * phaseIncrement);
+
+				// The (signed) phase is in [-0.5, 0.5); and is folded into [-0.25, 0.25] about the peaks
+				float centered = (int32_t)phase * phaseScale;
+				float folded = std::copysign(0.25f - std::fabs(std::fabs(centered) - 0.25f), centered);
+
+				float x = twoPi * folded;
+				float x2 = x * x;
+				float sample = x * (1.0f + (x2 * (sine3 + (x2 * (sine5 + (x2 * (sine7 + (x2 * (sine9 + (x2 * sine11))))))))));
+
+				float output = ((scale * sample) + offset) * (startGain + (frame * gainStep));
+
+				destination[frame] += output;
+				peak = std::max(peak, std::fabs(output));
+			}
+			break;
+		case SynthVoiceBankKernel::Square:
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				uint32_t phase = startPhase + ((uint32_t)frame * phaseIncrement);
+
+				// (Top bit is the first half of the cycle)
+				float sample = (phase & 0x80000000) ? -1.0f : 1.0f;
+
+				float output = ((scale * sample) + offset) * (startGain + (frame * gainStep));
+
+				destination[frame] += output;
+				peak = std::max(peak, std::fabs(output));
+			}
+			break;
+		case SynthVoiceBankKernel::Triangle:
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				uint32_t phase = startPhase + ((uint32_t)frame * phaseIncrement);
+
+				// Rises from 0, peaks at 0.25, and bottoms out at 0.75 (the shifted phase wraps on overflow)
+				float shifted = (phase + 0xC0000000u) * phaseScale;
+				float sample = (4.0f * std::fabs(shifted - 0.5f)) - 1.0f;
+
+				float output = ((scale * sample) + offset) * (startGain + (frame * gainStep));
+
+				destination[frame] += output;
+				peak = std::max(peak, std::fabs(output));
+			}
+			break;
+		case SynthVoiceBankKernel::Sawtooth:
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				uint32_t phase = startPhase + ((uint32_t)frame * phaseIncrement);
+				float sample = (2.0f * (phase * phaseScale)) - 1.0f;
+
+				float output = ((scale * sample) + offset) * (startGain + (frame * gainStep));
+
+				destination[frame] += output;
+				peak = std::max(peak, std::fabs(output));
+			}
+			break;
+		case SynthVoiceBankKernel::WaveTable:
+		{
+			const float* data = _tableData[lane];
+
+			for (int frame = 0; frame < frameCount; frame++)
+			{
+				uint32_t phase = startPhase + ((uint32_t)frame * phaseIncrement);
+
+				int index = phase >> (32 - WaveTable::TABLE_LENGTH_BITS);
+				float fraction = (phase & fractionMask) * fractionScale;
+
+				// Cubic (Catmull-Rom), as SynthVoiceWaveTable (see WaveTable::GenerateBlock)
+				float xm1 = data[index - 1];
+				float x0 = data[index];
+				float x1 = data[index + 1];
+				float x2 = data[index + 2];
+
+				float c1 = 0.5f * (x1 - xm1);
+				float c2 = xm1 - (2.5f * x0) + (2.0f * x1) - (0.5f * x2);
+				float c3 = (0.5f * (x2 - xm1)) + (1.5f * (x0 - x1));
+
+				float sample = (((((c3 * fraction) + c2) * fraction) + c1) * fraction) + x0;
+
+				float output = ((scale * sample) + offset) * (startGain + (frame * gainStep));
+
+				destination[frame] += output;
+				peak = std::max(peak, std::fabs(output));
+			}
+		}
+		break;
+		default:
+			break;
+		}
+
+		_phase[lane] = startPhase + ((uint32_t)frameCount * phaseIncrement);
+		_gain[lane] = startGain + (frameCount * gainStep);
+		_peak[lane] = peak;
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef SYNTH_VOICE_BANK_H
+#define SYNTH_VOICE_BANK_H
+
+#include "AudioBlock.h"
+#include "Constant.h"
+#include "PlaybackTime.h"
+#include "WaveTable.h"
+#include <cstdint>
+
+class SynthVoiceBase;
+
+enum class SynthVoiceBankKernel : int
+{
+	None = 0,
+	Sine,
+	Square,
+	Triangle,
+	Sawtooth,
+	WaveTable
+};
+
+/// <summary>
+/// Struct-of-arrays renderer for the plain oscillator voices (primitive, and wave table). The voices load their
+/// oscillator state into a lane (see SynthVoiceBase::AddToBank); and the bank renders each lane into one mono
+/// mix, with the frames in the inner loop (computed from the start of the chunk), so that the compiler can
+/// vectorize across the frames (4 / 8 / 16 frames, depending on the instruction set). The envelope is sampled per voice every PARAMETER_AUTOMATION_INTERVAL
+/// frames, and ramped linearly in between. The phases, and the peak of each lane's output (for the release tail),
+/// are stored back to the voices after the block.
+/// </summary>
+class SynthVoiceBank
+{
+public:
+
+	static const int CAPACITY = 32;
+	static const int ALIGNMENT = 64;
+
+public:
+
+	SynthVoiceBank();
+	~SynthVoiceBank();
+
+	/// <summary>
+	/// Removes all lanes (start of each block)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Adds a primitive oscillator lane. Returns false if the bank is full, or is rendering a different kernel;
+	/// and the voice should render itself.
+	/// </summary>
+	bool AddPrimitive(SynthVoiceBase* voice, PrimitiveSynthVoices waveform, uint32_t phase, uint32_t phaseIncrement, float signalHigh, float signalLow);
+
+	/// <summary>
+	/// Adds a wave table lane (see AddPrimitive)
+	/// </summary>
+	bool AddWaveTable(SynthVoiceBase* voice, const WaveTable* waveTable, uint32_t phase, uint32_t phaseIncrement, float signalHigh, float signalLow);
+
+	/// <summary>
+	/// Renders (adds) all lanes into the block; and stores the phases back to the voices
+	/// </summary>
+	void Render(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount);
+
+	int GetCount() const { return _count; }
+
+private:
+
+	bool AddLane(SynthVoiceBase* voice, SynthVoiceBankKernel kernel, uint32_t phase, uint32_t phaseIncrement, float signalHigh, float signalLow);
+
+	void RenderChunk(float* destination, int frameCount);
+
+private:
+
+	SynthVoiceBankKernel _kernel;
+	int _count;
+
+	// Lanes (struct of arrays)
+	alignas(ALIGNMENT) uint32_t _phase[CAPACITY];
+	alignas(ALIGNMENT) uint32_t _phaseIncrement[CAPACITY];
+	alignas(ALIGNMENT) float _gain[CAPACITY];
+	alignas(ALIGNMENT) float _gainStep[CAPACITY];
+	alignas(ALIGNMENT) float _scale[CAPACITY];
+	alignas(ALIGNMENT) float _offset[CAPACITY];
+	alignas(ALIGNMENT) const float* _tableData[CAPACITY];
+	alignas(ALIGNMENT) float _peak[CAPACITY];
+
+	SynthVoiceBase* _voices[CAPACITY];
+
+	// Mono mix of the lanes (one block)
+	alignas(ALIGNMENT) float _mix[AUDIO_BLOCK_SIZE];
+};
+
+#endif
@@ -3,6 +3,8 @@
 #ifndef SYNTH_VOICE_BASE_H
 #define SYNTH_VOICE_BASE_H
 
+#include "AudioBlock.h"
+#include "Constant.h"
 #include "Envelope.h"
 #include "OscillatorParameters.h"
 #include "PlaybackFrame.h"
@@ -11,9 +13,12 @@
 #include "SignalBase.h"
 #include "SignalChain.h"
 #include "SignalParameterizedBase.h"
+#include "SilenceDetector.h"
 #include "SoundRegistry.h"
 #include "SoundSettings.h"
 #include "SynthNoteProcessor.h"
+#include "SynthVoiceBank.h"
+#include <cstdint>
 
 class SynthVoiceBase : public SignalParameterizedBase
 {
@@ -26,31 +31,72 @@ public:
 	SynthVoiceBase(SoundRegistry* soundRegistry, const SoundSettings* settings, const PlaybackInfo* playbackInfo) 
 		: SignalParameterizedBase(*settings->GetSynthVoiceSettings())
 	{
-		SignalChain filters;
-		filters.Initialize(soundRegistry, settings->GetSignalChain(), playbackInfo);
-
+		_soundRegistry = soundRegistry;
 		_samplingRate = playbackInfo->GetStreamInfo()->streamSampleRate;
 		_oscillatorParameters = new OscillatorParameters(*settings->GetOscillatorParameters());
 		_envelope = new Envelope(*settings->GetOscillatorEnvelope());
-		_filters = new SignalChain(filters);
+		_filters = new SignalChain();
 		_noteProcessor = new SynthNoteProcessor(settings, playbackInfo);
+		_envelopeBlock = new float[AUDIO_BLOCK_SIZE];
+		_tailDetector = new SilenceDetector();
+		_fadeStartCursor = 0;
+		_fadeFrames = 0;
 
-		_filters->Initialize(soundRegistry, settings->GetSignalChain(), playbackInfo);
+		// Insert Chain:  Instances are reserved for each voice by the SynthVoicePool (see SoundRegistry::Reserve)
+		_filters->Initialize(soundRegistry, settings->GetSignalChain(), playbackInfo, SYNTH_VOICE_EFFECT_MAX);
 		_noteProcessor->Initialize(playbackInfo);
+		_tailDetector->Configure(SILENCE_THRESHOLD_DB, SYNTH_VOICE_SILENCE_HOLD_SECONDS, _samplingRate);
 	}
-	~SynthVoiceBase()
+	virtual ~SynthVoiceBase()
 	{
+		// Effects are returned to the SoundRegistry* (voices are disposed off the audio thread)
+		_filters->Release(_soundRegistry);
+
 		delete _oscillatorParameters;
 		delete _envelope;
 		delete _filters;
 		delete _noteProcessor;
+		delete[] _envelopeBlock;
+		delete _tailDetector;
 	}
 
 	virtual bool HasOutput(const PlaybackTime* playbackTime) const override
 	{
+		// Stolen (see FadeOut)
+		if (_fadeFrames > 0 && playbackTime->frameCursor >= _fadeStartCursor + _fadeFrames)
+			return false;
+
+		// Released, and silent for the hold time (see ApplyOutputLevel)
+		if (_tailDetector->IsAsleep())
+			return false;
+
 		return _envelope->HasOutput(playbackTime);
 	}
 
+	/// <summary>
+	/// (Per-Sample) Oscillator, insert chain, and then the envelope (see ApplyOutputLevel)
+	/// </summary>
+	void SetFrame(PlaybackFrame* frame, const PlaybackTime* playbackTime) override
+	{
+		UpdateParameterAutomatersAtControlRate(frame, playbackTime);
+
+		SetFrameImpl(frame, playbackTime);
+
+		_filters->SetFrame(frame, playbackTime);
+
+		float output = GetOutputLevel(playbackTime);
+
+		frame->MultFrame(output, output);
+	}
+	void AddFrame(PlaybackFrame* frame, const PlaybackTime* playbackTime) override
+	{
+		PlaybackFrame localFrame(0, 0);
+
+		SetFrame(&localFrame, playbackTime);
+
+		frame->AddFrame(localFrame.GetLeft(), localFrame.GetRight());
+	}
+
 	// Override to update parameters (for parameter automation)
 	virtual void UpdateParameter(int index, float value) override
 	{
@@ -61,6 +107,9 @@ public:
 	{
 		SignalBase::Engage(playbackTime);
 
+		_fadeFrames = 0;
+		_tailDetector->Wake();
+
 		_noteProcessor->NoteOn(midiNumber, playbackTime);
 		_envelope->Engage(playbackTime);
 	}
@@ -71,27 +120,158 @@ public:
 		_envelope->DisEngage(playbackTime);
 		_noteProcessor->NoteOff(midiNumber, playbackTime);
 	}
+	/// <summary>
+	/// (Synth Swap) Continues the note of the previous synth's voice:  The envelope is taken over; so the note is not
+	/// re-attacked. Call after NoteOn (see SynthVoicePool::AdoptNotes)
+	/// </summary>
+	void AdoptNote(const SynthVoiceBase* previous)
+	{
+		_envelope->Adopt(previous->_envelope);
+	}
+
+	/// <summary>
+	/// (Chain Edit) Takes over the insert chain (see SignalChain::Adopt); and returns the replaced chain, which holds
+	/// the effects to check in (see SynthChainEdit)
+	/// </summary>
+	SignalChain* AdoptChain(SignalChain* chain, const PlaybackTime* playbackTime)
+	{
+		SignalChain* replaced = _filters;
+
+		chain->Adopt(replaced);
+
+		_filters = chain;
+
+		if (_envelope->IsEngaged())
+			_filters->EngageInserted(playbackTime);
+
+		return replaced;
+	}
+
 	virtual void Clear()
 	{
 		_noteProcessor->Clear();
+		_filters->Clear();
+		_fadeFrames = 0;
+		_tailDetector->Wake();
+	}
+
+	/// <summary>
+	/// (Voice Stealing) Fades the voice out over the frame count, from the playback time. The voice has no output
+	/// once the fade has finished (see SynthVoicePool)
+	/// </summary>
+	void FadeOut(const PlaybackTime* playbackTime, int frameCount)
+	{
+		_fadeStartCursor = playbackTime->frameCursor;
+		_fadeFrames = frameCount > 0 ? frameCount : 1;
 	}
 
+	bool IsFadingOut() const { return _fadeFrames > 0; }
+
+	/// <summary>
+	/// Updates the voice parameters. The voice type must match the settings (voices are re-built by the SynthBuilder*
+	/// when it changes); and the insert chain is updated once it matches the settings topology (see AdoptChain)
+	/// </summary>
 	virtual void Update(SoundRegistry* soundRegistry, const SoundSettings* settings, const PlaybackInfo* playbackInfo)
 	{
 		_samplingRate = playbackInfo->GetStreamInfo()->streamSampleRate;
 		_oscillatorParameters->Update(settings->GetOscillatorParameters());
 		_envelope->Update(settings->GetOscillatorEnvelope());
-		_filters->Update(soundRegistry, settings->GetSignalChain());
+		_filters->UpdateParameters(settings->GetSignalChain());
 		_noteProcessor->Update(settings);
 	}
 
+	/// <summary>
+	/// (Voice Bank) Loads the oscillator into a lane of the bank, if the voice can be rendered there. Returns false
+	/// if the voice must render itself (see Synth::ProcessBlock)
+	/// </summary>
+	virtual bool AddToBank(SynthVoiceBank* bank, const PlaybackTime* playbackTime)
+	{
+		return false;
+	}
+
+	/// <summary>
+	/// (Block Rendering) Returns true if the voice renders identical channels; so its block is kept mono through
+	/// the insert chain, until a node needs both channels (see AudioBlock::IsMono)
+	/// </summary>
+	virtual bool HasMonoOutput() const
+	{
+		return false;
+	}
+
+	/// <summary>
+	/// (Voice Bank) Stores the oscillator phase (32-bit fixed point) after the bank has rendered the block
+	/// </summary>
+	virtual void SetBankPhase(uint32_t phase)
+	{
+
+	}
+
+	/// <summary>
+	/// (Voice Bank) Updates the release tail with the peak of the voice's output for the block; so a released voice
+	/// ends after the same silent hold as when it renders itself (see ApplyOutputLevel)
+	/// </summary>
+	void UpdateBankTail(float peak, int frameCount)
+	{
+		if (!_envelope->IsEngaged())
+			_tailDetector->Update(_tailDetector->IsSilent(peak), frameCount);
+	}
+
+	/// <summary>
+	/// Returns the envelope level at the playback time
+	/// </summary>
+	float GetEnvelopeLevel(const PlaybackTime* playbackTime)
+	{
+		return GetOutputLevel(playbackTime);
+	}
+
 protected:
 
 	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) = 0;
 
 	float GetOutputLevel(const PlaybackTime* playbackTime) override
 	{
-		return _envelope->GetEnvelopeLevel(playbackTime);
+		float level = _envelope->GetEnvelopeLevel(playbackTime);
+
+		return _fadeFrames > 0 ? level * GetFadeLevel(playbackTime->frameCursor) : level;
+	}
+
+	void ApplyOutputLevel(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount) override
+	{
+		float* left = block->GetLeft();
+		float* right = block->GetRight();
+
+		// Insert Chain (before the envelope):  This may widen a mono block
+		_filters->ProcessBlock(block, playbackTime, frameCount);
+
+		// Envelope (segment ramps for the whole block)
+		_envelope->GenerateBlock(_envelopeBlock, playbackTime, frameCount, block->GetSamplingRate());
+
+		// Stolen (see FadeOut)
+		if (_fadeFrames > 0)
+		{
+			for (int index = 0; index < frameCount; index++)
+				_envelopeBlock[index] *= GetFadeLevel(playbackTime->frameCursor + index);
+		}
+
+		// Mono
+		if (block->IsMono())
+		{
+			for (int index = 0; index < frameCount; index++)
+				left[index] *= _envelopeBlock[index];
+		}
+		else
+		{
+			for (int index = 0; index < frameCount; index++)
+			{
+				left[index] *= _envelopeBlock[index];
+				right[index] *= _envelopeBlock[index];
+			}
+		}
+
+		// Release Tail:  The voice is finished once its output has been silent for the hold time (the envelope
+		//				  may still be above zero)
+		if (!_envelope->IsEngaged())
+			_tailDetector->Update(_tailDetector->IsSilent(SilenceDetector::GetPeak(left, block->GetRightSignal(), frameCount)), frameCount);
 	}
 
 	float GetSamplingRate() const { return _samplingRate; }
@@ -101,17 +281,46 @@ protected:
 	{
 		return _noteProcessor->GetNextFrequency(frame, playbackTime); 
 	}
+	bool HasConstantFrequency() const { return _noteProcessor->HasConstantFrequency(); }
+	bool CanRenderInBank() const { return HasConstantFrequency() && !HasParameterAutomation() && _fadeFrames == 0 && _filters->GetCount() == 0; }
 	float GetSignalHigh() const { return _oscillatorParameters->GetSignalHigh(); }
 	float GetSignalLow() const { return _oscillatorParameters->GetSignalLow(); }
 
 private:
 
+	/// <summary>
+	/// Linear fade (see FadeOut) at the frame cursor
+	/// </summary>
+	float GetFadeLevel(size_t frameCursor) const
+	{
+		if (frameCursor <= _fadeStartCursor)
+			return 1.0f;
+
+		float level = 1.0f - ((frameCursor - _fadeStartCursor) / (float)_fadeFrames);
+
+		return level > 0 ? level : 0;
+	}
+
+private:
+
+	SoundRegistry* _soundRegistry;
+
 	float _samplingRate;
 
 	OscillatorParameters* _oscillatorParameters;
 	Envelope* _envelope;
 	SignalChain* _filters;
 	SynthNoteProcessor* _noteProcessor;
+
+	// Envelope level for each frame of the block (see ApplyOutputLevel)
+	float* _envelopeBlock;
+
+	// Output energy of the release tail (see ApplyOutputLevel)
+	SilenceDetector* _tailDetector;
+
+	// Voice stealing fade out (see FadeOut)
+	size_t _fadeStartCursor;
+	int _fadeFrames;
 };
 
 #endif
\ No newline at end of file
@@ -7,18 +7,40 @@
 #include "PlaybackInfo.h"
 #include "SoundRegistry.h"
 #include "SoundSettings.h"
+#include "SynthVoiceBase.h"
 #include "SynthVoiceDirect.h"
 #include "SynthVoicePluckedString.h"
 #include "SynthVoicePrimitiveSawtooth.h"
 #include "SynthVoicePrimitiveSine.h"
 #include "SynthVoicePrimitiveSquare.h"
 #include "SynthVoicePrimitiveTriangle.h"
+#include "SynthVoiceWaveTable.h"
 #include <exception>
 
 class SynthVoiceFactory
 {
 public:
 
+	/// <summary>
+	/// Creates the synth voice for the oscillator parameters (direct, or wave table type)
+	/// </summary>
+	static SynthVoiceBase* CreateSynthVoice(SoundRegistry* soundRegistry, const SoundSettings* soundSettings, const PlaybackInfo* playbackInfo)
+	{
+		switch (soundSettings->GetOscillatorParameters()->GetVoiceType())
+		{
+		case SynthVoiceType::HarmonicShaper:
+		{
+			SynthVoiceBase* result = new SynthVoiceWaveTable(soundRegistry, soundSettings, playbackInfo);
+
+			result->Initialize(playbackInfo);
+
+			return result;
+		}
+		default:
+			return CreateSynthVoiceDirect(soundRegistry, soundSettings, playbackInfo);
+		}
+	}
+
 	static SynthVoiceDirect* CreateSynthVoiceDirect(SoundRegistry* soundRegistry, const SoundSettings* soundSettings, const PlaybackInfo* playbackInfo)
 	{
 		SynthVoiceDirect* result = nullptr;
@@ -41,6 +63,15 @@ public:
 			case PrimitiveSynthVoices::Sawtooth:
 				result = new SynthVoicePrimitiveSawtooth(soundRegistry, soundSettings, playbackInfo);
 				break;
+			case PrimitiveSynthVoices::SquareBandLimited:
+				result = new SynthVoicePrimitiveSquare(soundRegistry, soundSettings, playbackInfo, true);
+				break;
+			case PrimitiveSynthVoices::TriangleBandLimited:
+				result = new SynthVoicePrimitiveTriangle(soundRegistry, soundSettings, playbackInfo, true);
+				break;
+			case PrimitiveSynthVoices::SawtoothBandLimited:
+				result = new SynthVoicePrimitiveSawtooth(soundRegistry, soundSettings, playbackInfo, true);
+				break;
 			default:
 				throw new std::exception("Unhandled Primitive Voice Type:  SynthVoiceFactory.h");
 			}
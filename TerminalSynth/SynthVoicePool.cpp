@@ -4,64 +4,89 @@
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
 #include "SoundRegistry.h"
+#include "SignalChain.h"
+#include "SignalChainSettings.h"
+#include "SignalSettings.h"
 #include "SoundSettings.h"
 #include "SynthVoiceBase.h"
 #include "SynthVoiceFactory.h"
 #include "SynthVoicePool.h"
+#include <algorithm>
 #include <exception>
 #include <map>
-#include <stack>
-#include <utility>
-#include <vector>
+#include <string>
 
-SynthVoicePool::SynthVoicePool(SoundRegistry* soundRegistry, const SoundSettings* soundSettings, const PlaybackInfo* playbackInfo, int capacity)
+SynthVoicePool::SynthVoicePool(SoundRegistry* soundRegistry, const SoundSettings* soundSettings, const PlaybackInfo* playbackInfo)
 {
-	_capacity = capacity;
-	_noteMode = soundSettings->GetNoteParameters()->mode;
-	_playbackInfo = playbackInfo;
-	_engagedNotes = new std::map<int, SynthVoiceBase*>();
-	_disengagedNotes = new std::vector<SynthVoiceBase*>();
-	_inactiveNotes = new std::stack<SynthVoiceBase*>();
+	_polyphony = std::clamp((int)soundSettings->GetNoteParameters()->polyphony, 1, SYNTH_POLYPHONY_MAX);
+	_capacity = GetCapacity(soundSettings);
+	_stealMode = soundSettings->GetNoteParameters()->stealMode;
+	_fadeFrames = (int)(SYNTH_STEAL_FADE_SECONDS * playbackInfo->GetStreamInfo()->streamSampleRate);
+
+	// MEMORY! ~SynthVoicePool
+	_voices = new SynthVoiceBase*[_capacity];
+	_states = new VoiceState[_capacity];
+	_midiNumbers = new int[_capacity];
+	_next = new int[_capacity];
+	_previous = new int[_capacity];
 
+	for (int index = 0; index < _capacity; index++)
+		_voices[index] = nullptr;
+
+	ReserveEffects(soundRegistry, soundSettings);
 	ResetVoices(soundRegistry, soundSettings, playbackInfo);
 }
 
+int SynthVoicePool::GetCapacity(const SoundSettings* soundSettings)
+{
+	return std::clamp((int)soundSettings->GetNoteParameters()->polyphony, 1, SYNTH_POLYPHONY_MAX) + SYNTH_STEAL_RESERVE;
+}
+
 SynthVoicePool::~SynthVoicePool()
 {
 	DisposeVoices();
 
-	delete _engagedNotes;
-	delete _disengagedNotes;
-	delete _inactiveNotes;
+	delete[] _voices;
+	delete[] _states;
+	delete[] _midiNumbers;
+	delete[] _next;
+	delete[] _previous;
 }
 void SynthVoicePool::DisposeVoices()
 {
-	// Engaged
-	for (auto iter = _engagedNotes->begin(); iter != _engagedNotes->end(); ++iter)
+	for (int index = 0; index < _capacity; index++)
 	{
 		// MEMORY! ~SynthVoiceBase
-		delete iter->second;
-	}
-
-	_engagedNotes->clear();
+		if (_voices[index] != nullptr)
+			delete _voices[index];
 
-	// Disengaged
-	for (auto iter = _disengagedNotes->begin(); iter != _disengagedNotes->end(); ++iter)
-	{
-		// MEMORY! ~SynthVoiceBase
-		delete (*iter);
+		_voices[index] = nullptr;
 	}
+}
+void SynthVoicePool::ReserveEffects(SoundRegistry* soundRegistry, const SoundSettings* soundSettings)
+{
+	const SignalChainSettings* signalChain = soundSettings->GetSignalChain();
 
-	_disengagedNotes->clear();
+	// Insert Effect Limit:  Each voice holds its own instances (see SYNTH_VOICE_EFFECT_MAX)
+	if (signalChain->GetEnabledCount() > SYNTH_VOICE_EFFECT_MAX)
+		throw new std::exception("Too many enabled insert effects in the voice signal chain (see SYNTH_VOICE_EFFECT_MAX):  SynthVoicePool.cpp");
 
-	// Inactive
-	while (_inactiveNotes->size() > 0)
+	// Instances needed for each effect name (an effect may be in the chain more than once)
+	std::map<std::string, int> counts;
+
+	for (int index = 0; index < signalChain->GetCount(); index++)
 	{
-		// MEMORY! ~SynthVoiceBase
-		delete _inactiveNotes->top();
+		SignalSettings* settings = signalChain->Get(index);
+
+		// Not Enabled
+		if (!settings->GetIsEnabled())
+			continue;
 
-		_inactiveNotes->pop();
+		counts[settings->GetName()] += _capacity;
 	}
+
+	for (auto iter = counts.begin(); iter != counts.end(); ++iter)
+		soundRegistry->Reserve(iter->first, iter->second);
 }
 void SynthVoicePool::ResetVoices(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters)
 {
@@ -70,156 +95,292 @@ void SynthVoicePool::ResetVoices(SoundRegistry* effectRegistry, const SoundSetti
 	for (int index = 0; index < _capacity; index++)
 	{
 		// MEMORY! ~SynthVoicePool -> DisposeVoices
-		_inactiveNotes->push(SynthVoiceFactory::CreateSynthVoiceDirect(effectRegistry, soundSettings, parameters));
+		_voices[index] = SynthVoiceFactory::CreateSynthVoice(effectRegistry, soundSettings, parameters);
+		_states[index] = VoiceState::Inactive;
+		_midiNumbers[index] = -1;
+		_previous[index] = -1;
+		_next[index] = index + 1 < _capacity ? index + 1 : -1;
 	}
 
+	for (int index = 0; index < MIDI_NOTE_COUNT; index++)
+		_engagedSlots[index] = -1;
+
+	_freeHead = 0;
+	_activeHead = -1;
+	_activeTail = -1;
+	_soundingCount = 0;
+	_engagedCount = 0;
+
 	// Signals a voice change
 	_lastSynthVoiceHashCode = soundSettings->GetOscillatorParameters()->GetVoiceHashCode();
 }
 void SynthVoicePool::Update(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters)
 {
-	// Synth Voice Change
+	// Synth Voice Change:  The voices are re-built off the audio thread (see SynthBuilder)
 	if (_lastSynthVoiceHashCode != soundSettings->GetOscillatorParameters()->GetVoiceHashCode())
-		ResetVoices(effectRegistry, soundSettings, parameters);
-
-	// Synth Note Mode
-	_noteMode = soundSettings->GetNoteParameters()->mode;
+		throw new std::exception("Trying to update synth voices with a different voice type:  SynthVoicePool.cpp");
 
-	// Engaged
-	for (auto iter = _engagedNotes->begin(); iter != _engagedNotes->end(); ++iter)
-	{
-		iter->second->Update(effectRegistry, soundSettings, parameters);
-	}
+	_stealMode = soundSettings->GetNoteParameters()->stealMode;
+	_fadeFrames = (int)(SYNTH_STEAL_FADE_SECONDS * parameters->GetStreamInfo()->streamSampleRate);
 
-	// Disengaged
-	for (auto iter = _disengagedNotes->begin(); iter != _disengagedNotes->end(); ++iter)
-	{
-		(*iter)->Update(effectRegistry, soundSettings, parameters);
-	}
-
-	// Inactive
-	std::stack<SynthVoiceBase*> tempStack;
-
-	while (_inactiveNotes->size() > 0)
-	{
-		_inactiveNotes->top()->Update(effectRegistry, soundSettings, parameters);
-		tempStack.push(_inactiveNotes->top());
-		_inactiveNotes->pop();
-	}
-
-	while (tempStack.size() > 0)
+	for (int index = 0; index < _capacity; index++)
 	{
-		_inactiveNotes->push(tempStack.top());
-		tempStack.pop();
+		_voices[index]->Update(effectRegistry, soundSettings, parameters);
 	}
 }
 bool SynthVoicePool::HasOutput(const PlaybackTime* playbackTime)
 {
-	// Engaged
-	for (auto iter = _engagedNotes->begin(); iter != _engagedNotes->end(); ++iter)
+	for (int slot = _activeHead; slot >= 0; slot = _next[slot])
 	{
-		if (iter->second->HasOutput(playbackTime))
+		if (_voices[slot]->HasOutput(playbackTime))
 			return true;
 	}
 
-	// Disengaged (also prune collection)
-	for (auto iter = _disengagedNotes->begin(); iter != _disengagedNotes->end(); ++iter)
-	{
-		// HasOutput (ringing out of the note)
-		if ((*iter)->HasOutput(playbackTime))
-			return true;
-	}
+	return false;
 }
 bool SynthVoicePool::HasEngagedNotes() const
 {
-	return _engagedNotes->size() > 0;
-}
-bool SynthVoicePool::CanEngageNextNote() const
-{
-	switch (_noteMode)
-	{
-	case SynthNoteMode::Normal:
-	case SynthNoteMode::Arpeggiator:
-	case SynthNoteMode::Portamento:
-		return _engagedNotes->size() < _capacity;
-	
-	default:
-		throw new std::exception("Unhandled Synth Note Mode:  SynthVoiceNotePool.cpp");
-	}
+	return _engagedCount > 0;
 }
 bool SynthVoicePool::IsEngaged(int midiNumber) const
 {
-	return _engagedNotes->contains(midiNumber);
+	if (midiNumber < 0 || midiNumber >= MIDI_NOTE_COUNT)
+		return false;
+
+	return _engagedSlots[midiNumber] >= 0;
 }
 bool SynthVoicePool::NoteOn(int midiNumber, const PlaybackTime* playbackTime)
 {
+	if (midiNumber < 0 || midiNumber >= MIDI_NOTE_COUNT)
+		return false;
+
 	// Already Engaged
-	if (_engagedNotes->contains(midiNumber))
+	if (_engagedSlots[midiNumber] >= 0)
 		return true;
 
-	// Engage
-	if (_inactiveNotes->size() > 0)
+	// At Capacity:  Steal a voice (it is faded out on the reserve)
+	if (_soundingCount >= _polyphony)
 	{
-		_inactiveNotes->top()->NoteOn(midiNumber, playbackTime);
-
-		_engagedNotes->insert(std::make_pair(midiNumber, _inactiveNotes->top()));
-		_inactiveNotes->pop();
+		int victim = SelectVictim(midiNumber, playbackTime);
 
-		return true;
+		if (victim >= 0)
+			Steal(victim, playbackTime);
 	}
 
-	// At Capacity
-	else
+	int slot = TakeVoice();
+
+	if (slot < 0)
 		return false;
+
+	// Engage
+	_voices[slot]->NoteOn(midiNumber, playbackTime);
+	_states[slot] = VoiceState::Engaged;
+	_midiNumbers[slot] = midiNumber;
+	_engagedSlots[midiNumber] = slot;
+	_soundingCount++;
+	_engagedCount++;
+
+	LinkActive(slot);
+
+	return true;
 }
 
 void SynthVoicePool::NoteOff(int midiNumber, const PlaybackTime* playbackTime)
 {
-	// Not Engaged
-	if (!_engagedNotes->contains(midiNumber))
+	// Not Engaged (or stolen)
+	if (!IsEngaged(midiNumber))
 		return;
 
-	else
+	int slot = _engagedSlots[midiNumber];
+
+	_voices[slot]->NoteOff(midiNumber, playbackTime);
+
+	// Disengaged (rings out)
+	_states[slot] = VoiceState::Released;
+	_engagedSlots[midiNumber] = -1;
+	_engagedCount--;
+}
+
+bool SynthVoicePool::AdoptChains(SignalChain** chains, int chainCount, const PlaybackTime* playbackTime)
+{
+	if (chainCount != _capacity)
+		return false;
+
+	for (int index = 0; index < _capacity; index++)
+		chains[index] = _voices[index]->AdoptChain(chains[index], playbackTime);
+
+	return true;
+}
+
+void SynthVoicePool::AdoptNotes(const SynthVoicePool* previous, const PlaybackTime* playbackTime)
+{
+	for (int previousSlot = previous->_activeHead; previousSlot >= 0; previousSlot = previous->_next[previousSlot])
 	{
-		_engagedNotes->at(midiNumber)->NoteOff(midiNumber, playbackTime);
+		VoiceState state = previous->_states[previousSlot];
+		int midiNumber = previous->_midiNumbers[previousSlot];
+
+		if (state != VoiceState::Engaged && state != VoiceState::Released)
+			continue;
 
-		// Disengaged
-		_disengagedNotes->push_back(_engagedNotes->at(midiNumber));
+		if (!NoteOn(midiNumber, playbackTime))
+			continue;
 
-		// Remove Engaged Note
-		_engagedNotes->erase(midiNumber);
+		// The envelope is taken over before the note off; so a released note keeps its release time
+		_voices[_engagedSlots[midiNumber]]->AdoptNote(previous->_voices[previousSlot]);
+
+		if (state == VoiceState::Released)
+			NoteOff(midiNumber, playbackTime);
 	}
 }
 
 void SynthVoicePool::IterateNotes(const PlaybackTime* playbackTime, const SynthVoiceNotePoolIterator& callback)
 {
-	// Engaged
-	for (auto iter = _engagedNotes->begin(); iter != _engagedNotes->end(); ++iter)
+	int slot = _activeHead;
+
+	while (slot >= 0)
 	{
-		if (iter->second->HasOutput(playbackTime))
-			callback(iter->second, true);
+		int next = _next[slot];
+
+		// HasOutput (engaged, or ringing out)
+		if (_voices[slot]->HasOutput(playbackTime))
+			callback(_voices[slot], _states[slot] == VoiceState::Engaged);
+
+		// Inactive:  Complete Note Cycle (engaged notes are kept until note off)
+		else if (_states[slot] != VoiceState::Engaged)
+		{
+			UnlinkActive(slot);
+			Free(slot);
+		}
+
+		slot = next;
 	}
+}
 
-	// Disengaged (also prune collection)
-	for (auto iter = _disengagedNotes->begin(); iter != _disengagedNotes->end();)
+int SynthVoicePool::SelectVictim(int midiNumber, const PlaybackTime* playbackTime) const
+{
+	// Same Note:  Re-trigger the ringing voice of the same note, if there is one
+	if (_stealMode == VoiceStealMode::SameNote)
 	{
-		// HasOutput (ringing out of the note)
-		if ((*iter)->HasOutput(playbackTime))
+		for (int slot = _activeHead; slot >= 0; slot = _next[slot])
 		{
-			callback(*iter, false);
-			iter++;
+			if (_states[slot] == VoiceState::Released && _midiNumbers[slot] == midiNumber)
+				return slot;
 		}
+	}
+
+	// Released voices are taken before engaged voices
+	VoiceState passes[2] = { VoiceState::Released, VoiceState::Engaged };
 
-		// Inactive (Clear)
-		else
+	for (int pass = 0; pass < 2; pass++)
+	{
+		int victim = -1;
+		float victimLevel = 0;
+
+		for (int slot = _activeHead; slot >= 0; slot = _next[slot])
 		{
-			// Complete Note Cycle
-			(*iter)->Clear();
+			if (_states[slot] != passes[pass])
+				continue;
 
-			_inactiveNotes->push(*iter);
+			// Oldest (Same Note falls back to this):  The list is in the order the voices were started
+			if (_stealMode != VoiceStealMode::Quietest)
+				return slot;
 
-			// Prune Dis-Engaged Notes
-			iter = _disengagedNotes->erase(iter);
+			// Quietest
+			float level = _voices[slot]->GetEnvelopeLevel(playbackTime);
+
+			if (victim < 0 || level < victimLevel)
+			{
+				victim = slot;
+				victimLevel = level;
+			}
 		}
+
+		if (victim >= 0)
+			return victim;
 	}
+
+	return -1;
+}
+
+void SynthVoicePool::Steal(int slot, const PlaybackTime* playbackTime)
+{
+	if (_states[slot] == VoiceState::Engaged)
+	{
+		_engagedSlots[_midiNumbers[slot]] = -1;
+		_engagedCount--;
+	}
+
+	_states[slot] = VoiceState::Stolen;
+	_soundingCount--;
+
+	_voices[slot]->FadeOut(playbackTime, _fadeFrames);
+}
+
+int SynthVoicePool::TakeVoice()
+{
+	int slot = _freeHead;
+
+	if (slot >= 0)
+	{
+		_freeHead = _next[slot];
+		return slot;
+	}
+
+	// Reserve used up:  Cut the oldest stolen voice
+	for (slot = _activeHead; slot >= 0; slot = _next[slot])
+	{
+		if (_states[slot] == VoiceState::Stolen)
+		{
+			UnlinkActive(slot);
+
+			_voices[slot]->Clear();
+			_states[slot] = VoiceState::Inactive;
+
+			return slot;
+		}
+	}
+
+	return -1;
+}
+
+void SynthVoicePool::LinkActive(int slot)
+{
+	_previous[slot] = _activeTail;
+	_next[slot] = -1;
+
+	if (_activeTail >= 0)
+		_next[_activeTail] = slot;
+	else
+		_activeHead = slot;
+
+	_activeTail = slot;
+}
+
+void SynthVoicePool::UnlinkActive(int slot)
+{
+	if (_previous[slot] >= 0)
+		_next[_previous[slot]] = _next[slot];
+	else
+		_activeHead = _next[slot];
+
+	if (_next[slot] >= 0)
+		_previous[_next[slot]] = _previous[slot];
+	else
+		_activeTail = _previous[slot];
+
+	_previous[slot] = -1;
+	_next[slot] = -1;
+}
+
+void SynthVoicePool::Free(int slot)
+{
+	if (_states[slot] == VoiceState::Released)
+		_soundingCount--;
+
+	_voices[slot]->Clear();
+	_states[slot] = VoiceState::Inactive;
+	_midiNumbers[slot] = -1;
+
+	_next[slot] = _freeHead;
+	_freeHead = slot;
 }
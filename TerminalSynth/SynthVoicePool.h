@@ -6,51 +6,71 @@
 #include "Constant.h"
 #include "PlaybackInfo.h"
 #include "PlaybackTime.h"
+#include "SignalChain.h"
 #include "SoundRegistry.h"
 #include "SoundSettings.h"
 #include "SynthVoiceBase.h"
 #include <functional>
-#include <map>
-#include <stack>
-#include <vector>
 
+/// <summary>
+/// Fixed capacity voice allocator. The voices are created up front (polyphony, plus a few reserve voices for the
+/// fade out of stolen notes); and kept in arrays, with intrusive lists for the free voices, and the sounding voices
+/// (in the order they were started). Engaged notes are indexed by MIDI number; so note on / off are O(1), and
+/// nothing is allocated on the audio thread. When the polyphony is used up, a voice is stolen (see VoiceStealMode),
+/// and faded out, instead of dropping the note.
+/// </summary>
 class SynthVoicePool
 {
 public:
 
-	SynthVoicePool(SoundRegistry* soundRegistry, const SoundSettings* soundSettings, const PlaybackInfo* playbackInfo, int capacity);
+	/// <summary>
+	/// Creates the voices for the polyphony of the sound settings (see SynthNoteParameters)
+	/// </summary>
+	SynthVoicePool(SoundRegistry* soundRegistry, const SoundSettings* soundSettings, const PlaybackInfo* playbackInfo);
 	~SynthVoicePool();
 
 	/// <summary>
-	/// Updates synth voices with new settings
+	/// Returns the number of voices created for the sound settings (polyphony, plus the reserve)
+	/// </summary>
+	static int GetCapacity(const SoundSettings* soundSettings);
+
+	/// <summary>
+	/// Updates synth voices with new settings. The voice type, and polyphony, must not change (see SynthBuilder)
 	/// </summary>
 	void Update(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters);
 
 	/// <summary>
-	/// Sets midi note to either engaged; and resets the note. Returns true if there are enough voice slots
-	/// to add the next note, false otherwise.
+	/// Sets midi note to engaged; and resets the note. If the polyphony is used up, a voice is stolen to make
+	/// room for the note.
 	/// </summary>
 	/// <param name="midiNumber">MIDI number of the desired note</param>
-	/// <param name="absoluteTime">Current stream time</param>
-	/// <param name="timeCursor">PlaybackFrame time cursor (which counts frame samples)</param>
-	/// <returns>True if the note was engaged properly. Returns false only if the pool is at capacity.</returns>
+	/// <param name="playbackTime">Current playback time</param>
+	/// <returns>True if the note was engaged properly (false for an invalid MIDI number)</returns>
 	bool NoteOn(int midiNumber, const PlaybackTime* playbackTime);
 
 	/// <summary>
-	/// Sets midi note to dis-engaged. The note will continue to be part of the playback stream in the dis-engaged
-	/// pool until it is finished ringing (HasOutput -> false)
+	/// Sets midi note to dis-engaged. The note will continue to be part of the playback stream until it is
+	/// finished ringing (HasOutput -> false)
 	/// </summary>
 	void NoteOff(int midiNumber, const PlaybackTime* playbackTime);
 
 	/// <summary>
-	/// Returns true if the note is already engaged
+	/// (Synth Swap) Starts a voice for each engaged, and released, note of the previous pool (oldest first); which
+	/// takes over the envelope of the previous voice (see SynthVoiceBase::AdoptNote). Stolen voices are left to
+	/// fade out on the previous pool.
 	/// </summary>
-	bool IsEngaged(int midiNumber) const;
+	void AdoptNotes(const SynthVoicePool* previous, const PlaybackTime* playbackTime);
 
 	/// <summary>
-	/// Returns true if the pool has capacity for more engaged notes. Depends on SynthNoteMode.
+	/// (Chain Edit) Each voice takes over the insert chain of the same index (see SynthVoiceBase::AdoptChain); which
+	/// is exchanged for the replaced chain. Returns false (without changes) if the chain count is not the capacity.
 	/// </summary>
-	bool CanEngageNextNote() const;
+	bool AdoptChains(SignalChain** chains, int chainCount, const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// Returns true if the note is already engaged
+	/// </summary>
+	bool IsEngaged(int midiNumber) const;
 
 	/// <summary>
 	/// Returns true if there are any notes pressed
@@ -67,11 +87,21 @@ public:
 	using SynthVoiceNotePoolIterator = std::function<void(SynthVoiceBase* note, bool isEngaged)>;
 
 	/// <summary>
-	/// Iterates notes and provides a callback to process note synthesis. Also, prunes the note pool
-	/// to move disengaged notes to the proper collection.
+	/// Iterates notes and provides a callback to process note synthesis. Also, returns voices that have
+	/// finished ringing out to the free list.
 	/// </summary>
 	void IterateNotes(const PlaybackTime* playbackTime, const SynthVoiceNotePoolIterator& callback);
 
+private:
+
+	enum class VoiceState : int
+	{
+		Inactive = 0,
+		Engaged,
+		Released,
+		Stolen
+	};
+
 private:
 
 	/// <summary>
@@ -79,27 +109,62 @@ private:
 	/// </summary>
 	void ResetVoices(SoundRegistry* effectRegistry, const SoundSettings* soundSettings, const PlaybackInfo* parameters);
 
+	/// <summary>
+	/// Pre-allocates the insert effects (see SynthVoiceBase) of every voice in the SoundRegistry*
+	/// </summary>
+	void ReserveEffects(SoundRegistry* soundRegistry, const SoundSettings* soundSettings);
+
 	/// <summary>
 	/// Deletes all synth voice instances
 	/// </summary>
 	void DisposeVoices();
 
+	/// <summary>
+	/// Returns the voice to steal for the note (see VoiceStealMode); or -1 if nothing is sounding
+	/// </summary>
+	int SelectVictim(int midiNumber, const PlaybackTime* playbackTime) const;
+
+	/// <summary>
+	/// Fades the voice out (on the reserve); and frees its polyphony
+	/// </summary>
+	void Steal(int slot, const PlaybackTime* playbackTime);
+
+	/// <summary>
+	/// Removes a voice from the free list; or cuts the oldest stolen voice (when the reserve is used up)
+	/// </summary>
+	int TakeVoice();
+
+	void LinkActive(int slot);
+	void UnlinkActive(int slot);
+	void Free(int slot);
+
 private:
 
+	int _polyphony;
 	int _capacity;
-	SynthNoteMode _noteMode;
-	const PlaybackInfo* _playbackInfo;
+	VoiceStealMode _stealMode;
+	int _fadeFrames;
 
 	size_t _lastSynthVoiceHashCode;
 
-	// Capacity-sized map, will hold notes up to the user capacity (should be 10, for 10 active voices)
-	std::map<int, SynthVoiceBase*>* _engagedNotes;
+	// Voices (capacity)
+	SynthVoiceBase** _voices;
+	VoiceState* _states;
+	int* _midiNumbers;
+
+	// Intrusive lists:  Sounding voices (doubly linked, oldest first); and free voices (singly linked, by _next)
+	int* _next;
+	int* _previous;
+	int _activeHead;
+	int _activeTail;
+	int _freeHead;
 
-	// N-sized map, will hold notes until they've dissipated
-	std::vector<SynthVoiceBase*>* _disengagedNotes;
+	// Engaged voice (slot) for each MIDI number (or -1)
+	int _engagedSlots[MIDI_NOTE_COUNT];
 
-	// M-sized map, will hold notes after they've dissipated
-	std::stack<SynthVoiceBase*>* _inactiveNotes;
+	// Engaged, and released, voices (stolen voices no longer count toward the polyphony)
+	int _soundingCount;
+	int _engagedCount;
 };
 
-#endif
\ No newline at end of file
+#endif
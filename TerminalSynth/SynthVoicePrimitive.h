@@ -0,0 +1,118 @@
+#pragma once
+
+#ifndef SYNTH_VOICE_PRIMITIVE_H
+#define SYNTH_VOICE_PRIMITIVE_H
+
+#include "AudioBlock.h"
+#include "Constant.h"
+#include "Oscillator.h"
+#include "PlaybackFrame.h"
+#include "PlaybackInfo.h"
+#include "PlaybackTime.h"
+#include "SoundRegistry.h"
+#include "SoundSettings.h"
+#include "SynthVoiceBank.h"
+#include "SynthVoiceDirect.h"
+#include "WaveTable.h"
+#include <cstdint>
+
+/// <summary>
+/// Primitive waveform voice, using a (per-voice) phase-accumulator Oscillator*. The phase is reset on each note.
+/// </summary>
+class SynthVoicePrimitive : public SynthVoiceDirect
+{
+public:
+
+	SynthVoicePrimitive(SoundRegistry* soundRegistry, const SoundSettings* settings, const PlaybackInfo* playbackInfo, PrimitiveSynthVoices waveform)
+		: SynthVoiceDirect(soundRegistry, settings, playbackInfo)
+	{
+		_waveform = waveform;
+		_oscillator = new Oscillator();
+	}
+	~SynthVoicePrimitive()
+	{
+		delete _oscillator;
+	}
+
+	void NoteOn(int midiNumber, const PlaybackTime* playbackTime) override
+	{
+		SynthVoiceDirect::NoteOn(midiNumber, playbackTime);
+
+		_oscillator->Reset();
+	}
+
+	bool AddToBank(SynthVoiceBank* bank, const PlaybackTime* playbackTime) override
+	{
+		if (!this->CanRenderInBank())
+			return false;
+
+		PlaybackFrame frame;
+
+		uint32_t phaseIncrement = WaveTable::GetPhaseIncrement(this->GetNextFrequency(&frame, playbackTime), this->GetSamplingRate());
+		uint32_t phase = (uint32_t)(_oscillator->GetPhase() * 4294967296.0);
+
+		return bank->AddPrimitive(this, _waveform, phase, phaseIncrement, this->GetSignalHigh(), this->GetSignalLow());
+	}
+
+	void SetBankPhase(uint32_t phase) override
+	{
+		_oscillator->SetPhase(phase / 4294967296.0);
+	}
+
+	bool HasMonoOutput() const override
+	{
+		return true;
+	}
+
+protected:
+
+	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) override
+	{
+		float sample = _oscillator->Next(
+			_waveform,
+			this->GetNextFrequency(frame, playbackTime),
+			this->GetSamplingRate(),
+			this->GetSignalHigh(),
+			this->GetSignalLow());
+
+		frame->SetFrame(sample, sample);
+	}
+
+	void ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount) override
+	{
+		// Arpeggiator:  The frequency is calculated per frame
+		if (!this->HasConstantFrequency())
+		{
+			SynthVoiceDirect::ProcessBlockImpl(block, playbackTime, frameCount);
+			return;
+		}
+
+		PlaybackFrame frame;
+
+		float* left = block->GetLeft();
+		float* right = block->GetRight();
+
+		_oscillator->GenerateBlock(
+			_waveform,
+			left,
+			frameCount,
+			this->GetNextFrequency(&frame, playbackTime),
+			this->GetSamplingRate(),
+			this->GetSignalHigh(),
+			this->GetSignalLow());
+
+		// (Mono) The right channel is only kept for a stereo block
+		if (!block->IsMono())
+		{
+			for (int index = 0; index < frameCount; index++)
+				right[index] = left[index];
+		}
+	}
+
+private:
+
+	PrimitiveSynthVoices _waveform;
+	Oscillator* _oscillator;
+};
+
+#endif
@@ -3,15 +3,13 @@
 #ifndef SYNTH_VOICE_PRIMITIVE_SINE_H
 #define SYNTH_VOICE_PRIMITIVE_SINE_H
 
-#include "PlaybackFrame.h"
+#include "Constant.h"
 #include "PlaybackInfo.h"
-#include "PlaybackTime.h"
-#include "SignalFactoryCore.h"
 #include "SoundRegistry.h"
 #include "SoundSettings.h"
-#include "SynthVoiceDirect.h"
+#include "SynthVoicePrimitive.h"
 
-class SynthVoicePrimitiveSine : public SynthVoiceDirect
+class SynthVoicePrimitiveSine : public SynthVoicePrimitive
 {
 public:
 
@@ -19,23 +17,9 @@ public:
 	/// Creates a synth voice (for direct waveform output); and stores private variables for the parameters.
 	/// </summary>
 	SynthVoicePrimitiveSine(SoundRegistry* soundRegistry, const SoundSettings* settings, const PlaybackInfo* playbackInfo)
-		: SynthVoiceDirect(soundRegistry, settings, playbackInfo)
+		: SynthVoicePrimitive(soundRegistry, settings, playbackInfo, PrimitiveSynthVoices::Sine)
 	{ }
 	~SynthVoicePrimitiveSine() {};
-
-protected:
-
-	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) override
-	{
-		float sample = SignalFactoryCore::GenerateSineSample(
-			this->GetNextFrequency(frame, playbackTime),
-			this->GetSamplingRate(),
-			this->GetSignalHigh(),
-			this->GetSignalLow(),
-			playbackTime);
-
-		frame->SetFrame(sample, sample);
-	}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -3,39 +3,24 @@
 #ifndef SYNTH_VOICE_PRIMITIVE_SQUARE_H
 #define SYNTH_VOICE_PRIMITIVE_SQUARE_H
 
-#include "PlaybackFrame.h"
+#include "Constant.h"
 #include "PlaybackInfo.h"
-#include "PlaybackTime.h"
-#include "SignalFactoryCore.h"
 #include "SoundRegistry.h"
 #include "SoundSettings.h"
-#include "SynthVoiceDirect.h"
+#include "SynthVoicePrimitive.h"
 
-class SynthVoicePrimitiveSquare : public SynthVoiceDirect
+class SynthVoicePrimitiveSquare : public SynthVoicePrimitive
 {
 public:
 
 	/// <summary>
-	/// Creates a synth voice (for direct waveform output); and stores private variables for the parameters.
+	/// Creates a synth voice (for direct waveform output); and stores private variables for the parameters. The
+	/// band-limited (PolyBLEP) waveform removes most of the aliasing, for a few operations per sample.
 	/// </summary>
-	SynthVoicePrimitiveSquare(SoundRegistry* soundRegistry, const SoundSettings* settings, const PlaybackInfo* playbackInfo)
-		: SynthVoiceDirect(soundRegistry, settings, playbackInfo)
+	SynthVoicePrimitiveSquare(SoundRegistry* soundRegistry, const SoundSettings* settings, const PlaybackInfo* playbackInfo, bool bandLimited = false)
+		: SynthVoicePrimitive(soundRegistry, settings, playbackInfo, bandLimited ? PrimitiveSynthVoices::SquareBandLimited : PrimitiveSynthVoices::Square)
 	{ }
 	~SynthVoicePrimitiveSquare() {};
-
-protected:
-
-	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) override
-	{
-		float sample = SignalFactoryCore::GenerateSquareSample(
-			this->GetNextFrequency(frame, playbackTime),
-			this->GetSamplingRate(),
-			this->GetSignalHigh(),
-			this->GetSignalLow(),
-			playbackTime);
-
-		frame->SetFrame(sample, sample);
-	}
 };
 
-#endif
\ No newline at end of file
+#endif
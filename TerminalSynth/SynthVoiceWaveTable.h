@@ -3,20 +3,132 @@
 #ifndef SYNTH_VOICE_WAVE_TABLE_H
 #define SYNTH_VOICE_WAVE_TABLE_H
 
+#include "AudioBlock.h"
 #include "PlaybackFrame.h"
+#include "PlaybackInfo.h"
 #include "PlaybackTime.h"
+#include "SoundRegistry.h"
+#include "SoundSettings.h"
+#include "SynthVoiceBank.h"
 #include "SynthVoiceBase.h"
+#include "WaveTable.h"
+#include <cstdint>
 
+/// <summary>
+/// Wave table voice (harmonic shaper). The (shared, read-only) WaveTable* is taken from the SoundRegistry* when
+/// the voice is built; and played back with a per-voice phase accumulator, using the mip level for the note.
+/// </summary>
 class SynthVoiceWaveTable : public SynthVoiceBase
 {
-	virtual bool HasOutput(const PlaybackTime* playbackTime) const = 0;
-	virtual void Engage(const PlaybackTime* playbackTime) = 0;
-	virtual void DisEngage(const PlaybackTime* playbackTime) = 0;
-	virtual void Clear() = 0;
+public:
+
+	SynthVoiceWaveTable(SoundRegistry* soundRegistry, const SoundSettings* settings, const PlaybackInfo* playbackInfo)
+		: SynthVoiceBase(soundRegistry, settings, playbackInfo)
+	{
+		_soundRegistry = soundRegistry;
+		_waveTable = soundRegistry->GetWaveTable(*settings->GetOscillatorParameters());
+		_phase = 0;
+	}
+	~SynthVoiceWaveTable()
+	{
+		// Wave table is owned by the SoundRegistry* (voices are deleted off of the audio thread)
+		_soundRegistry->ReleaseWaveTable(_waveTable);
+	}
+
+	void NoteOn(int midiNumber, const PlaybackTime* playbackTime) override
+	{
+		SynthVoiceBase::NoteOn(midiNumber, playbackTime);
+
+		_phase = 0;
+	}
+
+	bool AddToBank(SynthVoiceBank* bank, const PlaybackTime* playbackTime) override
+	{
+		if (!this->CanRenderInBank())
+			return false;
+
+		PlaybackFrame frame;
+
+		uint32_t phaseIncrement = WaveTable::GetPhaseIncrement(this->GetNextFrequency(&frame, playbackTime), this->GetSamplingRate());
+
+		return bank->AddWaveTable(this, _waveTable, _phase, phaseIncrement, this->GetSignalHigh(), this->GetSignalLow());
+	}
+
+	void SetBankPhase(uint32_t phase) override
+	{
+		_phase = phase;
+	}
+
+	bool HasMonoOutput() const override
+	{
+		return true;
+	}
 
 protected:
 
-	virtual void SetFrameImpl(PlaybackFrame* frame) = 0;
+	void SetFrameImpl(PlaybackFrame* frame, const PlaybackTime* playbackTime) override
+	{
+		uint32_t phaseIncrement = WaveTable::GetPhaseIncrement(this->GetNextFrequency(frame, playbackTime), this->GetSamplingRate());
+
+		float sample = _waveTable->GetSample(WaveTable::GetLevel(phaseIncrement), _phase, WaveTableInterpolation::Cubic);
+
+		_phase += phaseIncrement;
+
+		sample = MapSample(sample);
+
+		frame->SetFrame(sample, sample);
+	}
+
+	void ProcessBlockImpl(AudioBlock* block, const PlaybackTime* playbackTime, int frameCount) override
+	{
+		// Arpeggiator:  The frequency is calculated per frame
+		if (!this->HasConstantFrequency())
+		{
+			SynthVoiceBase::ProcessBlockImpl(block, playbackTime, frameCount);
+			return;
+		}
+
+		PlaybackFrame frame;
+
+		float* left = block->GetLeft();
+		float* right = block->GetRight();
+
+		uint32_t phaseIncrement = WaveTable::GetPhaseIncrement(this->GetNextFrequency(&frame, playbackTime), this->GetSamplingRate());
+
+		_waveTable->GenerateBlock(WaveTable::GetLevel(phaseIncrement), _phase, phaseIncrement, WaveTableInterpolation::Cubic, left, frameCount);
+
+		float scale = 0.5f * (this->GetSignalHigh() - this->GetSignalLow());
+		float offset = 0.5f * (this->GetSignalHigh() + this->GetSignalLow());
+
+		// Signal Range
+		for (int index = 0; index < frameCount; index++)
+			left[index] = (scale * left[index]) + offset;
+
+		// (Mono) The right channel is only kept for a stereo block
+		if (!block->IsMono())
+		{
+			for (int index = 0; index < frameCount; index++)
+				right[index] = left[index];
+		}
+	}
+
+private:
+
+	/// <summary>
+	/// Maps the table sample [-1, 1] to the oscillator's signal range
+	/// </summary>
+	float MapSample(float sample) const
+	{
+		return (0.5f * (this->GetSignalHigh() - this->GetSignalLow()) * sample) + (0.5f * (this->GetSignalHigh() + this->GetSignalLow()));
+	}
+
+private:
+
+	SoundRegistry* _soundRegistry;
+	const WaveTable* _waveTable;
+
+	// Fixed point phase (see WaveTable)
+	uint32_t _phase;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,96 +1,84 @@
-//#pragma once
-//
-//#ifndef WAVETABLE_H
-//#define WAVETABLE_H
-//
-//#include "Matrix.h"
-//#include "PlaybackFrame.h"
-//#include "Vector.h"
-//#include "WaveBase.h"
-//#include <functional>
-//
-//class WaveTable : public WaveBase
-//{
-//public:
-//
-//	enum class Mode
-//	{
-//		/// <summary>
-//		/// The wave table will hold a single period of the oscillator; and repeat it.
-//		/// </summary>
-//		Periodic,
-//
-//		/// <summary>
-//		/// The wave table will hold a sound sample that is not likely a single period of the
-//		/// periodic wave form. It should be treated as such; and triggered a single time.
-//		/// </summary>
-//		SoundSample
-//	};
-//
-//	/// <summary>
-//	/// Delegate to create L/R channel samples for the wave table. The sampleTime [0, period] will go until the period
-//	/// has been reached. The WaveTable's responsibility is to provide time points for its oversampled range. Each sample
-//	/// will be set into the local frame buffer.
-//	/// </summary>
-//	using WaveTableSampleGenerateSecondCallback = std::function<void(float sampleTime, float& leftSample, float& rightSample)>;
-//
-//	/// <summary>
-//	/// Delegate to create L/R channel samples for the wave table. The frameIndex [0, period] will go until the period
-//	/// has been reached. The WaveTable's responsability is to provide time points for its oversampled range. Each sample
-//	/// will be set into the local frame buffer.
-//	/// </summary>
-//	using WaveTableSampleGenerateFrameCallback = std::function<void(int frameIndex, float& leftSample, float& rightSample)>;
-//
-//	WaveTable(Mode mode, unsigned int frameLength, unsigned int samplingRate, unsigned int systemSamplingRate);
-//	~WaveTable();
-//
-//	/// <summary>
-//	/// Sets samples into the wave table (using stream time)
-//	/// </summary>
-//	void CreateSamplesByTime(WaveTableSampleGenerateSecondCallback callback);
-//
-//	/// <summary>
-//	/// Sets samples into the wave table (per frame)
-//	/// </summary>
-//	void CreateSamplesByFrame(WaveTableSampleGenerateFrameCallback callback);
-//
-//	bool HasOutput(double zeroTime, double absoluteTime) const override;
-//	void Clear(double zeroTime, double absoluteTime) override;
-//
-//	/// <summary>
-//	/// Gets (oversampled) frame length of the wave table
-//	/// </summary>
-//	int GetFrameLength() const;
-//
-//	/// <summary>
-//	/// Gets (oversampled) sampling rate of the wave table
-//	/// </summary>
-//	float GetSamplingRate() const;
-//
-//protected:
-//
-//	void SetFrameImpl(PlaybackFrame* frame, double zeroTime, double absoluteTime) override;
-//
-//private:
-//
-//	float GetLinearSpline(size_t timeCursor, double zeroTime, double absoluteTime, bool channelLeft);
-//	//float GetLinearSplineBuffered(double absoluteTime, bool channelLeft);
-//	//float SetFrameCubicSpline(PlaybackFrame* frame, double absoluteTime, bool channelLeft);
-//
-//private:
-//
-//	Mode _mode;
-//
-//	unsigned int _samplingRate;					// These two sampling rates may differ depending on how the table was built.
-//	unsigned int _systemSamplingRate;			// The ratio of the two will show the scale factor for providing accurate samples.
-//	PlaybackFrame* _frames;
-//	unsigned int _frameLength;
-//
-//	// A-Matrix from our cubic spline interpolation
-//	Matrix<double>* _splineA;
-//	Matrix<double>* _splineAInverse;
-//	Vector<double>* _splineB;
-//	Vector<double>* _splineK;
-//};
-//
-//#endif
\ No newline at end of file
+#pragma once
+
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include "WaveTableCacheKey.h"
+#include <cstdint>
+
+enum class WaveTableInterpolation : int
+{
+	Linear = 0,
+	Cubic = 1
+};
+
+/// <summary>
+/// Single cycle, mip-mapped wave table. Each mip level is band-limited for one octave of playback frequency, so
+/// the (read-only) table can be shared by every voice, at any pitch, without aliasing. All levels are stored
+/// contiguously, with guard samples around each level for the interpolation.
+///
+/// The phase is a 32-bit fixed point fraction of the cycle:  it wraps on overflow, so the block loop needs no
+/// floor, or branches; and can be vectorized by the compiler.
+/// </summary>
+class WaveTable
+{
+public:
+
+	// Samples per cycle (per level)
+	static const int TABLE_LENGTH_BITS = 11;
+	static const int TABLE_LENGTH = 1 << TABLE_LENGTH_BITS;
+
+	// Level k holds harmonics up to TABLE_LENGTH / 2^(k + 1); so the last level is a sine wave
+	static const int LEVEL_COUNT = TABLE_LENGTH_BITS;
+
+	// One sample before, and two after, each level (for the cubic interpolation)
+	static const int GUARD_BEFORE = 1;
+	static const int GUARD_AFTER = 2;
+	static const int LEVEL_STRIDE = GUARD_BEFORE + TABLE_LENGTH + GUARD_AFTER;
+
+public:
+
+	/// <summary>
+	/// Generates the mip levels (additive synthesis) for the cache key. This is done once per key, off of the
+	/// audio thread (see WaveTableCache)
+	/// </summary>
+	WaveTable(const WaveTableCacheKey& cacheKey);
+	~WaveTable();
+
+	WaveTable(const WaveTable& copy) = delete;
+	WaveTable& operator=(const WaveTable& copy) = delete;
+
+	/// <summary>
+	/// Returns the fixed point phase increment for the frequency
+	/// </summary>
+	static uint32_t GetPhaseIncrement(float frequency, float samplingRate);
+
+	/// <summary>
+	/// Returns the mip level that is band-limited for the phase increment
+	/// </summary>
+	static int GetLevel(uint32_t phaseIncrement);
+
+	/// <summary>
+	/// Returns the interpolated sample, in [-1, 1], at the phase
+	/// </summary>
+	float GetSample(int level, uint32_t phase, WaveTableInterpolation interpolation) const;
+
+	/// <summary>
+	/// Writes frameCount samples, in [-1, 1], starting at the phase (the phase is advanced)
+	/// </summary>
+	void GenerateBlock(int level, uint32_t& phase, uint32_t phaseIncrement, WaveTableInterpolation interpolation, float* destination, int frameCount) const;
+
+	/// <summary>
+	/// Returns the first sample of the mip level (the guard samples are at [-1], [TABLE_LENGTH], and [TABLE_LENGTH + 1])
+	/// </summary>
+	const float* GetLevelData(int level) const { return _levels + (level * LEVEL_STRIDE) + GUARD_BEFORE; }
+
+private:
+
+	static const int FRACTION_BITS = 32 - TABLE_LENGTH_BITS;
+
+	// LEVEL_COUNT * LEVEL_STRIDE samples
+	float* _levels;
+};
+
+#endif
@@ -1,119 +1,73 @@
-//#pragma once
-//
-//#ifndef WAVE_TABLE_CACHE_KEY_H
-//#define WAVE_TABLE_CACHE_KEY_H
-//
-//#include "OscillatorParameters.h"
-//#include "Utility.h"
-//#include <string>
-//#include <type_traits>
-//
-//class WaveTableCacheKey
-//{
-//public:
-//	WaveTableCacheKey() {};
-//
-//	virtual size_t GetHashCode() = 0;
-//};
-//
-//class WTCacheKey_Oscillator : public WaveTableCacheKey
-//{
-//public:
-//
-//	WTCacheKey_Oscillator(const OscillatorParameters& parameters, unsigned int midiNote, unsigned int samplingRate)
-//	{
-//		_parameters = new OscillatorParameters(parameters);
-//		_sampleRate = samplingRate;
-//		_midiNote = midiNote;
-//		_numberFrames = (1.0f / parameters.GetFrequency()) * samplingRate;					// Could be over / under sampled (by design)
-//	}
-//	~WTCacheKey_Oscillator()
-//	{
-//		delete _parameters;
-//	}
-//
-//	size_t GetHashCode() override
-//	{
-//		std::hash<double> hash;
-//		
-//		return hash((double)_parameters->GetFrequency() + (double)_parameters->GetBuiltInType());
-//	}
-//
-//	OscillatorParameters* GetParameters() const { return _parameters; }
-//	unsigned int GetSampleRate() const { return _sampleRate; }
-//	unsigned int GetNumberOfFrames() const { return _numberFrames; }
-//	unsigned int GetMidiNote() const { return _midiNote; }
-//
-//private:
-//	OscillatorParameters* _parameters;
-//	unsigned int _sampleRate;
-//	unsigned int _numberFrames;
-//	unsigned int _midiNote;
-//};
-//
-//class WTCacheKey_SoundBank : public WaveTableCacheKey
-//{
-//public:
-//
-//	WTCacheKey_SoundBank(float desiredFrequency, const std::string& soundBank, const std::string& name, const std::string& fileName)
-//	{
-//		_soundBank = new std::string(soundBank);
-//		_name = new std::string(name);
-//		_fileName = new std::string(fileName);
-//
-//		_desiredFrequency = desiredFrequency;
-//		_sampleRate = 0;
-//		_numberChannels = 0;
-//		_numberFrames = 0;
-//
-//	}
-//	~WTCacheKey_SoundBank()
-//	{
-//		delete _soundBank;
-//		delete _name;
-//		delete _fileName;
-//	}
-//
-//	size_t GetHashCode() override
-//	{
-//		std::hash<std::string> stringHasher;
-//		std::hash<float> floatHasher;
-//
-//		size_t hash1 = stringHasher(*_soundBank);
-//		size_t hash2 = stringHasher(*_name);
-//		size_t hash3 = floatHasher(_desiredFrequency);
-//
-//		TerminalSynth::HashCombine(hash1, hash2);
-//		TerminalSynth::HashCombine(hash1, hash3);
-//
-//		return hash1;
-//	}
-//
-//	void SetSoundFileData(unsigned int samplingRate, unsigned int numberChannels, unsigned int numberFrames)
-//	{
-//		_sampleRate = samplingRate;
-//		_numberChannels = numberChannels;
-//		_numberFrames = numberFrames;
-//	}
-//
-//	std::string GetName() const { return *_name; }
-//	std::string GetSoundBank() const { return *_soundBank; }
-//	std::string GetFileName() const { return *_fileName; }
-//
-//	float GetDesiredFrequency() const { return _desiredFrequency; }
-//	unsigned int GetSampleRate() const { return _sampleRate; }
-//	unsigned int GetNumberOfChannels() const { return _numberChannels; }
-//	unsigned int GetNumberOfFrames() const { return _numberFrames; }
-//
-//private:
-//	std::string* _soundBank;
-//	std::string* _name;
-//	std::string* _fileName;
-//
-//	float _desiredFrequency;
-//	unsigned int _sampleRate;
-//	unsigned int _numberChannels;
-//	unsigned int _numberFrames;
-//};
-//
-//#endif
\ No newline at end of file
+#pragma once
+
+#ifndef WAVE_TABLE_CACHE_KEY_H
+#define WAVE_TABLE_CACHE_KEY_H
+
+#include "OscillatorParameters.h"
+#include "Utility.h"
+#include <functional>
+#include <vector>
+
+/// <summary>
+/// Identifies a wave table by the oscillator parameters that shape its waveform. The table does not depend on
+/// the note, or the sampling rate (see WaveTable); so one table is shared by every voice that uses the key.
+/// </summary>
+class WaveTableCacheKey
+{
+public:
+
+	WaveTableCacheKey(const OscillatorParameters& parameters)
+	{
+		_harmonics = new std::vector<float>(*parameters.GetWaveshaperHarmonics());
+		_randomPhaseAmplitude = parameters.GetWaveshaperRandomPhaseAmplitude();
+	}
+	~WaveTableCacheKey()
+	{
+		delete _harmonics;
+	}
+
+	WaveTableCacheKey(const WaveTableCacheKey& copy) = delete;
+	WaveTableCacheKey& operator=(const WaveTableCacheKey& copy) = delete;
+
+	size_t GetHashCode() const
+	{
+		std::hash<float> floatHasher;
+
+		size_t hash = floatHasher(_randomPhaseAmplitude);
+
+		for (int index = 0; index < _harmonics->size(); index++)
+		{
+			size_t harmonicHash = floatHasher(_harmonics->at(index));
+
+			TerminalSynth::HashCombine(hash, harmonicHash);
+		}
+
+		return hash;
+	}
+
+	/// <summary>
+	/// Returns true if the keys describe the same waveform (the hash codes may collide)
+	/// </summary>
+	bool IsEqual(const WaveTableCacheKey* other) const
+	{
+		return _randomPhaseAmplitude == other->GetRandomPhaseAmplitude() &&
+			   *_harmonics == *other->GetHarmonics();
+	}
+
+	/// <summary>
+	/// Amplitudes of the harmonics (the first is the fundamental)
+	/// </summary>
+	const std::vector<float>* GetHarmonics() const { return _harmonics; }
+
+	/// <summary>
+	/// Amount [0, 1] of (fixed, pseudo-random) phase offset for each harmonic
+	/// </summary>
+	float GetRandomPhaseAmplitude() const { return _randomPhaseAmplitude; }
+
+private:
+
+	std::vector<float>* _harmonics;
+	float _randomPhaseAmplitude;
+};
+
+#endif
@@ -1,5 +1,9 @@
 #include "AtomicLock.h"
+#include "AudioController.h"
+#include "Constant.h"
 #include "MainController.h"
+#include "NullAudioController.h"
+#include "OfflineRenderController.h"
 #include "PlaybackUserData.h"
 #include "PortAudioController.h"
 #include "SynthSettings.h"
@@ -7,6 +11,8 @@
 #include "Windows.h"
 #include <Stk.h>
 #include <exception>
+#include <iostream>
+#include <string>
 
 int main(int argc, char* argv[], char* envp[])
 {
@@ -36,9 +42,55 @@ int main(int argc, char* argv[], char* envp[])
 	//
 	AtomicLock* playbackLock = new AtomicLock();
 
+	// Offline Render:  TerminalSynth <config> --render <input (.mid, or note script)> <output (.wav, or .flac)>
+	//
+	if (argc > 4 && std::string(argv[2]) == "--render")
+	{
+		OfflineRenderController renderController(playbackLock, OFFLINE_RENDER_SAMPLING_RATE, AUDIO_BLOCK_SIZE);
+		PlaybackUserData* renderData = new PlaybackUserData(&configLoader);
+
+		if (!renderController.Initialize(renderData))
+			return -1;
+
+		bool success = renderController.Render(argv[3], argv[4], OFFLINE_RENDER_TAIL_SECONDS);
+
+		std::cout << "Rendered " << renderController.GetRenderedSeconds() << "s to " << argv[4]
+				  << " (real-time factor " << renderController.GetRealTimeFactor() << "x)" << std::endl;
+
+		renderController.Dispose();
+
+		delete renderData;
+
+		return success ? 0 : -1;
+	}
+
+	// Audio Backend:  PortAudio (default); or the null device, for running without audio hardware
+	//
+	//				   TerminalSynth <config> --null <realtime | fast | jitter> [output (.wav, or .flac)]
+	//
+	AudioController* audioController = nullptr;
+	NullAudioController* nullController = nullptr;
+
+	if (argc > 3 && std::string(argv[2]) == "--null")
+	{
+		std::string pacingName(argv[3]);
+
+		NullAudioPacing pacing = pacingName == "fast" ? NullAudioPacing::AsFastAsPossible :
+								 pacingName == "jitter" ? NullAudioPacing::Jittered :
+								 NullAudioPacing::RealTime;
+
+		// MEMORY! (end of main)
+		nullController = new NullAudioController(playbackLock, NULL_AUDIO_SAMPLING_RATE, NULL_AUDIO_BUFFER_SIZE, pacing, NULL_AUDIO_JITTER_MILLI, argc > 4 ? argv[4] : "");
+		audioController = nullController;
+	}
+	else
+	{
+		// MEMORY! (end of main)
+		audioController = new PortAudioController(playbackLock);
+	}
+
 	// Manual keyboard input
-	PortAudioController audioController(playbackLock);
-	MainController controller(&audioController, playbackLock);
+	MainController controller(audioController, playbackLock);
 
 	// Primary Shared Pointers:  The OutputSettings* are initialized and maintained by the MainController, with 
 	//							 the RtAudioController* providing the host api, and device info.
@@ -52,8 +104,17 @@ int main(int argc, char* argv[], char* envp[])
 
 	controller.Start();
 
-	if (!controller.Dispose())
-		return -1;
+	bool success = controller.Dispose();
+
+	// Null Device:  Timing report (the callback thread is joined during Dispose)
+	if (nullController != nullptr)
+	{
+		std::cout << "Null audio device:  " << nullController->GetCallbackCount() << " callbacks, "
+				  << nullController->GetDeadlineMisses() << " deadline misses, "
+				  << nullController->GetMaxCallbackMilli() << "ms max callback" << std::endl;
+	}
+
+	delete audioController;
 
-	return 0;
+	return success ? 0 : -1;
 }